@@ -338,11 +338,11 @@ bool jack_get_thread_realtime_priority_range(int * min_ptr, int * max_ptr)
 #endif
 }
 
-bool jack_tls_allocate_key(jack_tls_key *key_ptr)
+bool jack_tls_allocate_key(jack_tls_key *key_ptr, void (*destructor)(void*))
 {
     int ret;
 
-    ret = pthread_key_create(key_ptr, NULL);
+    ret = pthread_key_create(key_ptr, destructor);
     if (ret != 0)
     {
         jack_error("pthread_key_create() failed with error %d", ret);
@@ -27,7 +27,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackTime.h"
 #include "JackPortType.h"
 #include "JackMetadata.h"
+#include "JackXRunRecorder.h"
+#include "JackTools.h"
+#include "JackDenormals.h"
 #include <math.h>
+#include <inttypes.h>
 
 using namespace Jack;
 
@@ -107,6 +111,9 @@ extern "C"
     LIB_EXPORT int jack_set_port_registration_callback(jack_client_t *,
             JackPortRegistrationCallback
             registration_callback, void *arg);
+    LIB_EXPORT int jack_set_port_registration_batch_callback(jack_client_t *,
+            JackPortRegistrationBatchCallback
+            registration_callback, void *arg);
     LIB_EXPORT int jack_set_port_connect_callback(jack_client_t *,
             JackPortConnectCallback
             connect_callback, void *arg);
@@ -183,6 +190,8 @@ extern "C"
                                          const char* port_name_pattern,
                                          const char* type_name_pattern,
                                          unsigned long flags);
+    LIB_EXPORT jack_graph_snapshot_t* jack_graph_snapshot(jack_client_t *);
+    LIB_EXPORT uint32_t jack_graph_epoch(jack_client_t *);
     LIB_EXPORT jack_port_t * jack_port_by_name(jack_client_t *, const char* port_name);
     LIB_EXPORT jack_port_t * jack_port_by_id(jack_client_t *client,
                                           jack_port_id_t port_id);
@@ -206,6 +215,10 @@ extern "C"
     LIB_EXPORT float jack_get_max_delayed_usecs(jack_client_t *client);
     LIB_EXPORT float jack_get_xrun_delayed_usecs(jack_client_t *client);
     LIB_EXPORT void jack_reset_max_delayed_usecs(jack_client_t *client);
+    LIB_EXPORT uint32_t jack_get_xrun_count(jack_client_t *client);
+    LIB_EXPORT jack_xrun_report_t* jack_get_xrun_report(jack_client_t *client, uint32_t sequence);
+    LIB_EXPORT int jack_client_get_timing_stats(jack_client_t *client, const char *client_name, jack_client_timing_stats_t *stats);
+    LIB_EXPORT int jack_get_graph_stats(jack_client_t *client, jack_graph_stats_t *stats);
 
     LIB_EXPORT int jack_release_timebase(jack_client_t *client);
     LIB_EXPORT int jack_set_sync_callback(jack_client_t *client,
@@ -244,6 +257,11 @@ extern "C"
 
     LIB_EXPORT int jack_client_stop_thread(jack_client_t* client, jack_native_thread_t thread);
     LIB_EXPORT int jack_client_kill_thread(jack_client_t* client, jack_native_thread_t thread);
+    LIB_EXPORT int jack_client_set_cpu_affinity(jack_client_t* client, const int* cpus, int count);
+    LIB_EXPORT int jack_client_set_spin_wait(jack_client_t* client, jack_time_t max_usecs);
+    LIB_EXPORT int jack_client_create_workers(jack_client_t* client, int count);
+    LIB_EXPORT int jack_client_parallel_for(jack_client_t* client, unsigned int count, JackParallelCallback callback, void* arg);
+    LIB_EXPORT int jack_client_set_flush_denormals(jack_client_t* client, int onoff);
 #ifndef WIN32
     LIB_EXPORT void jack_set_thread_creator(jack_thread_creator_t jtc);
 #endif
@@ -374,9 +392,18 @@ LIB_EXPORT void* jack_port_get_buffer(jack_port_t* port, jack_nframes_t frames)
     }
 }
 
-LIB_EXPORT jack_uuid_t jack_port_uuid(const jack_port_t*)
+LIB_EXPORT jack_uuid_t jack_port_uuid(const jack_port_t* port)
 {
-    return 0;
+    JackGlobals::CheckContext("jack_port_uuid");
+
+    uintptr_t port_aux = (uintptr_t)port;
+    jack_port_id_t myport = (jack_port_id_t)port_aux;
+    if (!CheckPort(myport)) {
+        jack_error("jack_port_uuid called with an incorrect port %ld", myport);
+        return 0;
+    } else {
+        return JackMetadata::PortUUID(myport);
+    }
 }
 
 LIB_EXPORT const char* jack_port_name(const jack_port_t* port)
@@ -561,8 +588,10 @@ LIB_EXPORT void jack_port_set_latency(jack_port_t* port, jack_nframes_t frames)
         jack_error("jack_port_set_latency called with an incorrect port %ld", myport);
     } else {
         JackGraphManager* manager = GetGraphManager();
-        if (manager)
+        if (manager) {
             manager->GetPort(myport)->SetLatency(frames);
+            manager->IncEpoch();
+        }
     }
 }
 
@@ -593,8 +622,10 @@ LIB_EXPORT void jack_port_set_latency_range(jack_port_t *port, jack_latency_call
     } else {
         WaitGraphChange();
         JackGraphManager* manager = GetGraphManager();
-        if (manager)
+        if (manager) {
             manager->GetPort(myport)->SetLatencyRange(mode, range);
+            manager->IncEpoch();
+        }
     }
 }
 
@@ -670,7 +701,12 @@ LIB_EXPORT int jack_port_set_alias(jack_port_t* port, const char* name)
         return -1;
     } else {
         JackGraphManager* manager = GetGraphManager();
-        return (manager ? manager->GetPort(myport)->SetAlias(name) : -1);
+        if (!manager) {
+            return -1;
+        }
+        int res = manager->GetPort(myport)->SetAlias(name);
+        manager->IncEpoch();
+        return res;
     }
 }
 
@@ -688,7 +724,12 @@ LIB_EXPORT int jack_port_unset_alias(jack_port_t* port, const char* name)
         return -1;
     } else {
         JackGraphManager* manager = GetGraphManager();
-        return (manager ? manager->GetPort(myport)->UnsetAlias(name) : -1);
+        if (!manager) {
+            return -1;
+        }
+        int res = manager->GetPort(myport)->UnsetAlias(name);
+        manager->IncEpoch();
+        return res;
     }
 }
 
@@ -970,6 +1011,19 @@ LIB_EXPORT int jack_set_port_registration_callback(jack_client_t* ext_client, Ja
     }
 }
 
+LIB_EXPORT int jack_set_port_registration_batch_callback(jack_client_t* ext_client, JackPortRegistrationBatchCallback registration_callback, void* arg)
+{
+    JackGlobals::CheckContext("jack_set_port_registration_batch_callback");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_set_port_registration_batch_callback called with a NULL client");
+        return -1;
+    } else {
+        return client->SetPortRegistrationBatchCallback(registration_callback, arg);
+    }
+}
+
 LIB_EXPORT int jack_set_port_connect_callback(jack_client_t* ext_client, JackPortConnectCallback portconnect_callback, void* arg)
 {
     JackGlobals::CheckContext("jack_set_port_connect_callback");
@@ -1285,6 +1339,32 @@ LIB_EXPORT const char** jack_get_ports(jack_client_t* ext_client, const char* po
     return (manager ? manager->GetPorts(port_name_pattern, type_name_pattern, flags) : NULL);
 }
 
+LIB_EXPORT jack_graph_snapshot_t* jack_graph_snapshot(jack_client_t* ext_client)
+{
+    JackGlobals::CheckContext("jack_graph_snapshot");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_graph_snapshot called with a NULL client");
+        return NULL;
+    }
+    JackGraphManager* manager = GetGraphManager();
+    return (manager ? manager->GetSnapshot() : NULL);
+}
+
+LIB_EXPORT uint32_t jack_graph_epoch(jack_client_t* ext_client)
+{
+    JackGlobals::CheckContext("jack_graph_epoch");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_graph_epoch called with a NULL client");
+        return 0;
+    }
+    JackGraphManager* manager = GetGraphManager();
+    return (manager ? manager->GetEpoch() : 0);
+}
+
 LIB_EXPORT jack_port_t* jack_port_by_name(jack_client_t* ext_client, const char* portname)
 {
     JackGlobals::CheckContext("jack_port_by_name");
@@ -1691,6 +1771,75 @@ LIB_EXPORT void jack_reset_max_delayed_usecs(jack_client_t* ext_client)
     }
 }
 
+LIB_EXPORT uint32_t jack_get_xrun_count(jack_client_t* ext_client)
+{
+    JackGlobals::CheckContext("jack_get_xrun_count");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_get_xrun_count called with a NULL client");
+        return 0;
+    } else {
+        JackXRunRecorder* recorder = GetXRunRecorder();
+        return (recorder ? recorder->GetXRunCount() : 0);
+    }
+}
+
+LIB_EXPORT jack_xrun_report_t* jack_get_xrun_report(jack_client_t* ext_client, uint32_t sequence)
+{
+    JackGlobals::CheckContext("jack_get_xrun_report");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_get_xrun_report called with a NULL client");
+        return NULL;
+    } else {
+        JackXRunRecorder* recorder = GetXRunRecorder();
+        return (recorder ? recorder->GetReport(sequence) : NULL);
+    }
+}
+
+LIB_EXPORT int jack_client_get_timing_stats(jack_client_t* ext_client, const char* client_name, jack_client_timing_stats_t* stats)
+{
+    JackGlobals::CheckContext("jack_client_get_timing_stats");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_client_get_timing_stats called with a NULL client");
+        return -1;
+    } else if (stats == NULL) {
+        jack_error("jack_client_get_timing_stats called with a NULL stats");
+        return -1;
+    } else {
+        JackGraphManager* manager = GetGraphManager();
+        const char* name = (client_name) ? client_name : client->GetClientControl()->fName;
+        return (manager ? manager->GetClientTimingStats(name, stats) : -1);
+    }
+}
+
+LIB_EXPORT int jack_get_graph_stats(jack_client_t* ext_client, jack_graph_stats_t* stats)
+{
+    JackGlobals::CheckContext("jack_get_graph_stats");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_get_graph_stats called with a NULL client");
+        return -1;
+    } else if (stats == NULL) {
+        jack_error("jack_get_graph_stats called with a NULL stats");
+        return -1;
+    } else {
+        JackEngineControl* control = GetEngineControl();
+        if (control == NULL) {
+            return -1;
+        }
+        stats->switches = UInt32(control->fGraphSwitches);
+        stats->waits = UInt32(control->fGraphWaits);
+        stats->forced_switches = UInt32(control->fGraphForcedSwitches);
+        return 0;
+    }
+}
+
 // thread.h
 LIB_EXPORT int jack_client_real_time_priority(jack_client_t* ext_client)
 {
@@ -1728,6 +1877,21 @@ LIB_EXPORT int jack_acquire_real_time_scheduling(jack_native_thread_t thread, in
         : -1);
 }
 
+// Sets the denormals mode of a realtime thread before its routine runs
+struct JackThreadTrampoline
+{
+    thread_routine fRoutine;
+    void* fArg;
+};
+
+static void* jack_thread_trampoline(void* arg)
+{
+    JackThreadTrampoline trampoline = *(JackThreadTrampoline*)arg;
+    delete (JackThreadTrampoline*)arg;
+    SetFlushDenormals(true);
+    return trampoline.fRoutine(trampoline.fArg);
+}
+
 LIB_EXPORT int jack_client_create_thread(jack_client_t* client,
                                      jack_native_thread_t *thread,
                                      int priority,
@@ -1738,7 +1902,20 @@ LIB_EXPORT int jack_client_create_thread(jack_client_t* client,
     JackGlobals::CheckContext("jack_client_create_thread");
 
     JackEngineControl* control = GetEngineControl();
+    JackThreadTrampoline* trampoline = NULL;
+    bool flush_denormals = (client) ? ((JackClient*)client)->FlushDenormals() : (control && control->fFlushDenormals);
+    if (realtime && flush_denormals) {
+        trampoline = new JackThreadTrampoline;
+        trampoline->fRoutine = routine;
+        trampoline->fArg = arg;
+        routine = jack_thread_trampoline;
+        arg = trampoline;
+    }
+
     int res = JackThread::StartImp(thread, priority, realtime, routine, arg);
+    if (res != 0) {
+        delete trampoline;
+    }
     return (res == 0)
         ? ((realtime ? JackThread::AcquireRealTimeImp(*thread, priority, control->fPeriod, control->fComputation, control->fConstraint) : res))
         : res;
@@ -1761,6 +1938,71 @@ LIB_EXPORT int jack_client_kill_thread(jack_client_t* client, jack_native_thread
     return JackThread::KillImp(thread);
 }
 
+LIB_EXPORT int jack_client_set_cpu_affinity(jack_client_t* ext_client, const int* cpus, int count)
+{
+    JackGlobals::CheckContext("jack_client_set_cpu_affinity");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_client_set_cpu_affinity called with a NULL client");
+        return -1;
+    } else {
+        return client->SetCPUAffinity(cpus, count);
+    }
+}
+
+LIB_EXPORT int jack_client_set_spin_wait(jack_client_t* ext_client, jack_time_t max_usecs)
+{
+    JackGlobals::CheckContext("jack_client_set_spin_wait");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_client_set_spin_wait called with a NULL client");
+        return -1;
+    } else {
+        return client->SetSpinWait(max_usecs);
+    }
+}
+
+LIB_EXPORT int jack_client_create_workers(jack_client_t* ext_client, int count)
+{
+    JackGlobals::CheckContext("jack_client_create_workers");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_client_create_workers called with a NULL client");
+        return -1;
+    } else {
+        return client->CreateWorkers(count);
+    }
+}
+
+LIB_EXPORT int jack_client_parallel_for(jack_client_t* ext_client, unsigned int count, JackParallelCallback callback, void* arg)
+{
+    JackGlobals::CheckContext("jack_client_parallel_for");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_client_parallel_for called with a NULL client");
+        return -1;
+    } else {
+        return client->ParallelFor(count, callback, arg);
+    }
+}
+
+LIB_EXPORT int jack_client_set_flush_denormals(jack_client_t* ext_client, int onoff)
+{
+    JackGlobals::CheckContext("jack_client_set_flush_denormals");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_client_set_flush_denormals called with a NULL client");
+        return -1;
+    } else {
+        return client->SetFlushDenormals(onoff);
+    }
+}
+
 #ifndef WIN32
 LIB_EXPORT void jack_set_thread_creator (jack_thread_creator_t jtc)
 {
@@ -2066,88 +2308,172 @@ LIB_EXPORT int jack_client_has_session_callback(jack_client_t* ext_client, const
     }
 }
 
-LIB_EXPORT int jack_set_property(jack_client_t*, jack_uuid_t, const char*, const char*, const char*)
+LIB_EXPORT int jack_set_property(jack_client_t* ext_client, jack_uuid_t subject, const char* key, const char* value, const char* type)
 {
-    return -1;
+    JackGlobals::CheckContext("jack_set_property");
+
+    JackClient* client = (JackClient*)ext_client;
+    jack_log("jack_set_property ext_client %x client %x ", ext_client, client);
+    if (client == NULL) {
+        jack_error("jack_set_property called with a NULL client");
+        return -1;
+    } else if (key == NULL || value == NULL) {
+        jack_error("jack_set_property called with a NULL key or value");
+        return -1;
+    } else {
+        return client->SetProperty(subject, key, value, type);
+    }
 }
 
-LIB_EXPORT int jack_get_property(jack_uuid_t, const char*, char**, char**)
+LIB_EXPORT int jack_get_property(jack_uuid_t subject, const char* key, char** value, char** type)
 {
-    return -1;
+    JackGlobals::CheckContext("jack_get_property");
+
+    JackMetadata* metadata = GetMetadata();
+    if (metadata == NULL || key == NULL || value == NULL) {
+        return -1;
+    } else {
+        return metadata->GetProperty(subject, key, value, type);
+    }
 }
 
-LIB_EXPORT void jack_free_description(jack_description_t*, int)
+LIB_EXPORT void jack_free_description(jack_description_t* desc, int free_description_itself)
 {
+    JackGlobals::CheckContext("jack_free_description");
+
+    JackMetadata::FreeDescription(desc, free_description_itself);
 }
 
-LIB_EXPORT int jack_get_properties(jack_uuid_t, jack_description_t*)
+LIB_EXPORT int jack_get_properties(jack_uuid_t subject, jack_description_t* desc)
 {
-    return -1;
+    JackGlobals::CheckContext("jack_get_properties");
+
+    JackMetadata* metadata = GetMetadata();
+    if (metadata == NULL || desc == NULL) {
+        return -1;
+    } else {
+        return metadata->GetProperties(subject, desc);
+    }
 }
 
-LIB_EXPORT int jack_get_all_properties(jack_description_t**)
+LIB_EXPORT int jack_get_all_properties(jack_description_t** descs)
 {
-    return -1;
+    JackGlobals::CheckContext("jack_get_all_properties");
+
+    JackMetadata* metadata = GetMetadata();
+    if (metadata == NULL || descs == NULL) {
+        return -1;
+    } else {
+        return metadata->GetAllProperties(descs);
+    }
 }
 
-LIB_EXPORT int jack_remove_property(jack_client_t*, jack_uuid_t, const char*)
+LIB_EXPORT int jack_remove_property(jack_client_t* ext_client, jack_uuid_t subject, const char* key)
 {
-    return -1;
+    JackGlobals::CheckContext("jack_remove_property");
+
+    JackClient* client = (JackClient*)ext_client;
+    jack_log("jack_remove_property ext_client %x client %x ", ext_client, client);
+    if (client == NULL) {
+        jack_error("jack_remove_property called with a NULL client");
+        return -1;
+    } else if (key == NULL) {
+        jack_error("jack_remove_property called with a NULL key");
+        return -1;
+    } else {
+        return client->RemoveProperty(subject, key);
+    }
 }
 
-LIB_EXPORT int jack_remove_properties(jack_client_t*, jack_uuid_t)
+LIB_EXPORT int jack_remove_properties(jack_client_t* ext_client, jack_uuid_t subject)
 {
-    return -1;
+    JackGlobals::CheckContext("jack_remove_properties");
+
+    JackClient* client = (JackClient*)ext_client;
+    jack_log("jack_remove_properties ext_client %x client %x ", ext_client, client);
+    if (client == NULL) {
+        jack_error("jack_remove_properties called with a NULL client");
+        return -1;
+    } else {
+        return client->RemoveProperties(subject);
+    }
 }
 
-LIB_EXPORT int jack_remove_all_properties(jack_client_t*)
+LIB_EXPORT int jack_remove_all_properties(jack_client_t* ext_client)
 {
-    return -1;
+    JackGlobals::CheckContext("jack_remove_all_properties");
+
+    JackClient* client = (JackClient*)ext_client;
+    jack_log("jack_remove_all_properties ext_client %x client %x ", ext_client, client);
+    if (client == NULL) {
+        jack_error("jack_remove_all_properties called with a NULL client");
+        return -1;
+    } else {
+        return client->RemoveAllProperties();
+    }
 }
 
-LIB_EXPORT int jack_set_property_change_callback(jack_client_t*, JackPropertyChangeCallback, void*)
+LIB_EXPORT int jack_set_property_change_callback(jack_client_t* ext_client, JackPropertyChangeCallback callback, void* arg)
 {
-    return -1;
+    JackGlobals::CheckContext("jack_set_property_change_callback");
+
+    JackClient* client = (JackClient*)ext_client;
+    jack_log("jack_set_property_change_callback ext_client %x client %x ", ext_client, client);
+    if (client == NULL) {
+        jack_error("jack_set_property_change_callback called with a NULL client");
+        return -1;
+    } else {
+        return client->SetPropertyChangeCallback(callback, arg);
+    }
 }
 
 LIB_EXPORT jack_uuid_t jack_client_uuid_generate()
 {
-    return 0;
+    // The whole process ID keeps UUIDs generated by different processes apart
+    static SInt32 client_id = 0;
+    return JackMetadata::ClientUUID((UInt32)JackTools::GetPID(), (UInt32)INC_ATOMIC(&client_id) + 1);
 }
 
-LIB_EXPORT jack_uuid_t jack_port_uuid_generate(uint32_t)
+LIB_EXPORT jack_uuid_t jack_port_uuid_generate(uint32_t port_id)
 {
-    return 0;
+    return JackMetadata::PortUUID(port_id);
 }
 
-LIB_EXPORT uint32_t jack_uuid_to_index(jack_uuid_t)
+LIB_EXPORT uint32_t jack_uuid_to_index(jack_uuid_t u)
 {
-    return 0;
+    return (u & 0xffffffff) - 1;
 }
 
-LIB_EXPORT int jack_uuid_compare(jack_uuid_t, jack_uuid_t)
+LIB_EXPORT int jack_uuid_compare(jack_uuid_t a, jack_uuid_t b)
 {
-    return 0;
+    if (a == b) {
+        return 0;
+    } else {
+        return (a < b) ? -1 : 1;
+    }
 }
 
-LIB_EXPORT void jack_uuid_copy(jack_uuid_t*, jack_uuid_t)
+LIB_EXPORT void jack_uuid_copy(jack_uuid_t* dst, jack_uuid_t src)
 {
+    *dst = src;
 }
 
-LIB_EXPORT void jack_uuid_clear(jack_uuid_t*)
+LIB_EXPORT void jack_uuid_clear(jack_uuid_t* u)
 {
+    *u = 0;
 }
 
-LIB_EXPORT int jack_uuid_parse(const char*, jack_uuid_t*)
+LIB_EXPORT int jack_uuid_parse(const char* buf, jack_uuid_t* u)
 {
-    return 0;
+    return (sscanf(buf, "%" SCNu64, u) == 1) ? 0 : -1;
 }
 
-LIB_EXPORT void jack_uuid_unparse(jack_uuid_t, char buf[JACK_UUID_STRING_SIZE])
+LIB_EXPORT void jack_uuid_unparse(jack_uuid_t u, char buf[JACK_UUID_STRING_SIZE])
 {
+    snprintf(buf, JACK_UUID_STRING_SIZE, "%" PRIu64, u);
 }
 
-LIB_EXPORT int jack_uuid_empty(jack_uuid_t)
+LIB_EXPORT int jack_uuid_empty(jack_uuid_t u)
 {
-    return 0;
+    return (u == 0);
 }
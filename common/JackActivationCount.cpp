@@ -21,21 +21,31 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackActivationCount.h"
 #include "JackConstants.h"
 #include "JackClientControl.h"
+#include "JackConnectionManager.h"
 #include "JackError.h"
+#include "JackProbes.h"
 
 namespace Jack
 {
 
-bool JackActivationCount::Signal(JackSynchro* synchro, JackClientControl* control)
+static inline bool Activate(JackSynchro* synchro, JackClientTiming* timing)
+{
+    // Published before the synchro is signaled, for clients spinning on it (see JackClient::SpinWait)
+    timing->fActivation++;
+    return synchro->Signal();
+}
+
+bool JackActivationCount::Signal(JackSynchro* synchro, JackClientControl* control, JackClientTiming* timing)
 {
     if (fValue == 0) {
         // Transfer activation to next clients
         jack_log("JackActivationCount::Signal value = 0 ref = %ld", control->fRefNum);
-        return synchro->Signal();
-    } else if (DEC_ATOMIC(&fValue) == 1) {
-        return synchro->Signal();
+        JACK_PROBE2(activation_signal, control->fRefNum, 0);
+        return Activate(synchro, timing);
     } else {
-        return true;
+        SInt32 remaining = DEC_ATOMIC(&fValue) - 1;
+        JACK_PROBE2(activation_signal, control->fRefNum, remaining);
+        return (remaining == 0) ? Activate(synchro, timing) : true;
     }
 }
 
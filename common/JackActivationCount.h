@@ -23,11 +23,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackPlatformPlug.h"
 #include "JackTime.h"
 #include "JackTypes.h"
+#include "JackCompilerDeps.h"
 
 namespace Jack
 {
 
 struct JackClientControl;
+struct JackClientTiming;
 
 /*!
 \brief Client activation counter.
@@ -39,7 +41,7 @@ class JackActivationCount
 
     private:
 
-        SInt32 fValue;
+        MEM_ALIGN(SInt32 fValue, CACHE_LINE_SIZE);     // Each counter on its own cache line, signaled by different threads
         SInt32 fCount;
 
     public:
@@ -47,7 +49,7 @@ class JackActivationCount
         JackActivationCount(): fValue(0), fCount(0)
         {}
 
-        bool Signal(JackSynchro* synchro, JackClientControl* control);
+        bool Signal(JackSynchro* synchro, JackClientControl* control, JackClientTiming* timing);
 
         inline void Reset()
         {
@@ -74,6 +76,11 @@ class JackActivationCount
             return fValue;
         }
 
+        inline int GetCount() const
+        {
+            return fCount;
+        }
+
 }  POST_PACKED_STRUCTURE;
 
 } // end of namespace
@@ -92,7 +92,7 @@ class JackAtomicState
 
     protected:
 
-        T fState[2];
+        MEM_ALIGN(T fState[2], __alignof__(T));     // Keeps the alignment T asks for, the state is packed otherwise
         volatile AtomicCounter fCounter;
         SInt32 fCallWriteCounter;
 
@@ -186,6 +186,9 @@ class JackClientChannelInterface
         virtual void ClientHasSessionCallback(const char* client_name, int* result)
         {}
 
+        virtual void MetadataChange(int refnum, int action, jack_uuid_t subject, const char* key, const char* value, const char* type, int* result)
+        {}
+
         virtual bool IsChannelThread()
         {
             return false;
@@ -27,8 +27,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackTransportEngine.h"
 #include "driver_interface.h"
 #include "JackLibGlobals.h"
+#include "JackProbes.h"
+#include "JackDenormals.h"
+#include "JackMetadata.h"
 
 #include <math.h>
+#include <inttypes.h>
 #include <string>
 #include <algorithm>
 
@@ -55,6 +59,7 @@ JackClient::JackClient(JackSynchro* table):fThread(this)
     fClientRegistration = NULL;
     fFreewheel = NULL;
     fPortRegistration = NULL;
+    fPortRegistrationBatch = NULL;
     fPortConnect = NULL;
     fPortRename = NULL;
     fTimebase = NULL;
@@ -62,6 +67,7 @@ JackClient::JackClient(JackSynchro* table):fThread(this)
     fThreadFun = NULL;
     fSession = NULL;
     fLatency = NULL;
+    fPropertyChange = NULL;
 
     fProcessArg = NULL;
     fGraphOrderArg = NULL;
@@ -73,6 +79,7 @@ JackClient::JackClient(JackSynchro* table):fThread(this)
     fFreewheelArg = NULL;
     fClientRegistrationArg = NULL;
     fPortRegistrationArg = NULL;
+    fPortRegistrationBatchArg = NULL;
     fPortConnectArg = NULL;
     fPortRenameArg = NULL;
     fSyncArg = NULL;
@@ -80,8 +87,23 @@ JackClient::JackClient(JackSynchro* table):fThread(this)
     fThreadFunArg = NULL;
     fSessionArg = NULL;
     fLatencyArg = NULL;
+    fPropertyChangeArg = NULL;
 
     fSessionReply = kPendingSessionReply;
+    fCPU = -1;
+    fUserCPUCount = 0;
+    fDeadline = false;
+    fDeadlinePeriod = 0;
+    fDeadlineRuntime = 0;
+    fDeadlineCycles = 0;
+    fSpinMax = 0;
+    fSpinBound = 0;
+    fSpinBudget = 0;
+    fActivation = 0;
+    fFlushDenormals = -1;
+    fDenormalsFlushed = false;
+    fChainable = false;
+    fChainEnd = false;
 }
 
 JackClient::~JackClient()
@@ -108,6 +130,8 @@ int JackClient::Close()
     int result = 0;
 
     Deactivate();
+    // Workers are only used by the RT thread, now stopped
+    fWorkers.Close();
     
     // Channels is stopped first to avoid receiving notifications while closing
     fChannel->Stop();  
@@ -120,6 +144,9 @@ int JackClient::Close()
     fSynchroTable[GetClientControl()->fRefNum].Disconnect();
     JackGlobals::fSynchroMutex->Unlock();
     JackGlobals::fClientTable[GetClientControl()->fRefNum] = NULL;
+    if (fChainable) {
+        WaitUnchained();
+    }
     return result;
 }
 
@@ -183,6 +210,11 @@ int JackClient::ClientNotify(int refnum, const char* name, int notify, int sync,
             jack_log("JackClient::kActivateClient name = %s ref = %ld ", name, refnum);
             InitAux();
             break;
+
+        case kNotificationRing:
+            // Always drained so that the ring does not fill up, events are ignored when not active
+            HandleNotificationRing(UInt32(value1));
+            break;
     }
 
     /*
@@ -235,6 +267,7 @@ int JackClient::ClientNotify(int refnum, const char* name, int notify, int sync,
                 if (fThread.GetStatus() == JackThread::kRunning) {
                     fThread.DropRealTime();     
                 }
+                fWorkers.DropRealTime();
                 if (fFreewheel) {
                     fFreewheel(1, fFreewheelArg);
                 }
@@ -251,22 +284,27 @@ int JackClient::ClientNotify(int refnum, const char* name, int notify, int sync,
                     if (fThread.AcquireRealTime(GetEngineControl()->fClientPriority) < 0) {
                         jack_error("JackClient::AcquireRealTime error");
                     }
+                    // Deadline scheduling is set again by the RT thread itself at its next cycle
+                    fDeadlinePeriod = 0;
+                }
+                if (GetEngineControl()->fRealTime) {
+                    fWorkers.AcquireRealTime(GetEngineControl()->fClientPriority);
                 }
                 break;
 
-            case kPortRegistrationOnCallback:
+            case kPortRegistrationOnCallback: {
                 jack_log("JackClient::kPortRegistrationOn port_index = %ld", value1);
-                if (fPortRegistration) {
-                    fPortRegistration(value1, 1, fPortRegistrationArg);
-                }
+                jack_port_id_t port_index = value1;
+                CallPortRegistrationCallback(&port_index, 1, 1);
                 break;
+            }
 
-            case kPortRegistrationOffCallback:
+            case kPortRegistrationOffCallback: {
                 jack_log("JackClient::kPortRegistrationOff port_index = %ld ", value1);
-                if (fPortRegistration) {
-                    fPortRegistration(value1, 0, fPortRegistrationArg);
-                }
+                jack_port_id_t port_index = value1;
+                CallPortRegistrationCallback(&port_index, 1, 0);
                 break;
+            }
 
             case kPortConnectCallback:
                 jack_log("JackClient::kPortConnectCallback src = %ld dst = %ld", value1, value2);
@@ -322,12 +360,89 @@ int JackClient::ClientNotify(int refnum, const char* name, int notify, int sync,
             case kLatencyCallback:
                 res = HandleLatencyCallback(value1);
                 break;
+
+            case kPropertyChangeCallback: {
+                jack_uuid_t subject = 0;
+                jack_log("JackClient::kPropertyChangeCallback subject = %s key = %s", name, message);
+                if (fPropertyChange && sscanf(name, "%" SCNu64, &subject) == 1) {
+                    fPropertyChange(subject, (message[0] == 0) ? NULL : message, (jack_property_change_t)value1, fPropertyChangeArg);
+                }
+                break;
+            }
         }
     }
 
     return res;
 }
 
+void JackClient::CallPortRegistrationCallback(const jack_port_id_t* ports, unsigned int count, int onoff)
+{
+    if (fPortRegistrationBatch) {
+        fPortRegistrationBatch(ports, count, onoff, fPortRegistrationBatchArg);
+    } else if (fPortRegistration) {
+        for (unsigned int i = 0; i < count; i++) {
+            fPortRegistration(ports[i], onoff, fPortRegistrationArg);
+        }
+    }
+}
+
+/*!
+\brief Drain the notifications queued by the server in the shared memory ring, up to the index given by the doorbell.
+
+Consecutive port registration events of the same kind are coalesced in a single batch,
+and the graph order callback is called only once at the end of the batch.
+*/
+
+void JackClient::HandleNotificationRing(UInt32 limit)
+{
+    JackNotificationRing* ring = &GetClientControl()->fNotificationRing;
+    JackNotificationEvent event;
+    JackNotificationPayload payload;
+    jack_port_id_t ports[NOTIFICATION_RING_SIZE];
+    bool graph_order = false;
+
+    while (ring->Pop(limit, &event, &payload)) {
+
+        if (!IsActive()) {
+            continue;
+        }
+
+        switch (event.fNotify) {
+
+            case kGraphOrderCallback:
+                graph_order = true;
+                break;
+
+            case kPortRegistrationOnCallback:
+            case kPortRegistrationOffCallback: {
+                unsigned int count = 0;
+                ports[count++] = event.fValue1;
+                JackNotificationEvent next;
+                while (count < NOTIFICATION_RING_SIZE && ring->Peek(limit, &next) && next.fNotify == event.fNotify) {
+                    ring->Pop(limit, &next);
+                    ports[count++] = next.fValue1;
+                }
+                jack_log("JackClient::HandleNotificationRing port registration onoff = %ld count = %ld", event.fNotify == kPortRegistrationOnCallback, count);
+                CallPortRegistrationCallback(ports, count, event.fNotify == kPortRegistrationOnCallback);
+                break;
+            }
+
+            default:
+                if (event.fPayload >= 0) {
+                    ClientNotify(GetClientControl()->fRefNum, payload.fName, event.fNotify, false, payload.fMessage, event.fValue1, event.fValue2);
+                } else {
+                    ClientNotify(GetClientControl()->fRefNum, GetClientControl()->fName, event.fNotify, false, "", event.fValue1, event.fValue2);
+                }
+                break;
+        }
+    }
+
+    if (graph_order && fGraphOrder) {
+        jack_log("JackClient::HandleNotificationRing kGraphOrderCallback");
+        fGraphOrder(fGraphOrderArg);
+    }
+}
+
 int JackClient::HandleLatencyCallback(int status)
 {
     jack_latency_callback_mode_t mode = (status == 0) ? JackCaptureLatency : JackPlaybackLatency;
@@ -478,6 +593,9 @@ int JackClient::Deactivate()
     int result = -1;
     fChannel->ClientDeactivate(GetClientControl()->fRefNum, &result);
     jack_log("JackClient::Deactivate res = %ld", result);
+    if (fChainable) {
+        WaitUnchained();
+    }
 
     // RT thread is stopped only when needed...
     if (IsRealTime()) {
@@ -529,6 +647,18 @@ bool JackClient::Init()
         SetupRealTime();
     }
 
+    fActivation = GetGraphManager()->GetClientTiming(GetClientControl()->fRefNum)->fActivation;
+
+    // Setup CPU affinity
+    if (fUserCPUCount > 0) {
+        if (fThread.SetSelfAffinity(fUserCPUs, fUserCPUCount) < 0) {
+            jack_error("JackClient::SetSelfAffinity error");
+        }
+    } else {
+        SetupAffinity();
+    }
+
+    SetupDenormals();
     return true;
 }
 
@@ -542,11 +672,356 @@ void JackClient::SetupRealTime()
     // Will do "something" on OSX only...
     fThread.SetParams(GetEngineControl()->fPeriod, GetEngineControl()->fComputation, GetEngineControl()->fConstraint);
 
-    if (fThread.AcquireSelfRealTime(GetEngineControl()->fClientPriority) < 0) {
+    fDeadline = GetEngineControl()->fDeadline;
+    fDeadlinePeriod = 0;
+    if (fDeadline) {
+        SetupDeadline();
+    }
+
+    if (!fDeadline && fThread.AcquireSelfRealTime(GetEngineControl()->fClientPriority) < 0) {
         jack_error("JackClient::AcquireSelfRealTime error");
     }
 }
 
+/*!
+\brief Sets SCHED_DEADLINE with a runtime sized from the measured process duration, called in the RT thread.
+
+Parameters are set again when the buffer size changes, and when the measured duration needs more runtime or half of it
+only, which is checked every DEADLINE_UPDATE_CYCLES. When the kernel refuses, the thread goes back to SCHED_FIFO for good.
+*/
+void JackClient::SetupDeadline()
+{
+    JackEngineControl* control = GetEngineControl();
+    fDeadlineCycles = 0;
+    if (!control->fRealTime) {
+        return;     // Freewheel mode
+    }
+
+    jack_timing_distribution_t process;
+    GetGraphManager()->GetClientTimingStats(GetClientControl()->fRefNum)->fProcess.GetDistribution(&process);
+    UInt64 runtime = control->DeadlineRuntime((process.count > 0) ? process.p999 + 1 : 0);
+    if (control->fPeriodUsecs == fDeadlinePeriod && runtime <= fDeadlineRuntime && runtime > fDeadlineRuntime / 2) {
+        return;
+    }
+
+    if (fThread.AcquireSelfDeadline(runtime, UInt64(control->fPeriodUsecs) * 1000) == 0) {
+        jack_log("JackClient::SetupDeadline runtime = %lld period = %lld", (long long)runtime, (long long)control->fPeriodUsecs * 1000);
+        fDeadlinePeriod = control->fPeriodUsecs;
+        fDeadlineRuntime = runtime;
+    } else {
+        jack_info("Deadline scheduling refused, client thread falls back to SCHED_FIFO");
+        fDeadline = false;
+        if (fThread.AcquireSelfRealTime(control->fClientPriority) < 0) {
+            jack_error("JackClient::AcquireSelfRealTime error");
+        }
+    }
+}
+
+static inline void SpinPause()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#elif defined(WIN32)
+    YieldProcessor();
+#endif
+}
+
+/*!
+\brief Spins on the activation word of the client for the current budget, called in the RT thread before waiting on the synchro.
+
+Returns the date the wait began, or 0 when it is not measured. A hit means the synchro is already signaled (or about to be),
+waiting on it then does not block.
+*/
+jack_time_t JackClient::SpinWait()
+{
+    // The virtual clock does not move while spinning
+    if (IsVirtualClock()) {
+        return 0;
+    }
+
+    int refnum = GetClientControl()->fRefNum;
+    JackClientTiming* timing = GetGraphManager()->GetClientTiming(refnum);
+    JackClientTimingStats* stats = GetGraphManager()->GetClientTimingStats(refnum);
+    jack_time_t start = GetMicroSeconds();
+    if (fSpinBudget == 0) {
+        return start;
+    }
+
+    jack_time_t end = start + fSpinBudget;
+    while (timing->fActivation == fActivation) {
+        if (GetMicroSeconds() >= end) {
+            stats->fSpinMisses++;
+            return start;
+        }
+        SpinPause();
+    }
+    stats->fSpinHits++;
+    return start;
+}
+
+/*!
+\brief Moves the spin budget towards the measured wait plus a margin, called in the RT thread once woken up.
+
+When waits are longer than the bound spinning does not pay and the budget decays to 0. Waits are
+still measured so that it grows again when they get shorter.
+*/
+void JackClient::SpinAdapt(jack_time_t start)
+{
+    JackClientTiming* timing = GetGraphManager()->GetClientTiming(GetClientControl()->fRefNum);
+    fActivation = timing->fActivation;
+
+    jack_time_t awake_at = timing->fAwakeAt;
+    jack_time_t waited = (awake_at > start) ? awake_at - start : 0;
+    jack_time_t max = fSpinBound;
+    jack_time_t target = (waited <= max) ? std::min(waited * SPIN_WAIT_MARGIN / 100 + 1, max) : 0;
+
+    if (target > fSpinBudget) {
+        fSpinBudget += (target - fSpinBudget + SPIN_WAIT_GAIN - 1) / SPIN_WAIT_GAIN;
+    } else {
+        fSpinBudget -= (fSpinBudget - target + SPIN_WAIT_GAIN - 1) / SPIN_WAIT_GAIN;
+    }
+}
+
+static void FullBarrier()
+{
+#if defined(__GNUC__)
+    __sync_synchronize();
+#else
+    MemoryBarrier();
+#endif
+}
+
+/*!
+\brief Signals the output clients, then executes the following clients of a linear chain on this thread, called in the RT thread.
+
+A chained client is not signaled: its own thread stays suspended while the previous client of the chain calls its callbacks,
+which saves the context switches. Its timing is kept as if it had been woken up, without wakeup latency. A thread with
+SCHED_DEADLINE does not execute chains, its runtime is sized for its own process callback.
+*/
+void JackClient::ResumeChain()
+{
+    JackClient* client = this;
+    int status = 0;
+    int count = 0;
+
+    while (client) {
+        JackClient* next = (++count < CLIENT_NUM) ? client->AcquireChained() : NULL;
+        int res = GetGraphManager()->ResumeRefNum(client->GetClientControl(), fSynchroTable, (next) ? next->GetClientControl()->fRefNum : EMPTY);
+        if (res < 0) {
+            jack_error("ResumeRefNum error");
+        }
+
+        if (client != this) {
+            if (status != 0) {
+                // Ended by its own thread
+                client->fChainEnd = true;
+                fSynchroTable[client->GetClientControl()->fRefNum].Signal();
+            }
+            JackGlobals::fChainRunning[client->GetClientControl()->fRefNum] = false;
+        }
+
+        // Not chained anymore in the current graph state, or back to the first client of a loop
+        if (next && (res != 1 || next == this)) {
+            JackGlobals::fChainRunning[next->GetClientControl()->fRefNum] = false;
+            next = NULL;
+        }
+
+        if (next) {
+            status = next->CycleChained();
+        }
+        client = next;
+    }
+
+    if (count > 1) {
+        jack_tls_set(JackGlobals::fRealTimeThread, this);
+    }
+}
+
+/*!
+\brief Returns the client to be executed after this one in a chain, marked as running, or NULL.
+*/
+JackClient* JackClient::AcquireChained()
+{
+    int refnum = GetGraphManager()->GetChainedRefNum(GetClientControl()->fRefNum);
+    if (refnum == EMPTY) {
+        return NULL;
+    }
+
+    // Marked before the client is checked, see WaitUnchained
+    JackGlobals::fChainRunning[refnum] = true;
+    FullBarrier();
+    JackClient* next = JackGlobals::fClientTable[refnum];
+    if (next && next->fChainable && next->fProcess && !next->fThreadFun && next->IsActive()) {
+        return next;
+    } else {
+        JackGlobals::fChainRunning[refnum] = false;
+        return NULL;
+    }
+}
+
+/*!
+\brief Executes a chained client on the thread of the previous client, as its own thread does once woken up.
+*/
+int JackClient::CycleChained()
+{
+    GetGraphManager()->AwakeRefNum(GetClientControl());
+    jack_tls_set(JackGlobals::fRealTimeThread, this);
+    CallSyncCallbackAux();
+    int status = CallProcessCallback();
+    if (status == 0) {
+        CallTimebaseCallbackAux();
+    }
+    return status;
+}
+
+/*!
+\brief Waits until the previous client of a chain does not execute this one, once deactivated or removed from the client table.
+*/
+void JackClient::WaitUnchained()
+{
+    FullBarrier();
+    while (JackGlobals::fChainRunning[GetClientControl()->fRefNum]) {
+        JackSleep(100);
+    }
+}
+
+/*!
+\brief Moves the RT thread to the CPU given by the server, called in the RT thread when it changes (that is on graph changes only).
+*/
+void JackClient::SetupAffinity()
+{
+    int cpu = GetClientControl()->fCPU;
+    if (fUserCPUCount == 0) {
+        if (cpu >= 0) {
+            if (fThread.SetSelfAffinity(&cpu, 1) < 0) {
+                jack_error("JackClient::SetSelfAffinity error");
+            }
+        } else if (fCPU != -1) {
+            // The thread was pinned by the server or by the application: give it the CPUs of the process again
+            if (fThread.SetSelfAffinity(NULL, 0) < 0) {
+                jack_error("JackClient::SetSelfAffinity error");
+            }
+        }
+    }
+    fCPU = cpu;
+}
+
+/*!
+\brief Pins the RT thread to the given CPUs. When count is 0, the RT thread goes back to the CPU given by the server,
+or to the CPUs of the process when the server does not pin it.
+*/
+int JackClient::SetCPUAffinity(const int* cpus, int count)
+{
+    if (count < 0 || count > RT_CPU_NUM || (count > 0 && cpus == NULL)) {
+        jack_error("JackClient::SetCPUAffinity bad CPU count = %d", count);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        fUserCPUs[i] = cpus[i];
+    }
+    fUserCPUCount = count;
+
+    if (fThread.GetStatus() == JackThread::kIdle) {
+        // Applied when the thread starts
+        return 0;
+    } else if (count > 0) {
+        return fThread.SetAffinity(fUserCPUs, count);
+    } else {
+        // The RT thread takes the server CPU, or the process CPUs, again at its next cycle
+        fCPU = -2;
+        return 0;
+    }
+}
+
+int JackClient::SetSpinWait(jack_time_t max_usecs)
+{
+    // The RT thread tunes the budget again from 0 on its next cycle, spinning starts once the waits have been measured
+    fSpinMax = max_usecs;
+    return 0;
+}
+
+int JackClient::CreateWorkers(int count)
+{
+    if (count < 0 || count > CLIENT_WORKER_NUM) {
+        jack_error("JackClient::CreateWorkers bad worker count = %d", count);
+        return -1;
+    }
+    // The process callback may be using the workers
+    if (IsActive()) {
+        jack_error("JackClient::CreateWorkers cannot be called on an active client");
+        return -1;
+    }
+
+    // Workers follow the RT thread: same priority, same CPUs
+    JackEngineControl* control = GetEngineControl();
+    int cpus[RT_CPU_NUM];
+    int cpu_count = fUserCPUCount;
+    if (cpu_count > 0) {
+        memcpy(cpus, fUserCPUs, cpu_count * sizeof(int));
+    } else {
+        // The engine control is packed, its core set is copied
+        cpu_count = control->fRTCPUCount;
+        memcpy(cpus, control->fRTCPUs, cpu_count * sizeof(int));
+    }
+
+    fWorkers.Close();
+    if (count == 0) {
+        return 0;
+    }
+    return fWorkers.Open(GetClientControl()->fName, fServerName, count, control->fClientPriority, control->fRealTime, cpus, cpu_count, FlushDenormals());
+}
+
+int JackClient::ParallelFor(unsigned int count, JackParallelCallback callback, void* arg)
+{
+    if (callback == NULL) {
+        jack_error("JackClient::ParallelFor NULL callback");
+        return -1;
+    }
+
+    jack_time_t usecs;
+    if (fWorkers.ParallelFor(count, callback, arg, &usecs) < 0) {
+        jack_error("JackClient::ParallelFor cannot be called while another call is running");
+        return -1;
+    }
+    if (usecs > 0) {
+        // Reset when the client is awakened, read by the server once the cycle is done
+        GetGraphManager()->GetClientTiming(GetClientControl()->fRefNum)->fWorkersUsecs += usecs;
+    }
+    return 0;
+}
+
+int JackClient::SetFlushDenormals(int onoff)
+{
+    if (onoff < -1 || onoff > 1) {
+        jack_error("JackClient::SetFlushDenormals bad mode = %d", onoff);
+        return -1;
+    }
+
+    // The RT thread and the workers take it at their next cycle
+    fFlushDenormals = onoff;
+    fWorkers.SetFlushDenormals(FlushDenormals());
+    return 0;
+}
+
+bool JackClient::FlushDenormals()
+{
+    return (fFlushDenormals < 0) ? GetEngineControl()->fFlushDenormals : (fFlushDenormals > 0);
+}
+
+/*!
+\brief Sets the floating point mode of the RT thread, called in the RT thread.
+*/
+void JackClient::SetupDenormals()
+{
+    fDenormalsFlushed = FlushDenormals();
+    if (!Jack::SetFlushDenormals(fDenormalsFlushed)) {
+        jack_log("JackClient::SetupDenormals denormals cannot be flushed on this CPU");
+    }
+}
+
 int JackClient::StartThread()
 {
     if (fThread.StartSync() < 0) {
@@ -590,9 +1065,26 @@ inline void JackClient::ExecuteThread()
 
 inline jack_nframes_t JackClient::CycleWaitAux()
 {
+    JACK_PROBE1(client_wait, GetClientControl()->fRefNum);
     if (!WaitSync()) {
         Error();   // Terminates the thread
     }
+    if (fChainEnd) {
+        End();     // Terminates the thread
+    }
+    if (GetClientControl()->fCPU != fCPU) {
+        SetupAffinity();
+    }
+    if (FlushDenormals() != fDenormalsFlushed) {
+        SetupDenormals();
+    }
+    if (fDeadline && (++fDeadlineCycles == DEADLINE_UPDATE_CYCLES || GetEngineControl()->fPeriodUsecs != fDeadlinePeriod)) {
+        SetupDeadline();
+    }
+#if HAVE_SDT
+    JackClientTiming* timing = GetGraphManager()->GetClientTiming(GetClientControl()->fRefNum);
+    JACK_PROBE3(client_wakeup, GetClientControl()->fRefNum, timing->fSignaledAt, timing->fAwakeAt);
+#endif
     CallSyncCallbackAux();
     return GetEngineControl()->fBufferSize;
 }
@@ -602,6 +1094,7 @@ inline void JackClient::CycleSignalAux(int status)
     if (status == 0) {
         CallTimebaseCallbackAux();
     }
+    JACK_PROBE2(client_signal, GetClientControl()->fRefNum, status);
     SignalSync();
     if (status != 0) {
         End();     // Terminates the thread
@@ -625,19 +1118,35 @@ inline int JackClient::CallProcessCallback()
 
 inline bool JackClient::WaitSync()
 {
+    // A new bound set with SetSpinWait tunes the budget again from 0
+    jack_time_t max = fSpinMax;
+    if (max != fSpinBound) {
+        fSpinBound = max;
+        fSpinBudget = 0;
+    }
+
+    // Spin first when asked to
+    jack_time_t spin_start = (max > 0) ? SpinWait() : 0;
+
     // Suspend itself: wait on the input synchro
     if (GetGraphManager()->SuspendRefNum(GetClientControl(), fSynchroTable, 0x7FFFFFFF) < 0) {
         jack_error("SuspendRefNum error");
         return false;
+    }
+    if (spin_start > 0) {
+        SpinAdapt(spin_start);
     } else {
-        return true;
+        fSpinBudget = 0;
     }
+    return true;
 }
 
 inline void JackClient::SignalSync()
 {
-    // Resume: signal output clients connected to the running client
-    if (GetGraphManager()->ResumeRefNum(GetClientControl(), fSynchroTable) < 0) {
+    // Resume: signal output clients connected to the running client, or execute them when chained
+    if (fChainable && !fDeadline) {
+        ResumeChain();
+    } else if (GetGraphManager()->ResumeRefNum(GetClientControl(), fSynchroTable) < 0) {
         jack_error("ResumeRefNum error");
     }
 }
@@ -1113,14 +1622,28 @@ int JackClient::SetPortRegistrationCallback(JackPortRegistrationCallback callbac
         jack_error("You cannot set callbacks on an active client");
         return -1;
     } else {
-        GetClientControl()->fCallback[kPortRegistrationOnCallback] = (callback != NULL);
-        GetClientControl()->fCallback[kPortRegistrationOffCallback] = (callback != NULL);
+        GetClientControl()->fCallback[kPortRegistrationOnCallback] = (callback != NULL || fPortRegistrationBatch != NULL);
+        GetClientControl()->fCallback[kPortRegistrationOffCallback] = (callback != NULL || fPortRegistrationBatch != NULL);
         fPortRegistrationArg = arg;
         fPortRegistration = callback;
         return 0;
     }
 }
 
+int JackClient::SetPortRegistrationBatchCallback(JackPortRegistrationBatchCallback callback, void *arg)
+{
+    if (IsActive()) {
+        jack_error("You cannot set callbacks on an active client");
+        return -1;
+    } else {
+        GetClientControl()->fCallback[kPortRegistrationOnCallback] = (callback != NULL || fPortRegistration != NULL);
+        GetClientControl()->fCallback[kPortRegistrationOffCallback] = (callback != NULL || fPortRegistration != NULL);
+        fPortRegistrationBatchArg = arg;
+        fPortRegistrationBatch = callback;
+        return 0;
+    }
+}
+
 int JackClient::SetPortConnectCallback(JackPortConnectCallback callback, void *arg)
 {
     if (IsActive()) {
@@ -1148,6 +1671,19 @@ int JackClient::SetPortRenameCallback(JackPortRenameCallback callback, void *arg
     }
 }
 
+int JackClient::SetPropertyChangeCallback(JackPropertyChangeCallback callback, void *arg)
+{
+    if (IsActive()) {
+        jack_error("You cannot set callbacks on an active client");
+        return -1;
+    } else {
+        GetClientControl()->fCallback[kPropertyChangeCallback] = (callback != NULL);
+        fPropertyChangeArg = arg;
+        fPropertyChange = callback;
+        return 0;
+    }
+}
+
 int JackClient::SetProcessThread(JackThreadCallback fun, void *arg)
 {
     if (IsActive()) {
@@ -1312,5 +1848,48 @@ int JackClient::ClientHasSessionCallback(const char* client_name)
     return result;
 }
 
+//------------------
+// Metadata API
+//------------------
+
+int JackClient::SetProperty(jack_uuid_t subject, const char* key, const char* value, const char* type)
+{
+    // The request carries fixed size strings, that would silently truncate the property
+    if (strlen(key) >= METADATA_KEY_SIZE || strlen(value) >= METADATA_VALUE_SIZE || (type && strlen(type) >= METADATA_TYPE_SIZE)) {
+        jack_error("JackClient::SetProperty property too large key = %s", key);
+        return -1;
+    }
+
+    int result = -1;
+    fChannel->MetadataChange(GetClientControl()->fRefNum, kSetProperty, subject, key, value, type, &result);
+    return result;
+}
+
+int JackClient::RemoveProperty(jack_uuid_t subject, const char* key)
+{
+    if (strlen(key) >= METADATA_KEY_SIZE) {
+        jack_error("JackClient::RemoveProperty key too large key = %s", key);
+        return -1;
+    }
+
+    int result = -1;
+    fChannel->MetadataChange(GetClientControl()->fRefNum, kRemoveProperty, subject, key, NULL, NULL, &result);
+    return result;
+}
+
+int JackClient::RemoveProperties(jack_uuid_t subject)
+{
+    int result = -1;
+    fChannel->MetadataChange(GetClientControl()->fRefNum, kRemoveProperties, subject, NULL, NULL, NULL, &result);
+    return result;
+}
+
+int JackClient::RemoveAllProperties()
+{
+    int result = -1;
+    fChannel->MetadataChange(GetClientControl()->fRefNum, kRemoveAllProperties, 0, NULL, NULL, NULL, &result);
+    return result;
+}
+
 } // end of namespace
 
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackPlatformPlug.h"
 #include "JackChannel.h"
 #include "JackRequest.h"
+#include "JackClientWorkers.h"
 #include "varargs.h"
 #include <list>
 
@@ -61,6 +62,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         JackClientRegistrationCallback fClientRegistration;
         JackFreewheelCallback fFreewheel;
         JackPortRegistrationCallback fPortRegistration;
+        JackPortRegistrationBatchCallback fPortRegistrationBatch;
         JackPortConnectCallback fPortConnect;
         JackPortRenameCallback fPortRename;
         JackTimebaseCallback fTimebase;
@@ -68,6 +70,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         JackThreadCallback fThreadFun;
         JackSessionCallback fSession;
         JackLatencyCallback fLatency;
+        JackPropertyChangeCallback fPropertyChange;
 
         void* fProcessArg;
         void* fGraphOrderArg;
@@ -80,6 +83,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         void* fClientRegistrationArg;
         void* fFreewheelArg;
         void* fPortRegistrationArg;
+        void* fPortRegistrationBatchArg;
         void* fPortConnectArg;
         void* fPortRenameArg;
         void* fTimebaseArg;
@@ -87,6 +91,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         void* fThreadFunArg;
         void* fSessionArg;
         void* fLatencyArg;
+        void* fPropertyChangeArg;
         char fServerName[JACK_SERVER_NAME_SIZE];
 
         JackThread fThread;    /*! Thread to execute the Process function */
@@ -96,6 +101,28 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
 
         JackSessionReply fSessionReply;
 
+        int fCPU;                           /*! CPU the RT thread is pinned to, -1 when not pinned */
+        int fUserCPUs[RT_CPU_NUM];          /*! CPUs set with jack_client_set_cpu_affinity */
+        volatile int fUserCPUCount;         /*! 0 when the RT thread follows the server core set */
+
+        bool fDeadline;                     /*! RT thread uses SCHED_DEADLINE */
+        volatile jack_time_t fDeadlinePeriod;   /*! Period the parameters were derived from, 0 to derive them again */
+        UInt64 fDeadlineRuntime;
+        UInt32 fDeadlineCycles;
+
+        volatile jack_time_t fSpinMax;      /*! Bound of the spin budget set with jack_client_set_spin_wait, 0 when not spinning */
+        jack_time_t fSpinBound;             /*! Bound the spin budget is currently tuned for, only used in the RT thread */
+        jack_time_t fSpinBudget;            /*! Spin budget tuned from the measured waits */
+        UInt32 fActivation;                 /*! Last activation seen, see JackClientTiming::fActivation */
+
+        bool fChainable;                    /*! Can be executed on the thread of the previous client of a chain (internal clients) */
+        volatile bool fChainEnd;            /*! The process callback failed while chained, the RT thread ends the client */
+
+        JackClientWorkers fWorkers;         /*! Worker threads created with jack_client_create_workers */
+
+        volatile int fFlushDenormals;       /*! Set with jack_client_set_flush_denormals, -1 to follow the server */
+        bool fDenormalsFlushed;             /*! Mode of the RT thread */
+
         int StartThread();
         void SetupDriverSync(bool freewheel);
         bool IsActive();
@@ -119,8 +146,19 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         inline int ActivateAux();
         inline void InitAux();
         inline void SetupRealTime();
+        void SetupAffinity();
+        void SetupDeadline();
+        void SetupDenormals();
+        jack_time_t SpinWait();
+        void SpinAdapt(jack_time_t start);
+        void ResumeChain();
+        JackClient* AcquireChained();
+        int CycleChained();
+        void WaitUnchained();
 
         int HandleLatencyCallback(int status);
+        void HandleNotificationRing(UInt32 limit);
+        void CallPortRegistrationCallback(const jack_port_id_t* ports, unsigned int count, int onoff);
 
     public:
 
@@ -146,6 +184,12 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         virtual int ComputeTotalLatencies();
         virtual void ShutDown(jack_status_t code, const char* message);
         virtual jack_native_thread_t GetThreadID();
+        virtual int SetCPUAffinity(const int* cpus, int count);
+        virtual int SetSpinWait(jack_time_t max_usecs);
+        virtual int CreateWorkers(int count);
+        virtual int ParallelFor(unsigned int count, JackParallelCallback callback, void* arg);
+        virtual int SetFlushDenormals(int onoff);
+        virtual bool FlushDenormals();
 
         // Port management
         virtual int PortRegister(const char* port_name, const char* port_type, unsigned long flags, unsigned long buffer_size);
@@ -182,10 +226,12 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         virtual int SetClientRegistrationCallback(JackClientRegistrationCallback callback, void* arg);
         virtual int SetFreewheelCallback(JackFreewheelCallback callback, void* arg);
         virtual int SetPortRegistrationCallback(JackPortRegistrationCallback callback, void* arg);
+        virtual int SetPortRegistrationBatchCallback(JackPortRegistrationBatchCallback callback, void* arg);
         virtual int SetPortConnectCallback(JackPortConnectCallback callback, void *arg);
         virtual int SetPortRenameCallback(JackPortRenameCallback callback, void *arg);
         virtual int SetSessionCallback(JackSessionCallback callback, void *arg);
         virtual int SetLatencyCallback(JackLatencyCallback callback, void *arg);
+        virtual int SetPropertyChangeCallback(JackPropertyChangeCallback callback, void *arg);
 
         // Internal clients
         virtual char* GetInternalClientName(int ref);
@@ -206,6 +252,12 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         virtual int ReserveClientName(const char* client_name, const char* uuid);
         virtual int ClientHasSessionCallback(const char* client_name);
 
+        // Metadata API
+        virtual int SetProperty(jack_uuid_t subject, const char* key, const char* value, const char* type);
+        virtual int RemoveProperty(jack_uuid_t subject, const char* key);
+        virtual int RemoveProperties(jack_uuid_t subject);
+        virtual int RemoveAllProperties();
+
         // JackRunnableInterface interface
         bool Init();
         bool Execute();
@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackPort.h"
 #include "JackSynchro.h"
 #include "JackNotification.h"
+#include "JackNotificationRing.h"
 #include "JackSession.h"
 
 namespace Jack
@@ -45,11 +46,14 @@ struct JackClientControl : public JackShmMemAble
     int fRefNum;
     int fPID;
     bool fActive;
+    volatile int fCPU;                  /* CPU given by the server to the RT thread, -1 when not pinned */
 
     int fSessionID;
     char fSessionCommand[JACK_SESSION_COMMAND_SIZE];
     jack_session_flags_t fSessionFlags;
 
+    MEM_ALIGN(JackNotificationRing fNotificationRing, CACHE_LINE_SIZE);
+
     JackClientControl(const char* name, int pid, int refnum, int uuid)
     {
         Init(name, pid, refnum, uuid);
@@ -79,14 +83,17 @@ struct JackClientControl : public JackShmMemAble
         // So that driver synchro are correctly setup in "flush" or "normal" mode
         fCallback[kStartFreewheelCallback] = true;
         fCallback[kStopFreewheelCallback] = true;
+        fCallback[kNotificationRing] = true;
         fRefNum = refnum;
         fPID = pid;
         fTransportState = JackTransportStopped;
         fTransportSync = false;
         fTransportTimebase = false;
         fActive = false;
+        fCPU = -1;
 
         fSessionID = uuid;
+        fNotificationRing.Init();
     }
 
 } POST_PACKED_STRUCTURE;
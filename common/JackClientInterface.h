@@ -46,6 +46,10 @@ class SERVER_EXPORT JackClientInterface
 
         virtual int ClientNotify(int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2) = 0;
 
+        // Deliver queued asynchronous notifications, if any
+        virtual void FlushNotifications()
+        {}
+
         virtual JackClientControl* GetClientControl() const = 0;
 };
 
@@ -0,0 +1,249 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackClientWorkers.h"
+#include "JackAtomic.h"
+#include "JackTime.h"
+#include "JackError.h"
+#include "JackDenormals.h"
+#include <stdio.h>
+
+namespace Jack
+{
+
+static inline void SpinPause()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#elif defined(WIN32)
+    YieldProcessor();
+#endif
+}
+
+JackClientWorker::JackClientWorker(JackClientWorkers* workers)
+    :fWorkers(workers), fThread(this), fUsecs(0), fDenormalsFlushed(false)
+{}
+
+bool JackClientWorker::Init()
+{
+    if (fWorkers->fRealTime) {
+        set_threaded_log_function();
+        if (fThread.AcquireSelfRealTime(fWorkers->fPriority) < 0) {
+            jack_error("JackClientWorker::AcquireSelfRealTime error");
+        }
+    }
+    if (fWorkers->fCPUCount > 0 && fThread.SetSelfAffinity(fWorkers->fCPUs, fWorkers->fCPUCount) < 0) {
+        jack_error("JackClientWorker::SetSelfAffinity error");
+    }
+    fDenormalsFlushed = fWorkers->fFlushDenormals;
+    SetFlushDenormals(fDenormalsFlushed);
+    return true;
+}
+
+bool JackClientWorker::Execute()
+{
+    if (!fSynchro.Wait() || fWorkers->fQuit) {
+        return false;
+    }
+    if (fWorkers->fFlushDenormals != fDenormalsFlushed) {
+        fDenormalsFlushed = fWorkers->fFlushDenormals;
+        SetFlushDenormals(fDenormalsFlushed);
+    }
+
+    jack_time_t start = fWorkers->Now();
+    fWorkers->Run();
+    fUsecs = fWorkers->Now() - start;
+
+    // The last one to finish wakes the calling thread up, when it already gave its token
+    if (DEC_ATOMIC(&fWorkers->fPending) == 1) {
+        fWorkers->fJoin.Signal();
+    }
+    return true;
+}
+
+JackClientWorkers::JackClientWorkers()
+    :fCount(0), fOpened(false), fPriority(0), fRealTime(false), fCPUCount(0), fQuit(false), fFlushDenormals(false),
+    fBusy(0), fCallback(NULL), fArg(NULL), fItems(0), fNext(0), fPending(0)
+{
+    for (int i = 0; i < CLIENT_WORKER_NUM; i++) {
+        fWorkers[i] = NULL;
+    }
+}
+
+JackClientWorkers::~JackClientWorkers()
+{
+    Close();
+}
+
+int JackClientWorkers::Open(const char* name, const char* server_name, int count, int priority, bool real_time, const int* cpus, int cpu_count, bool flush_denormals)
+{
+    char synchro_name[SYNC_MAX_NAME_SIZE + 1];
+
+    if (count <= 0 || count > CLIENT_WORKER_NUM) {
+        jack_error("JackClientWorkers::Open bad worker count = %d", count);
+        return -1;
+    }
+
+    fPriority = priority;
+    fRealTime = real_time;
+    fCPUCount = (cpu_count > RT_CPU_NUM) ? RT_CPU_NUM : cpu_count;
+    for (int i = 0; i < fCPUCount; i++) {
+        fCPUs[i] = cpus[i];
+    }
+    fQuit = false;
+    fFlushDenormals = flush_denormals;
+
+    snprintf(synchro_name, sizeof(synchro_name), "%s.join", name);
+    if (!fJoin.Allocate(synchro_name, server_name, 0)) {
+        jack_error("JackClientWorkers::Open cannot allocate synchro");
+        return -1;
+    }
+    fOpened = true;
+
+    for (fCount = 0; fCount < count; fCount++) {
+        JackClientWorker* worker = new JackClientWorker(this);
+        snprintf(synchro_name, sizeof(synchro_name), "%s.worker%d", name, fCount);
+        if (!worker->fSynchro.Allocate(synchro_name, server_name, 0)) {
+            jack_error("JackClientWorkers::Open cannot allocate synchro");
+            delete worker;
+            Close();
+            return -1;
+        }
+        if (worker->fThread.StartSync() < 0) {
+            jack_error("JackClientWorkers::Open cannot start thread");
+            worker->fSynchro.Destroy();
+            delete worker;
+            Close();
+            return -1;
+        }
+        fWorkers[fCount] = worker;
+    }
+
+    jack_log("JackClientWorkers::Open name = %s count = %d", name, fCount);
+    return 0;
+}
+
+void JackClientWorkers::Close()
+{
+    if (!fOpened) {
+        return;
+    }
+
+    fQuit = true;
+    for (int i = 0; i < fCount; i++) {
+        fWorkers[i]->fSynchro.Signal();
+        fWorkers[i]->fThread.Stop();
+        fWorkers[i]->fSynchro.Destroy();
+        delete fWorkers[i];
+        fWorkers[i] = NULL;
+    }
+    fJoin.Destroy();
+    fCount = 0;
+    fOpened = false;
+}
+
+void JackClientWorkers::AcquireRealTime(int priority)
+{
+    // Workers opened while freewheeling were started without RT scheduling
+    fPriority = priority;
+    fRealTime = true;
+    for (int i = 0; i < fCount; i++) {
+        if (fWorkers[i]->fThread.AcquireRealTime(priority) < 0) {
+            jack_error("JackClientWorkers::AcquireRealTime error");
+        }
+    }
+}
+
+void JackClientWorkers::DropRealTime()
+{
+    for (int i = 0; fRealTime && i < fCount; i++) {
+        fWorkers[i]->fThread.DropRealTime();
+    }
+}
+
+jack_time_t JackClientWorkers::Now()
+{
+    // Dates do not move with the virtual clock, the work done is measured in CPU time instead
+    return (IsVirtualClock()) ? GetThreadCPUNanoSeconds() / 1000 : GetMicroSeconds();
+}
+
+void JackClientWorkers::Run()
+{
+    SInt32 index;
+    while ((index = INC_ATOMIC(&fNext)) < fItems) {
+        fCallback(index, fArg);
+    }
+}
+
+/*!
+\brief Spreads the calls over the calling thread and the workers, called in the RT thread. Gives the time spent by the workers.
+*/
+int JackClientWorkers::ParallelFor(unsigned int count, JackParallelCallback callback, void* arg, jack_time_t* usecs)
+{
+    // The fork state is shared: a nested or concurrent fork would overwrite it
+    if (!CAS(0, 1, &fBusy)) {
+        return -1;
+    }
+
+    SInt32 items = (count < 0x7FFFFFFFU) ? SInt32(count) : 0x7FFFFFFF;
+    // The calling thread takes its share too
+    int used = (items - 1 < fCount) ? items - 1 : fCount;
+    if (used < 0) {
+        used = 0;
+    }
+
+    fCallback = callback;
+    fArg = arg;
+    fItems = items;
+    fNext = 0;
+    fPending = used + 1;
+
+    // Signaling is a full barrier, workers see the fork once woken up
+    for (int i = 0; i < used; i++) {
+        fWorkers[i]->fSynchro.Signal();
+    }
+
+    Run();
+
+    if (used > 0) {
+        // Spin while workers are running, then give the token of the calling thread and block when some are still running
+        if (!IsVirtualClock()) {
+            jack_time_t end = GetMicroSeconds() + WORKER_JOIN_SPIN;
+            while (fPending > 1 && GetMicroSeconds() < end) {
+                SpinPause();
+            }
+        }
+        if (DEC_ATOMIC(&fPending) != 1) {
+            fJoin.Wait();
+        }
+    }
+
+    *usecs = 0;
+    for (int i = 0; i < used; i++) {
+        *usecs += fWorkers[i]->fUsecs;
+    }
+
+    // Full barrier, the next fork sees the workers done
+    CAS(1, 0, &fBusy);
+    return 0;
+}
+
+} // end of namespace
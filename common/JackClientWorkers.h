@@ -0,0 +1,131 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackClientWorkers__
+#define __JackClientWorkers__
+
+#include "JackConstants.h"
+#include "JackPlatformPlug.h"
+#include "JackTypes.h"
+#include "types.h"
+
+namespace Jack
+{
+
+class JackClientWorkers;
+
+/*!
+\brief A worker thread of a client, woken up by jack_client_parallel_for.
+*/
+
+class JackClientWorker : public JackRunnableInterface
+{
+
+    friend class JackClientWorkers;
+
+    private:
+
+        JackClientWorkers* fWorkers;
+        JackThread fThread;
+        JackSynchro fSynchro;
+        jack_time_t fUsecs;         // Time spent in the last fork, read by the calling thread once joined
+        bool fDenormalsFlushed;
+
+    public:
+
+        JackClientWorker(JackClientWorkers* workers);
+        virtual ~JackClientWorker()
+        {}
+
+        // JackRunnableInterface interface
+        bool Init();
+        bool Execute();
+
+};
+
+/*!
+\brief Worker threads of a client, the calls of jack_client_parallel_for are spread between them and the calling thread.
+
+Indexes are taken one at a time with an atomic increment, so that uneven work is balanced. The fork signals the synchro of
+the workers that are needed. One fork runs at a time: a call made while another one is running, from a callback or from another
+thread, fails. The join counts the workers still running down to the token of the calling thread: once done
+with its own share, the calling thread spins for WORKER_JOIN_SPIN, then gives its token and blocks on a synchro signaled
+by the worker that finishes last.
+*/
+
+class JackClientWorkers
+{
+
+    friend class JackClientWorker;
+
+    private:
+
+        JackClientWorker* fWorkers[CLIENT_WORKER_NUM];
+        int fCount;
+        bool fOpened;
+        JackSynchro fJoin;
+        int fPriority;
+        bool fRealTime;
+        int fCPUs[RT_CPU_NUM];
+        int fCPUCount;
+        volatile bool fQuit;
+        volatile bool fFlushDenormals;
+
+        // Current fork
+        volatile SInt32 fBusy;      // 1 while a fork is running, nested and concurrent calls are rejected
+        JackParallelCallback fCallback;
+        void* fArg;
+        SInt32 fItems;
+        volatile SInt32 fNext;
+        volatile SInt32 fPending;
+
+        void Run();
+        jack_time_t Now();
+
+    public:
+
+        JackClientWorkers();
+        ~JackClientWorkers();
+
+        int Open(const char* name, const char* server_name, int count, int priority, bool real_time, const int* cpus, int cpu_count, bool flush_denormals);
+        void Close();
+
+        int GetCount()
+        {
+            return fCount;
+        }
+
+        // Taken by the workers at their next wake up
+        void SetFlushDenormals(bool onoff)
+        {
+            fFlushDenormals = onoff;
+        }
+
+        // Freewheel
+        void AcquireRealTime(int priority);
+        void DropRealTime();
+
+        // RT
+        int ParallelFor(unsigned int count, JackParallelCallback callback, void* arg, jack_time_t* usecs);
+
+};
+
+} // end of namespace
+
+#endif
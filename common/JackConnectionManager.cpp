@@ -42,8 +42,11 @@ JackConnectionManager::JackConnectionManager()
 
     jack_log("JackConnectionManager::InitClients");
     for (i = 0; i < CLIENT_NUM; i++) {
+        fStage[i] = 0;
         InitRefNum(i);
     }
+    fStageCount = 0;
+    fSinkDelay = 0;
 }
 
 JackConnectionManager::~JackConnectionManager()
@@ -236,42 +239,98 @@ int JackConnectionManager::SuspendRefNum(JackClientControl* control, JackSynchro
 {
     bool res;
     if ((res = table[control->fRefNum].TimedWait(time_out_usec))) {
-        timing[control->fRefNum].fStatus = Running;
-        timing[control->fRefNum].fAwakeAt = GetMicroSeconds();
+        AwakeRefNum(control->fRefNum, timing);
     }
     return (res) ? 0 : -1;
 }
 
+/*!
+\brief Update state and timestamp of a client woken up, or executed on the thread of the previous client of a chain.
+*/
+void JackConnectionManager::AwakeRefNum(int refnum, JackClientTiming* timing)
+{
+    timing[refnum].fStatus = Running;
+    timing[refnum].fAwakeAt = GetMicroSeconds();
+    timing[refnum].fWorkersUsecs = 0;
+    // All dates of a cycle are equal with the virtual clock, the work done is measured in CPU time instead
+    if (IsVirtualClock()) {
+        timing[refnum].fAwakeCPUTime = GetThreadCPUNanoSeconds();
+    }
+}
+
 /*!
 \brief Signal clients connected to the given client.
+
+The chained client, when still chained in this state, is not signaled: it is left to the caller which executes it on its
+own thread, and 1 is returned. The signaled clients use the output port buffers of the given slot, the one of the cycle of the
+caller even when it is late.
 */
-int JackConnectionManager::ResumeRefNum(JackClientControl* control, JackSynchro* table, JackClientTiming* timing)
+int JackConnectionManager::ResumeRefNum(JackClientControl* control, JackSynchro* table, JackClientTiming* timing, int slot, int chained)
 {
     jack_time_t current_date = GetMicroSeconds();
     const jack_int_t* output_ref = fConnectionRef.GetItems(control->fRefNum);
     int res = 0;
+    bool inlined = false;
 
     // Update state and timestamp of current client
     timing[control->fRefNum].fStatus = Finished;
     timing[control->fRefNum].fFinishedAt = current_date;
+    if (IsVirtualClock()) {
+        timing[control->fRefNum].fCPUTime = GetThreadCPUNanoSeconds() - timing[control->fRefNum].fAwakeCPUTime
+            + timing[control->fRefNum].fWorkersUsecs * 1000;
+    }
 
     for (int i = 0; i < CLIENT_NUM; i++) {
 
-        // Signal connected clients or drivers
-        if (output_ref[i] > 0) {
+        // Signal connected clients or drivers, those of later pipeline stages do not wait for this client
+        if (output_ref[i] > 0 && !IsCut(control->fRefNum, i)) {
 
             // Update state and timestamp of destination clients
             timing[i].fStatus = Triggered;
             timing[i].fSignaledAt = current_date;
+            timing[i].fPipelineSlot = slot;
 
-            if (!fInputCounter[i].Signal(table + i, control)) {
+            if (i == chained && HasSingleInput(i)) {
+                inlined = true;
+            } else if (!fInputCounter[i].Signal(table + i, control, timing + i)) {
                 jack_log("JackConnectionManager::ResumeRefNum error: ref = %ld output = %ld ", control->fRefNum, i);
                 res = -1;
             }
         }
     }
 
-    return res;
+    return (res == 0 && inlined) ? 1 : res;
+}
+
+/*!
+\brief Whether the client has a single input client, not counting the freewheel driver which activates every client.
+*/
+bool JackConnectionManager::HasSingleInput(int refnum) const
+{
+    int count = fInputCounter[refnum].GetCount();
+    return (IsDirectConnection(FREEWHEEL_DRIVER_REFNUM, refnum)) ? (count == 2) : (count == 1);
+}
+
+/*!
+\brief Returns the client which can be executed right after the given one on the same thread, or EMPTY.
+
+The freewheel driver apart, the given client must be connected to this client only, which must have no other input.
+*/
+int JackConnectionManager::GetChainedRefNum(int refnum) const
+{
+    const jack_int_t* output_ref = fConnectionRef.GetItems(refnum);
+    int chained = EMPTY;
+
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        if (output_ref[i] > 0 && i != FREEWHEEL_DRIVER_REFNUM && !IsCut(refnum, i)) {
+            if (chained != EMPTY) {
+                return EMPTY;
+            }
+            chained = i;
+        }
+    }
+
+    return (chained != EMPTY && chained != refnum && HasSingleInput(chained)) ? chained : EMPTY;
 }
 
 static bool HasNoConnection(jack_int_t* table)
@@ -348,7 +407,7 @@ void JackConnectionManager::DirectConnect(int ref1, int ref2)
 {
     assert(ref1 >= 0 && ref2 >= 0);
 
-    if (fConnectionRef.IncItem(ref1, ref2) == 1) { // First connection between client ref1 and client ref2
+    if (fConnectionRef.IncItem(ref1, ref2) == 1 && !IsCut(ref1, ref2)) { // First connection between client ref1 and client ref2
         jack_log("JackConnectionManager::DirectConnect first: ref1 = %ld ref2 = %ld", ref1, ref2);
         fInputCounter[ref2].IncValue();
     }
@@ -361,12 +420,62 @@ void JackConnectionManager::DirectDisconnect(int ref1, int ref2)
 {
     assert(ref1 >= 0 && ref2 >= 0);
 
-    if (fConnectionRef.DecItem(ref1, ref2) == 0) { // Last connection between client ref1 and client ref2
+    if (fConnectionRef.DecItem(ref1, ref2) == 0 && !IsCut(ref1, ref2)) { // Last connection between client ref1 and client ref2
         jack_log("JackConnectionManager::DirectDisconnect last: ref1 = %ld ref2 = %ld", ref1, ref2);
         fInputCounter[ref2].DecValue();
     }
 }
 
+/*!
+\brief Set the pipeline stage of each refnum, the activation counters are computed again without the connections between stages.
+*/
+void JackConnectionManager::SetStages(const int* stages, int stage_count, int sink_delay)
+{
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        fStage[i] = stages[i];
+    }
+    fStageCount = stage_count;
+    fSinkDelay = sink_delay;
+
+    for (int ref2 = 0; ref2 < CLIENT_NUM; ref2++) {
+        int count = 0;
+        for (int ref1 = 0; ref1 < CLIENT_NUM; ref1++) {
+            if (IsDirectConnection(ref1, ref2) && !IsCut(ref1, ref2)) {
+                count++;
+            }
+        }
+        fInputCounter[ref2].SetValue(count);
+    }
+}
+
+/*!
+\brief Number of cycles between the writing of the output buffers of ref1 and their reading by ref2.
+
+The outputs of the drivers are written before the first stage and their inputs read after the last one, so that every path of
+the graph takes the same number of cycles. A feedback connection is read one cycle later, as in a graph which is not pipelined.
+*/
+int JackConnectionManager::GetDelay(int ref1, int ref2) const
+{
+    if (fStageCount == 0) {
+        return 0;
+    } else if (fLoopFeedback.GetConnectionIndex(ref1, ref2) >= 0) {
+        return 1;
+    } else {
+        int src = (fStage[ref1] == PIPELINE_DRIVER_STAGE) ? 0 : fStage[ref1];
+        int dst = (fStage[ref2] == PIPELINE_DRIVER_STAGE) ? fStageCount - 1 + fSinkDelay : fStage[ref2];
+        return (dst > src) ? dst - src : 0;
+    }
+}
+
+/*!
+\brief Number of cycles added by the pipeline between ref1 and ref2, the cycle of the asynchronous mode is in the latency of the drivers.
+*/
+int JackConnectionManager::GetLatencyDelay(int ref1, int ref2) const
+{
+    int delay = GetDelay(ref1, ref2);
+    return (delay > 0 && fStage[ref2] == PIPELINE_DRIVER_STAGE) ? delay - fSinkDelay : delay;
+}
+
 /*!
 \brief Returns the connections state between 2 refnum.
 */
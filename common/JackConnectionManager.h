@@ -373,10 +373,15 @@ class JackLoopFeedback
 PRE_PACKED_STRUCTURE
 struct JackClientTiming
 {
-    jack_time_t fSignaledAt;
+    MEM_ALIGN(jack_time_t fSignaledAt, CACHE_LINE_SIZE);     // Each client timing on its own cache line
     jack_time_t fAwakeAt;
     jack_time_t fFinishedAt;
+    jack_time_t fAwakeCPUTime;  // Thread CPU time in nsecs when woken up, virtual clock only
+    jack_time_t fCPUTime;       // Thread CPU time in nsecs spent in the cycle, virtual clock only
     jack_client_state_t fStatus;
+    volatile UInt32 fActivation;    // Incremented before the synchro is signaled, clients may spin on it
+    jack_time_t fWorkersUsecs;  // Time spent by the worker threads of the client in the cycle, see jack_client_parallel_for
+    int fPipelineSlot;          // Output port buffers of the cycle the client was signaled in, when the graph is pipelined
 
     JackClientTiming()
     {
@@ -390,7 +395,12 @@ struct JackClientTiming
         fSignaledAt = 0;
         fAwakeAt = 0;
         fFinishedAt = 0;
+        fAwakeCPUTime = 0;
+        fCPUTime = 0;
         fStatus = NotTriggered;
+        fActivation = 0;
+        fWorkersUsecs = 0;
+        fPipelineSlot = 0;
     }
 
 } POST_PACKED_STRUCTURE;
@@ -404,6 +414,7 @@ struct JackClientTiming
 <LI>The <B>fOutputPort</B> array contains the list (array line) of ouput connected  ports for a given client.
 <LI>The <B>fConnectionRef</B> array contains the number of ports connected between two clients.
 <LI>The <B>fInputCounter</B> array contains the number of input clients connected to a given for activation purpose.
+<LI>The <B>fStage</B> array contains the pipeline stage of a given client: a client does not wait for the clients of previous stages.
 </UL>
 */
 
@@ -417,10 +428,22 @@ class SERVER_EXPORT JackConnectionManager
         JackFixedArray1<PORT_NUM_FOR_CLIENT> fInputPort[CLIENT_NUM];	/*! Table of input port per refnum : to find a refnum for a given port */
         JackFixedArray<PORT_NUM_FOR_CLIENT> fOutputPort[CLIENT_NUM];	/*! Table of output port per refnum : to find a refnum for a given port */
         JackFixedMatrix<CLIENT_NUM> fConnectionRef;						/*! Table of port connections by (refnum , refnum) */
-        JackActivationCount fInputCounter[CLIENT_NUM];					/*! Activation counter per refnum */
+        MEM_ALIGN(JackActivationCount fInputCounter[CLIENT_NUM], CACHE_LINE_SIZE);	/*! Activation counter per refnum */
         JackLoopFeedback<CONNECTION_NUM_FOR_PORT> fLoopFeedback;		/*! Loop feedback connections */
+        int fStage[CLIENT_NUM];                                         /*! Pipeline stage per refnum, PIPELINE_DRIVER_STAGE for drivers */
+        int fStageCount;                                                /*! Number of pipeline stages, 0 when the graph is not pipelined */
+        int fSinkDelay;                                                 /*! 1 when the drivers read the outputs of the graph in the next cycle */
 
         bool IsLoopPathAux(int ref1, int ref2) const;
+        bool HasSingleInput(int refnum) const;
+
+        /*!
+          \brief Whether the activation of ref2 by ref1 is removed, ref2 being in a later pipeline stage.
+        */
+        bool IsCut(int ref1, int ref2) const
+        {
+            return (fStage[ref1] != PIPELINE_DRIVER_STAGE && fStage[ref2] > fStage[ref1]);
+        }
 
     public:
 
@@ -481,10 +504,22 @@ class SERVER_EXPORT JackConnectionManager
             return fInputCounter[refnum].GetValue();
         }
 
+        // Pipeline
+        void SetStages(const int* stages, int stage_count, int sink_delay);
+        int GetDelay(int ref1, int ref2) const;
+        int GetLatencyDelay(int ref1, int ref2) const;
+
+        bool IsDriverStage(int refnum) const
+        {
+            return (fStage[refnum] == PIPELINE_DRIVER_STAGE);
+        }
+
         // Graph
         void ResetGraph(JackClientTiming* timing);
-        int ResumeRefNum(JackClientControl* control, JackSynchro* table, JackClientTiming* timing);
+        int ResumeRefNum(JackClientControl* control, JackSynchro* table, JackClientTiming* timing, int slot, int chained = EMPTY);
         int SuspendRefNum(JackClientControl* control, JackSynchro* table, JackClientTiming* timing, long time_out_usec);
+        int GetChainedRefNum(int refnum) const;
+        static void AwakeRefNum(int refnum, JackClientTiming* timing);
         void TopologicalSort(std::vector<jack_int_t>& sorted);
 
 } POST_PACKED_STRUCTURE;
@@ -64,6 +64,8 @@
 #define CLIENT_NUM 64
 #endif
 
+#define CACHE_LINE_SIZE 64                      // Per client fields written in real-time are kept on their own cache line
+
 #define AUDIO_DRIVER_REFNUM   0                 // Audio driver is initialized first, it will get the refnum 0
 #define FREEWHEEL_DRIVER_REFNUM   1             // Freewheel driver is initialized second, it will get the refnum 1
 
@@ -71,9 +73,10 @@
 
 #define ALL_CLIENTS -1 // for notification
 
-#define JACK_PROTOCOL_VERSION 8
+#define JACK_PROTOCOL_VERSION 28
 
 #define SOCKET_TIME_OUT 2               // in sec
+#define NOTIFICATION_BATCH_USECS 5000   // Queued notifications are delivered by batch, at most this long after the first one
 #define DRIVER_OPEN_TIMEOUT 5           // in sec
 #define FREEWHEEL_DRIVER_TIMEOUT 10     // in sec
 #define DRIVER_TIMEOUT_FACTOR    10
@@ -87,4 +90,25 @@
 
 #define JACK_DEFAULT_SELF_CONNECT_MODE ' ' /* allow all requests */
 
+#define RT_CPU_NUM 64                           // Maximum number of CPUs in the core set of the RT threads
+
+#define JACK_CPU_POLICY_ROUND_ROBIN 'r'         /* clients take the CPUs of the core set in turn */
+#define JACK_CPU_POLICY_LEVEL 'l'               /* clients that run in parallel take different CPUs */
+#define JACK_DEFAULT_CPU_POLICY JACK_CPU_POLICY_ROUND_ROBIN
+
+#define DEADLINE_RUNTIME_DEFAULT 20             // Percent of the period given to a SCHED_DEADLINE thread before its process duration is measured
+#define DEADLINE_RUNTIME_MARGIN 150             // Percent of the measured process duration given to a SCHED_DEADLINE thread
+#define DEADLINE_RUNTIME_MIN 50                 // in usec
+#define DEADLINE_RUNTIME_MAX 90                 // Percent of the period
+#define DEADLINE_UPDATE_CYCLES 1024             // Cycles between two checks of the measured process duration
+
+#define SPIN_WAIT_MARGIN 125                    // Percent of the measured wait given to the spin budget
+#define SPIN_WAIT_GAIN 8                        // Each cycle the spin budget moves by 1 / SPIN_WAIT_GAIN towards its target
+
+#define CLIENT_WORKER_NUM 64                    // Maximum number of worker threads of a client
+#define WORKER_JOIN_SPIN 50                     // in usec, the thread calling jack_client_parallel_for spins for the workers before blocking
+
+#define PIPELINE_DEPTH_MAX 8                    // Maximum number of stages of the pipelined graph execution
+#define PIPELINE_DRIVER_STAGE -1                // Drivers are outside of the pipeline stages
+
 #endif
@@ -44,6 +44,7 @@
 #include "JackConstants.h"
 #include "JackDriverLoader.h"
 #include "JackServerGlobals.h"
+#include "JackEngineControl.h"
 
 using namespace Jack;
 
@@ -58,6 +59,13 @@ static struct jack_constraint_enum_char_descriptor self_connect_mode_constraint_
     { 0 }
 };
 
+static struct jack_constraint_enum_char_descriptor rt_cpu_policy_constraint_descr_array[] =
+{
+    { JACK_CPU_POLICY_ROUND_ROBIN, "Give the CPUs to the clients in turn" },
+    { JACK_CPU_POLICY_LEVEL, "Give different CPUs to the clients that run in parallel" },
+    { 0 }
+};
+
 struct jackctl_server
 {
     JSList * drivers;
@@ -109,6 +117,30 @@ struct jackctl_server
     /* char enum, self connect mode mode */
     union jackctl_parameter_value self_connect_mode;
     union jackctl_parameter_value default_self_connect_mode;
+
+    /* string, file to record the cycles of the master driver to, empty when not recording */
+    union jackctl_parameter_value record;
+    union jackctl_parameter_value default_record;
+
+    /* string, CPU list of the RT threads, empty when they are not pinned */
+    union jackctl_parameter_value rt_cpus;
+    union jackctl_parameter_value default_rt_cpus;
+
+    /* char enum, how the RT CPUs are given to the clients */
+    union jackctl_parameter_value rt_cpu_policy;
+    union jackctl_parameter_value default_rt_cpu_policy;
+
+    /* bool, whether the RT threads try SCHED_DEADLINE */
+    union jackctl_parameter_value deadline;
+    union jackctl_parameter_value default_deadline;
+
+    /* bool, whether the RT threads flush denormals to zero */
+    union jackctl_parameter_value flush_denormals;
+    union jackctl_parameter_value default_flush_denormals;
+
+    /* uint32_t, number of stages of the pipelined graph execution */
+    union jackctl_parameter_value pipeline;
+    union jackctl_parameter_value default_pipeline;
 };
 
 struct jackctl_driver
@@ -592,6 +624,17 @@ signal_handler(int sig)
     snprintf(buf, sizeof(buf), "Received signal %d during shutdown (ignored)\n", sig);
 }
 
+/* write the XRun flight recorder reports of the running server in the user directory */
+static void jackctl_dump_xrun_reports()
+{
+    JackServer* server = JackServerGlobals::fInstance;
+    if (server) {
+        char path[JACK_PATH_MAX + 1];
+        snprintf(path, sizeof(path), "%s/%s-xruns.log", JackTools::UserDir(), server->GetEngineControl()->fServerName);
+        server->GetEngine()->GetXRunRecorder()->Dump(path);
+    }
+}
+
 SERVER_EXPORT jackctl_sigmask_t *
 jackctl_setup_signals(
     unsigned int flags)
@@ -691,6 +734,7 @@ jackctl_wait_signals(jackctl_sigmask_t * sigmask)
         switch (sig) {
             case SIGUSR1:
                 //jack_dump_configuration(engine, 1);
+                jackctl_dump_xrun_reports();
                 break;
             case SIGUSR2:
                 // driver exit
@@ -918,6 +962,93 @@ SERVER_EXPORT jackctl_server_t * jackctl_server_create(
         goto fail_free_parameters;
     }
 
+    value.str[0] = 0;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "record",
+            "Record the capture buffers and transport of each cycle to a file.",
+            "Record the capture buffers, MIDI events and transport state of each cycle of the master driver to a file, which can be played again with the replay backend",
+            JackParamString,
+            &server_ptr->record,
+            &server_ptr->default_record,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.str[0] = 0;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "rt-cpus",
+            "CPU list of the RT threads, like 2-5,7.",
+            "Pin the driver thread to the first CPU of the list and the client RT threads to the other ones, or to the same one when there is a single CPU, and keep the other server threads off these CPUs",
+            JackParamString,
+            &server_ptr->rt_cpus,
+            &server_ptr->default_rt_cpus,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.c = JACK_DEFAULT_CPU_POLICY;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "rt-cpu-policy",
+            "How the RT CPUs are given to the clients.",
+            "Give the RT CPUs to the clients in turn, or so that the clients of a same level of the graph run on different CPUs",
+            JackParamChar,
+            &server_ptr->rt_cpu_policy,
+            &server_ptr->default_rt_cpu_policy,
+            value,
+            jack_constraint_compose_enum_char(
+                JACK_CONSTRAINT_FLAG_STRICT | JACK_CONSTRAINT_FLAG_FAKE_VALUE,
+                rt_cpu_policy_constraint_descr_array)) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.b = false;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "deadline",
+            "Use deadline scheduling for the RT threads.",
+            "Use SCHED_DEADLINE for the RT threads, with the buffer period and a runtime sized from the measured process duration of each client, and fall back to SCHED_FIFO when the kernel refuses it",
+            JackParamBool,
+            &server_ptr->deadline,
+            &server_ptr->default_deadline,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.b = false;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "flush-denormals",
+            "Flush denormals to zero in the RT threads.",
+            "Set the flush-to-zero and denormals-are-zero modes of the CPU in the RT threads of the server and of the clients, which avoids the slow processing of denormal numbers. Clients may change it for their own threads",
+            JackParamBool,
+            &server_ptr->flush_denormals,
+            &server_ptr->default_flush_denormals,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.ui = 1;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "pipeline",
+            "Number of stages of the graph execution.",
+            "Split the graph in stages by depth, which run in parallel on consecutive cycles. Each stage after the first one adds a period of latency",
+            JackParamUInt,
+            &server_ptr->pipeline,
+            &server_ptr->default_pipeline,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
     JackServerGlobals::on_device_acquire = on_device_acquire;
     JackServerGlobals::on_device_release = on_device_release;
 
@@ -1041,6 +1172,11 @@ jackctl_server_open(
             goto fail;
         }
 
+        if (server_ptr->pipeline.ui < 1 || server_ptr->pipeline.ui > PIPELINE_DEPTH_MAX) {
+            jack_error("Jack server started with a pipeline of %d stages (when it can be 1 to %d)", server_ptr->pipeline.ui, PIPELINE_DEPTH_MAX);
+            goto fail;
+        }
+
         /* get the engine/driver started */
         server_ptr->engine = new JackServer(
             server_ptr->sync.b,
@@ -1052,13 +1188,29 @@ jackctl_server_open(
             server_ptr->verbose.b,
             (jack_timer_type_t)server_ptr->clock_source.ui,
             server_ptr->self_connect_mode.c,
-            server_ptr->name.str);
+            server_ptr->name.str,
+            server_ptr->pipeline.ui);
         if (server_ptr->engine == NULL)
         {
             jack_error("Failed to create new JackServer object");
             goto fail_unregister;
         }
 
+        if (server_ptr->rt_cpus.str[0] != 0 && server_ptr->engine->SetCPUAffinity(server_ptr->rt_cpus.str, server_ptr->rt_cpu_policy.c) < 0)
+        {
+            goto fail_delete;
+        }
+
+        if (server_ptr->deadline.b && server_ptr->engine->SetDeadline(true) < 0)
+        {
+            goto fail_delete;
+        }
+
+        if (server_ptr->flush_denormals.b && server_ptr->engine->SetFlushDenormals(true) < 0)
+        {
+            goto fail_delete;
+        }
+
         if (!jackctl_create_param_list(driver_ptr->parameters, &paramlist)) goto fail_delete;
         rc = server_ptr->engine->Open(driver_ptr->desc_ptr, paramlist);
         jackctl_destroy_param_list(paramlist);
@@ -1068,6 +1220,13 @@ jackctl_server_open(
             goto fail_delete;
         }
 
+        if (server_ptr->record.str[0] != 0 && server_ptr->engine->StartRecording(server_ptr->record.str) < 0)
+        {
+            jack_error("Cannot record cycles to %s", server_ptr->record.str);
+            server_ptr->engine->Close();
+            goto fail_delete;
+        }
+
         return true;
 
     } catch (std::exception e) {
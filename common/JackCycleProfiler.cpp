@@ -0,0 +1,148 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackCycleProfiler.h"
+#include "JackClientInterface.h"
+#include "JackClientControl.h"
+#include "JackEngineControl.h"
+#include "JackGraphManager.h"
+#include <string.h>
+
+namespace Jack
+{
+
+JackCycleProfiler::JackCycleProfiler()
+{
+    fEnabled = 0;
+    fWriteIndex = 0;
+    fNamesCounter = 0;
+    memset(fNames, 0, sizeof(fNames));
+    for (int i = 0; i < PROFILER_CYCLES; i++) {
+        fCycles[i].fIndex = PROFILER_INVALID;
+        fCycles[i].fClientCount = 0;
+    }
+}
+
+void JackCycleProfiler::SetClientName(int refnum, const char* name)
+{
+    fNamesCounter++;
+    FullBarrier();
+    strncpy(fNames[refnum], (name) ? name : "", JACK_CLIENT_NAME_SIZE);
+    fNames[refnum][JACK_CLIENT_NAME_SIZE] = 0;
+    FullBarrier();
+    fNamesCounter++;
+}
+
+void JackCycleProfiler::GetClientName(int refnum, char* name, size_t size)
+{
+    UInt32 counter;
+    do {
+        counter = fNamesCounter;
+        FullBarrier();
+        strncpy(name, fNames[refnum], size);
+        name[size - 1] = 0;
+        FullBarrier();
+    } while ((counter & 1) || counter != fNamesCounter);
+}
+
+void JackCycleProfiler::FillCycle(JackCycleTimings* cycle,
+                                  JackClientInterface** table,
+                                  JackGraphManager* manager,
+                                  JackEngineControl* control,
+                                  jack_time_t cur_cycle_begin,
+                                  jack_time_t prev_cycle_end)
+{
+    UInt32 client_count = 0;
+
+    // Timings are the ones of the cycle that just ended, which began at fPrevCycleTime
+    cycle->fPeriodUsecs = control->fPeriodUsecs;
+    cycle->fCycleBegin = control->fPrevCycleTime;
+    cycle->fCycleEnd = prev_cycle_end;
+    cycle->fNextCycleBegin = cur_cycle_begin;
+    cycle->fCPULoad = control->fCPULoad;
+
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        JackClientInterface* client = table[i];
+        if (client && client->GetClientControl()->fActive) {
+            JackClientTiming* timing = manager->GetClientTiming(i);
+            JackCycleTiming* dst = &cycle->fClients[client_count++];
+            dst->fRefNum = i;
+            dst->fStatus = timing->fStatus;
+            dst->fSignaledAt = timing->fSignaledAt;
+            dst->fAwakeAt = timing->fAwakeAt;
+            dst->fFinishedAt = timing->fFinishedAt;
+            dst->fCPUTime = timing->fCPUTime;
+        }
+    }
+    cycle->fClientCount = client_count;
+}
+
+void JackCycleProfiler::Profile(JackClientInterface** table,
+                                JackGraphManager* manager,
+                                JackEngineControl* control,
+                                jack_time_t cur_cycle_begin,
+                                jack_time_t prev_cycle_end)
+{
+    UInt32 index = fWriteIndex;
+    JackCycleTimings* cycle = &fCycles[index & PROFILER_MASK];
+
+    // Readers of the previous content of the entry will see it changed
+    cycle->fIndex = PROFILER_INVALID;
+    FullBarrier();
+
+    FillCycle(cycle, table, manager, control, cur_cycle_begin, prev_cycle_end);
+
+    // The entry is complete before being published
+    FullBarrier();
+    cycle->fIndex = index;
+    fWriteIndex = index + 1;
+}
+
+/*
+Returns 0 when the entry of cycle index has been copied, -1 when it has not been written yet,
+and -2 when it has already been overwritten.
+*/
+int JackCycleProfiler::Read(UInt32 index, JackCycleTimings* cycle)
+{
+    UInt32 write_index = fWriteIndex;
+    if (index == write_index) {
+        return -1;
+    }
+    if (write_index - index > PROFILER_CYCLES) {
+        return -2;
+    }
+
+    JackCycleTimings* src = &fCycles[index & PROFILER_MASK];
+    if (src->fIndex != index) {
+        return -2;
+    }
+    FullBarrier();
+
+    UInt32 client_count = src->fClientCount;
+    if (client_count > CLIENT_NUM) {
+        client_count = CLIENT_NUM;
+    }
+    memcpy(cycle, src, sizeof(JackCycleTimings) - sizeof(JackCycleTiming) * (CLIENT_NUM - client_count));
+    cycle->fClientCount = client_count;
+
+    FullBarrier();
+    return (src->fIndex == index) ? 0 : -2;
+}
+
+} // end of namespace
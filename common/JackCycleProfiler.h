@@ -0,0 +1,149 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackCycleProfiler__
+#define __JackCycleProfiler__
+
+#include "types.h"
+#include "JackTypes.h"
+#include "JackConstants.h"
+#include "JackShmMem.h"
+
+namespace Jack
+{
+
+#define PROFILER_CYCLES 1024        // Must be a power of two
+#define PROFILER_MASK (PROFILER_CYCLES - 1)
+#define PROFILER_INVALID 0xFFFFFFFF
+
+class JackClientInterface;
+class JackGraphManager;
+struct JackEngineControl;
+
+/*!
+\brief Timing of a client during a cycle.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackCycleTiming
+{
+    SInt32 fRefNum;
+    SInt32 fStatus;
+    jack_time_t fSignaledAt;
+    jack_time_t fAwakeAt;
+    jack_time_t fFinishedAt;
+    jack_time_t fCPUTime;
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief Timing of all active clients during a cycle.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackCycleTimings
+{
+    volatile UInt32 fIndex;         // Cycle number, PROFILER_INVALID while being written
+    UInt32 fClientCount;
+    jack_time_t fPeriodUsecs;
+    jack_time_t fCycleBegin;
+    jack_time_t fCycleEnd;          // Date the last client finished (sync mode: driver end date)
+    jack_time_t fNextCycleBegin;
+    float fCPULoad;
+    JackCycleTiming fClients[CLIENT_NUM];
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief Cycle profiler in shared memory.
+
+When enabled, the server RT thread copies the JackClientTiming of every active client at the beginning of each
+cycle into a ring of PROFILER_CYCLES entries. There is a single writer and any number of readers that never block
+it: readers copy an entry and check its cycle number did not change meanwhile, otherwise the entry was overwritten
+and the reader lost it. Fields of the packed segment are not naturally aligned: a locked instruction on a field
+that straddles two cache lines becomes a bus lock, which the kernel may throttle for milliseconds, so the single
+writer publishes with plain stores and full barriers instead of CAS. Enabling is a plain flag in the segment, so
+readers switch profiling on and off at runtime.
+*/
+
+PRE_PACKED_STRUCTURE
+class SERVER_EXPORT JackCycleProfiler : public JackShmMem
+{
+
+    private:
+
+        volatile SInt32 fEnabled;
+        volatile UInt32 fWriteIndex;
+        volatile UInt32 fNamesCounter;  // Odd while a client name is changed
+        char fNames[CLIENT_NUM][JACK_CLIENT_NAME_SIZE + 1];
+        JackCycleTimings fCycles[PROFILER_CYCLES];
+
+        static void FullBarrier()
+        {
+        #if defined(__GNUC__)
+            __sync_synchronize();
+        #else
+            MemoryBarrier();
+        #endif
+        }
+
+    public:
+
+        JackCycleProfiler();
+
+        bool IsEnabled() const
+        {
+            return (fEnabled != 0);
+        }
+
+        void Enable(bool onoff)
+        {
+            fEnabled = onoff;
+        }
+
+        UInt32 GetWriteIndex() const
+        {
+            return fWriteIndex;
+        }
+
+        // Server
+        void SetClientName(int refnum, const char* name);
+
+        // RT
+        static void FillCycle(JackCycleTimings* cycle,
+                              JackClientInterface** table,
+                              JackGraphManager* manager,
+                              JackEngineControl* control,
+                              jack_time_t cur_cycle_begin,
+                              jack_time_t prev_cycle_end);
+        void Profile(JackClientInterface** table,
+                     JackGraphManager* manager,
+                     JackEngineControl* control,
+                     jack_time_t cur_cycle_begin,
+                     jack_time_t prev_cycle_end);
+
+        // Client
+        int Read(UInt32 index, JackCycleTimings* cycle);
+        void GetClientName(int refnum, char* name, size_t size);
+
+} POST_PACKED_STRUCTURE;
+
+} // end of namespace
+
+#endif
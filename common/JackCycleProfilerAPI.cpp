@@ -0,0 +1,173 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackCycleProfiler.h"
+#include "JackEngineControl.h"
+#include "JackGlobals.h"
+#include "JackError.h"
+#include "profiler.h"
+#include <new>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    LIB_EXPORT jack_profiler_t* jack_profiler_open(jack_client_t* client);
+    LIB_EXPORT void jack_profiler_close(jack_profiler_t* profiler);
+    LIB_EXPORT int jack_profiler_enable(jack_profiler_t* profiler, int onoff);
+    LIB_EXPORT int jack_profiler_is_enabled(jack_profiler_t* profiler);
+    LIB_EXPORT int jack_profiler_read(jack_profiler_t* profiler, jack_profiler_cycle_t* cycle);
+    LIB_EXPORT int jack_profiler_client_name(jack_profiler_t* profiler, int refnum, char* name, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+using namespace Jack;
+
+/*!
+\brief Reader side of the cycle profiler.
+*/
+
+struct _jack_profiler
+{
+    JackShmReadWritePtr<JackCycleProfiler> fProfiler;
+    UInt32 fReadIndex;
+    bool fEnabledByReader;
+    JackCycleTimings fCycle;
+    jack_profiler_client_t fClients[CLIENT_NUM];
+};
+
+LIB_EXPORT jack_profiler_t* jack_profiler_open(jack_client_t* ext_client)
+{
+    JackGlobals::CheckContext("jack_profiler_open");
+
+    if (ext_client == NULL) {
+        jack_error("jack_profiler_open called with a NULL client");
+        return NULL;
+    }
+    JackEngineControl* control = GetEngineControl();
+    if (control == NULL || control->fProfilerIndex < 0) {
+        jack_error("jack_profiler_open: server has no cycle profiler");
+        return NULL;
+    }
+
+    jack_profiler_t* profiler = new jack_profiler_t;
+    try {
+        profiler->fProfiler.SetShmIndex(control->fProfilerIndex, control->fServerName);
+    } catch (std::bad_alloc&) {
+        jack_error("jack_profiler_open: cannot attach cycle profiler segment");
+        delete profiler;
+        return NULL;
+    }
+    profiler->fReadIndex = profiler->fProfiler->GetWriteIndex();
+    profiler->fEnabledByReader = false;
+    return profiler;
+}
+
+LIB_EXPORT void jack_profiler_close(jack_profiler_t* profiler)
+{
+    if (profiler) {
+        if (profiler->fEnabledByReader) {
+            profiler->fProfiler->Enable(false);
+        }
+        delete profiler;
+    }
+}
+
+LIB_EXPORT int jack_profiler_enable(jack_profiler_t* profiler, int onoff)
+{
+    if (profiler == NULL) {
+        jack_error("jack_profiler_enable called with a NULL profiler");
+        return -1;
+    }
+    if (onoff && !profiler->fProfiler->IsEnabled()) {
+        // Only cycles profiled from now on are of interest
+        profiler->fReadIndex = profiler->fProfiler->GetWriteIndex();
+        profiler->fEnabledByReader = true;
+    } else if (!onoff) {
+        profiler->fEnabledByReader = false;
+    }
+    profiler->fProfiler->Enable(onoff != 0);
+    return 0;
+}
+
+LIB_EXPORT int jack_profiler_is_enabled(jack_profiler_t* profiler)
+{
+    return (profiler && profiler->fProfiler->IsEnabled()) ? 1 : 0;
+}
+
+LIB_EXPORT int jack_profiler_read(jack_profiler_t* profiler, jack_profiler_cycle_t* cycle)
+{
+    if (profiler == NULL || cycle == NULL) {
+        jack_error("jack_profiler_read called with a NULL parameter");
+        return -1;
+    }
+
+    JackCycleProfiler* shared = profiler->fProfiler;
+    UInt32 lost = 0;
+    int res;
+
+    while ((res = shared->Read(profiler->fReadIndex, &profiler->fCycle)) == -2) {
+        // Overwritten: skip to the oldest entry that is still available
+        UInt32 write_index = shared->GetWriteIndex();
+        UInt32 oldest = write_index - PROFILER_CYCLES + 1;
+        UInt32 next = (SInt32(oldest - profiler->fReadIndex) > 0) ? oldest : profiler->fReadIndex + 1;
+        lost += next - profiler->fReadIndex;
+        profiler->fReadIndex = next;
+    }
+    if (res < 0) {
+        return 0;
+    }
+
+    JackCycleTimings* src = &profiler->fCycle;
+    for (UInt32 i = 0; i < src->fClientCount; i++) {
+        jack_profiler_client_t* dst = &profiler->fClients[i];
+        dst->refnum = src->fClients[i].fRefNum;
+        dst->status = src->fClients[i].fStatus;
+        dst->signaled_at = src->fClients[i].fSignaledAt;
+        dst->awake_at = src->fClients[i].fAwakeAt;
+        dst->finished_at = src->fClients[i].fFinishedAt;
+        dst->cpu_nsecs = src->fClients[i].fCPUTime;
+    }
+
+    cycle->cycle = src->fIndex;
+    cycle->lost = lost;
+    cycle->period_usecs = src->fPeriodUsecs;
+    cycle->cycle_begin = src->fCycleBegin;
+    cycle->cycle_end = src->fCycleEnd;
+    cycle->next_cycle_begin = src->fNextCycleBegin;
+    cycle->cpu_load = src->fCPULoad;
+    cycle->client_count = src->fClientCount;
+    cycle->clients = profiler->fClients;
+
+    profiler->fReadIndex++;
+    return 1;
+}
+
+LIB_EXPORT int jack_profiler_client_name(jack_profiler_t* profiler, int refnum, char* name, size_t size)
+{
+    if (profiler == NULL || name == NULL || size == 0 || refnum < 0 || refnum >= CLIENT_NUM) {
+        jack_error("jack_profiler_client_name called with an invalid parameter");
+        return -1;
+    }
+    profiler->fProfiler->GetClientName(refnum, name, size);
+    return 0;
+}
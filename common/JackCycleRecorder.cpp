@@ -0,0 +1,264 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackCycleRecorder.h"
+#include "JackGraphManager.h"
+#include "JackEngineControl.h"
+#include "JackMidiPort.h"
+#include "JackError.h"
+#include <string.h>
+#include <errno.h>
+
+namespace Jack
+{
+
+#define CYCLE_RECORD_PAD(size, align) (((size) + (align) - 1) & ~size_t((align) - 1))
+
+JackCycleRecorder::JackCycleRecorder()
+    :fThread(this),
+    fRingBuffer(NULL),
+    fFile(NULL),
+    fRecord(NULL),
+    fMaxRecordSize(0),
+    fRunning(false),
+    fDropped(0)
+{
+    memset(&fHeader, 0, sizeof(fHeader));
+}
+
+JackCycleRecorder::~JackCycleRecorder()
+{
+    Close();
+}
+
+int JackCycleRecorder::Open(const char* path, int driver_refnum, JackGraphManager* manager, JackEngineControl* control)
+{
+    jack_int_t ports[PORT_NUM_FOR_CLIENT];
+    size_t midi_size = 0;
+
+    // Capture ports are the physical outputs of the driver, monitor ports are not physical
+    manager->GetOutputPorts(driver_refnum, ports);
+    for (int i = 0; i < PORT_NUM_FOR_CLIENT && ports[i] != EMPTY; i++) {
+        JackPort* port = manager->GetPort(ports[i]);
+        if (!(port->GetFlags() & JackPortIsPhysical)) {
+            continue;
+        }
+        if (strcmp(port->GetType(), JACK_DEFAULT_MIDI_TYPE) == 0) {
+            fMidiPorts[fHeader.fMidiChannels++] = ports[i];
+        } else if (strcmp(port->GetType(), JACK_DEFAULT_AUDIO_TYPE) == 0) {
+            fAudioPorts[fHeader.fAudioChannels++] = ports[i];
+        }
+    }
+
+    memcpy(fHeader.fMagic, CYCLE_RECORD_MAGIC, sizeof(fHeader.fMagic));
+    fHeader.fVersion = CYCLE_RECORD_VERSION;
+    fHeader.fHeaderSize = sizeof(JackCycleFileHeader);
+    fHeader.fSampleRate = control->fSampleRate;
+    fHeader.fBufferSize = control->fBufferSize;
+
+    // A recorded event never takes more room than in the MIDI port buffer, which has the size of an audio buffer of BUFFER_SIZE_MAX frames
+    midi_size = fHeader.fMidiChannels * (sizeof(uint32_t) + BUFFER_SIZE_MAX * sizeof(jack_default_audio_sample_t));
+    fMaxRecordSize = sizeof(JackCycleRecordHeader) + BUFFER_SIZE_MAX * sizeof(jack_default_audio_sample_t) * fHeader.fAudioChannels + midi_size;
+    fMaxRecordSize = CYCLE_RECORD_PAD(fMaxRecordSize, 8);
+
+    size_t cycle_size = sizeof(JackCycleRecordHeader) + control->fBufferSize * sizeof(jack_default_audio_sample_t) * fHeader.fAudioChannels;
+    size_t ring_size = cycle_size * (CYCLE_RECORD_SECONDS * control->fSampleRate / control->fBufferSize);
+    if (ring_size < 4 * fMaxRecordSize) {
+        ring_size = 4 * fMaxRecordSize;
+    }
+
+    if ((fRecord = (char*)malloc(fMaxRecordSize)) == NULL
+        || (fRingBuffer = jack_ringbuffer_create(ring_size)) == NULL) {
+        jack_error("JackCycleRecorder::Open cannot allocate buffers");
+        Close();
+        return -1;
+    }
+    jack_ringbuffer_mlock(fRingBuffer);
+
+    if ((fFile = fopen(path, "wb")) == NULL) {
+        jack_error("JackCycleRecorder::Open cannot open %s err = %s", path, strerror(errno));
+        Close();
+        return -1;
+    }
+    if (fwrite(&fHeader, sizeof(fHeader), 1, fFile) != 1) {
+        jack_error("JackCycleRecorder::Open cannot write %s err = %s", path, strerror(errno));
+        Close();
+        return -1;
+    }
+
+    fRunning = true;
+    if (fThread.StartSync() < 0) {
+        jack_error("JackCycleRecorder::Open cannot start thread");
+        fRunning = false;
+        Close();
+        return -1;
+    }
+
+    jack_info("Recording %d audio and %d MIDI capture channels to %s", fHeader.fAudioChannels, fHeader.fMidiChannels, path);
+    return 0;
+}
+
+void JackCycleRecorder::Close()
+{
+    if (fRunning) {
+        if (fGuard.Lock()) {
+            fRunning = false;
+            fGuard.Signal();
+            fGuard.Unlock();
+            fThread.Stop();
+        } else {
+            fRunning = false;
+            fThread.Kill();
+        }
+    }
+
+    if (fFile) {
+        // Write what is left, then the cycle count in the header
+        Execute();
+        if (fseek(fFile, 0, SEEK_SET) != 0 || fwrite(&fHeader, sizeof(fHeader), 1, fFile) != 1) {
+            jack_error("JackCycleRecorder::Close cannot write header");
+        }
+        fclose(fFile);
+        fFile = NULL;
+        jack_info("Recorded %lld cycles", (long long)fHeader.fCycles);
+    }
+
+    if (fRingBuffer) {
+        jack_ringbuffer_free(fRingBuffer);
+        fRingBuffer = NULL;
+    }
+    free(fRecord);
+    fRecord = NULL;
+}
+
+void JackCycleRecorder::Wakeup()
+{
+    // Same as JackMessageBuffer: a failed Trylock delays the write until the next cycle or the end of the writer wait
+    if (fGuard.Trylock()) {
+        fGuard.Signal();
+        fGuard.Unlock();
+    }
+}
+
+void JackCycleRecorder::Record(JackGraphManager* manager, JackEngineControl* control)
+{
+    jack_nframes_t frames = control->fBufferSize;
+    size_t audio_size = frames * sizeof(jack_default_audio_sample_t);
+    size_t size = sizeof(JackCycleRecordHeader) + audio_size * fHeader.fAudioChannels;
+    JackMidiBuffer* midi[PORT_NUM_FOR_CLIENT];
+
+    for (uint32_t i = 0; i < fHeader.fMidiChannels; i++) {
+        midi[i] = (JackMidiBuffer*)manager->GetBuffer(fMidiPorts[i], frames);
+        size += sizeof(uint32_t);
+        for (uint32_t j = 0; midi[i]->IsValid() && j < midi[i]->event_count; j++) {
+            size += sizeof(JackCycleMidiEvent) + CYCLE_RECORD_PAD(midi[i]->events[j].size, 4);
+        }
+    }
+    size = CYCLE_RECORD_PAD(size, 8);
+
+    if (size > fMaxRecordSize || jack_ringbuffer_write_space(fRingBuffer) < size) {
+        fDropped++;
+        Wakeup();
+        return;
+    }
+
+    JackCycleRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.fSize = size;
+    header.fFrames = frames;
+    header.fDropped = fDropped;
+    header.fTransportState = control->fTransport.Query(&header.fPosition);
+    jack_ringbuffer_write(fRingBuffer, (const char*)&header, sizeof(header));
+    size_t written = sizeof(header);
+
+    for (uint32_t i = 0; i < fHeader.fAudioChannels; i++) {
+        jack_ringbuffer_write(fRingBuffer, (const char*)manager->GetBuffer(fAudioPorts[i], frames), audio_size);
+        written += audio_size;
+    }
+
+    for (uint32_t i = 0; i < fHeader.fMidiChannels; i++) {
+        uint32_t count = (midi[i]->IsValid()) ? midi[i]->event_count : 0;
+        jack_ringbuffer_write(fRingBuffer, (const char*)&count, sizeof(count));
+        written += sizeof(count);
+        for (uint32_t j = 0; j < count; j++) {
+            JackMidiEvent* event = &midi[i]->events[j];
+            JackCycleMidiEvent record = { event->time, uint32_t(event->size) };
+            size_t padded = CYCLE_RECORD_PAD(event->size, 4);
+            static const char padding[8] = { 0 };
+            jack_ringbuffer_write(fRingBuffer, (const char*)&record, sizeof(record));
+            jack_ringbuffer_write(fRingBuffer, (const char*)event->GetData(midi[i]), event->size);
+            jack_ringbuffer_write(fRingBuffer, padding, padded - event->size);
+            written += sizeof(record) + padded;
+        }
+    }
+
+    if (written < size) {
+        static const char padding[8] = { 0 };
+        jack_ringbuffer_write(fRingBuffer, padding, size - written);
+    }
+
+    fDropped = 0;
+    Wakeup();
+}
+
+// Size of the first record of the ring buffer, once the RT thread has completely written it
+bool JackCycleRecorder::GetRecordSize(size_t* size)
+{
+    JackCycleRecordHeader header;
+    if (jack_ringbuffer_peek(fRingBuffer, (char*)&header, sizeof(header)) == sizeof(header)
+        && jack_ringbuffer_read_space(fRingBuffer) >= header.fSize) {
+        *size = header.fSize;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+void JackCycleRecorder::Write(size_t size)
+{
+    jack_ringbuffer_read(fRingBuffer, fRecord, size);
+    if (fwrite(fRecord, size, 1, fFile) != 1) {
+        jack_error("JackCycleRecorder::Write error err = %s", strerror(errno));
+    } else {
+        fHeader.fCycles++;
+    }
+}
+
+bool JackCycleRecorder::Execute()
+{
+    // Called by the writer thread, and by Close once the thread is stopped to write the last records
+    do {
+        size_t size;
+        while (GetRecordSize(&size)) {
+            Write(size);
+        }
+        if (fRunning && fGuard.Lock()) {
+            // Also waits while a record is partially written, the RT thread signals once it is complete
+            if (fRunning && !GetRecordSize(&size)) {
+                fGuard.TimedWait(CYCLE_RECORD_WAKEUP_USECS);
+            }
+            fGuard.Unlock();
+        }
+    } while (fRunning);
+
+    fflush(fFile);
+    return false;
+}
+
+} // end of namespace
@@ -0,0 +1,130 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackCycleRecorder__
+#define __JackCycleRecorder__
+
+#include "JackConstants.h"
+#include "JackPlatformPlug.h"
+#include "ringbuffer.h"
+#include "types.h"
+#include "transport.h"
+#include <stdio.h>
+#include <stdint.h>
+
+namespace Jack
+{
+
+class JackGraphManager;
+struct JackEngineControl;
+
+#define CYCLE_RECORD_MAGIC "JACKCYC"
+#define CYCLE_RECORD_VERSION 1
+#define CYCLE_RECORD_SECONDS 2          // Cycles buffered between the RT thread and the file writer
+#define CYCLE_RECORD_WAKEUP_USECS 100000    // Bounds the delay of a record whose wakeup was lost
+
+/*
+Cycle record file layout, in the byte order of the recording machine:
+
+    JackCycleFileHeader
+    then for each cycle:
+        JackCycleRecordHeader
+        fFrames samples for each audio channel
+        for each MIDI channel: an uint32_t event count, then for each event a JackCycleMidiEvent
+        followed by its data padded to 4 bytes
+
+Records are padded to 8 bytes so that the file can be mapped and read in place.
+*/
+
+struct JackCycleFileHeader
+{
+    char fMagic[8];
+    uint32_t fVersion;
+    uint32_t fHeaderSize;
+    uint32_t fSampleRate;
+    uint32_t fBufferSize;
+    uint32_t fAudioChannels;
+    uint32_t fMidiChannels;
+    uint64_t fCycles;           // Written when the recording is closed, 0 if it was interrupted
+};
+
+struct JackCycleRecordHeader
+{
+    uint32_t fSize;             // Record size in bytes, this header included
+    uint32_t fFrames;
+    uint32_t fDropped;          // Cycles lost before this one because the writer was late
+    uint32_t fTransportState;
+    jack_position_t fPosition;
+};
+
+struct JackCycleMidiEvent
+{
+    uint32_t fTime;
+    uint32_t fSize;
+};
+
+/*!
+\brief Records the capture buffers of the master driver and the transport state of each cycle to a file.
+
+The RT thread serializes each cycle in a ring buffer, which is written to the file by a non real-time thread. When the
+ring buffer is full the cycle is dropped and counted in the next record.
+*/
+
+class SERVER_EXPORT JackCycleRecorder : public JackRunnableInterface
+{
+
+    private:
+
+        JackThread fThread;
+        JackProcessSync fGuard;
+        jack_ringbuffer_t* fRingBuffer;
+        FILE* fFile;
+        char* fRecord;
+        size_t fMaxRecordSize;
+        volatile bool fRunning;
+
+        jack_port_id_t fAudioPorts[PORT_NUM_FOR_CLIENT];
+        jack_port_id_t fMidiPorts[PORT_NUM_FOR_CLIENT];
+        JackCycleFileHeader fHeader;
+        uint32_t fDropped;
+
+        bool GetRecordSize(size_t* size);
+        void Write(size_t size);
+        void Wakeup();
+
+    public:
+
+        JackCycleRecorder();
+        ~JackCycleRecorder();
+
+        // Server, before the driver is started
+        int Open(const char* path, int driver_refnum, JackGraphManager* manager, JackEngineControl* control);
+        void Close();
+
+        // RT
+        void Record(JackGraphManager* manager, JackEngineControl* control);
+
+        // JackRunnableInterface interface
+        bool Execute();
+
+};
+
+} // end of namespace
+
+#endif
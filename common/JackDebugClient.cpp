@@ -136,6 +136,42 @@ jack_native_thread_t JackDebugClient::GetThreadID()
     return fClient->GetThreadID();
 }
 
+int JackDebugClient::SetCPUAffinity(const int* cpus, int count)
+{
+    CheckClient("SetCPUAffinity");
+    return fClient->SetCPUAffinity(cpus, count);
+}
+
+int JackDebugClient::SetSpinWait(jack_time_t max_usecs)
+{
+    CheckClient("SetSpinWait");
+    return fClient->SetSpinWait(max_usecs);
+}
+
+int JackDebugClient::CreateWorkers(int count)
+{
+    CheckClient("CreateWorkers");
+    return fClient->CreateWorkers(count);
+}
+
+int JackDebugClient::ParallelFor(unsigned int count, JackParallelCallback callback, void* arg)
+{
+    CheckClient("ParallelFor");
+    return fClient->ParallelFor(count, callback, arg);
+}
+
+int JackDebugClient::SetFlushDenormals(int onoff)
+{
+    CheckClient("SetFlushDenormals");
+    return fClient->SetFlushDenormals(onoff);
+}
+
+bool JackDebugClient::FlushDenormals()
+{
+    CheckClient("FlushDenormals");
+    return fClient->FlushDenormals();
+}
+
 JackGraphManager* JackDebugClient::GetGraphManager() const
 {
     CheckClient("GetGraphManager");
@@ -524,6 +560,12 @@ int JackDebugClient::SetPortRegistrationCallback(JackPortRegistrationCallback ca
     return fClient->SetPortRegistrationCallback(callback, arg);
 }
 
+int JackDebugClient::SetPortRegistrationBatchCallback(JackPortRegistrationBatchCallback callback, void *arg)
+{
+    CheckClient("SetPortRegistrationBatchCallback");
+    return fClient->SetPortRegistrationBatchCallback(callback, arg);
+}
+
 int JackDebugClient::SetPortConnectCallback(JackPortConnectCallback callback, void *arg)
 {
     CheckClient("SetPortConnectCallback");
@@ -548,6 +590,12 @@ int JackDebugClient::SetLatencyCallback(JackLatencyCallback callback, void *arg)
     return fClient->SetLatencyCallback(callback, arg);
 }
 
+int JackDebugClient::SetPropertyChangeCallback(JackPropertyChangeCallback callback, void *arg)
+{
+    CheckClient("SetPropertyChangeCallback");
+    return fClient->SetPropertyChangeCallback(callback, arg);
+}
+
 int JackDebugClient::SetProcessThread(JackThreadCallback fun, void *arg)
 {
     CheckClient("SetProcessThread");
@@ -595,6 +643,30 @@ int JackDebugClient::ClientHasSessionCallback(const char* client_name)
     return fClient->ClientHasSessionCallback(client_name);
 }
 
+int JackDebugClient::SetProperty(jack_uuid_t subject, const char* key, const char* value, const char* type)
+{
+    CheckClient("SetProperty");
+    return fClient->SetProperty(subject, key, value, type);
+}
+
+int JackDebugClient::RemoveProperty(jack_uuid_t subject, const char* key)
+{
+    CheckClient("RemoveProperty");
+    return fClient->RemoveProperty(subject, key);
+}
+
+int JackDebugClient::RemoveProperties(jack_uuid_t subject)
+{
+    CheckClient("RemoveProperties");
+    return fClient->RemoveProperties(subject);
+}
+
+int JackDebugClient::RemoveAllProperties()
+{
+    CheckClient("RemoveAllProperties");
+    return fClient->RemoveAllProperties();
+}
+
 JackClientControl* JackDebugClient::GetClientControl() const
 {
     CheckClient("GetClientControl");
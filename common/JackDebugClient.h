@@ -86,6 +86,12 @@ class JackDebugClient : public JackClient
         int ComputeTotalLatencies();
         void ShutDown(jack_status_t code, const char* message);
         jack_native_thread_t GetThreadID();
+        int SetCPUAffinity(const int* cpus, int count);
+        int SetSpinWait(jack_time_t max_usecs);
+        int CreateWorkers(int count);
+        int ParallelFor(unsigned int count, JackParallelCallback callback, void* arg);
+        int SetFlushDenormals(int onoff);
+        bool FlushDenormals();
 
         // Port management
         int PortRegister(const char* port_name, const char* port_type, unsigned long flags, unsigned long buffer_size);
@@ -121,10 +127,12 @@ class JackDebugClient : public JackClient
         int SetClientRegistrationCallback(JackClientRegistrationCallback callback, void* arg);
         int SetFreewheelCallback(JackFreewheelCallback callback, void* arg);
         int SetPortRegistrationCallback(JackPortRegistrationCallback callback, void* arg);
+        int SetPortRegistrationBatchCallback(JackPortRegistrationBatchCallback callback, void* arg);
         int SetPortConnectCallback(JackPortConnectCallback callback, void *arg);
         int SetPortRenameCallback(JackPortRenameCallback callback, void *arg);
         int SetSessionCallback(JackSessionCallback callback, void *arg);
         int SetLatencyCallback(JackLatencyCallback callback, void *arg);
+        int SetPropertyChangeCallback(JackPropertyChangeCallback callback, void *arg);
 
         // Internal clients
         char* GetInternalClientName(int ref);
@@ -143,6 +151,12 @@ class JackDebugClient : public JackClient
         int ReserveClientName(const char* client_name, const char* uuid);
         int ClientHasSessionCallback(const char* client_name);
 
+        // Metadata API
+        int SetProperty(jack_uuid_t subject, const char* key, const char* value, const char* type);
+        int RemoveProperty(jack_uuid_t subject, const char* key);
+        int RemoveProperties(jack_uuid_t subject);
+        int RemoveAllProperties();
+
         JackClientControl* GetClientControl() const;
         void CheckClient(const char* function_name) const;
 
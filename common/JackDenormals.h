@@ -0,0 +1,72 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackDenormals__
+#define __JackDenormals__
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define JACK_DENORMALS_SSE 1
+#endif
+
+namespace Jack
+{
+
+#define JACK_MXCSR_DAZ 0x0040       // Denormal inputs are read as zero
+#define JACK_MXCSR_FTZ 0x8000       // Denormal results are flushed to zero
+#define JACK_FPCR_FZ (1 << 24)      // ARM flush-to-zero, covers inputs and results
+
+/*!
+\brief Flushes denormals to zero on the calling thread, or restores the IEEE behaviour. Returns false when the CPU has no such mode.
+
+The floating point environment is per thread, so it is set by each RT thread when it starts. SSE code gets FTZ and DAZ on
+x86_64, FTZ only on 32 bits x86 where the first SSE2 CPUs have no DAZ. The x87 unit has no such mode. On ARM, FZ applies to
+VFP and NEON (always flushing on 32 bits ARM).
+*/
+inline bool SetFlushDenormals(bool onoff)
+{
+#if defined(JACK_DENORMALS_SSE)
+#if defined(__x86_64__) || defined(_M_X64)
+    unsigned int mask = JACK_MXCSR_FTZ | JACK_MXCSR_DAZ;
+#else
+    unsigned int mask = JACK_MXCSR_FTZ;
+#endif
+    unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr((onoff) ? (mxcsr | mask) : (mxcsr & ~mask));
+    return true;
+#elif defined(__aarch64__)
+    unsigned long fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    fpcr = (onoff) ? (fpcr | JACK_FPCR_FZ) : (fpcr & ~(unsigned long)JACK_FPCR_FZ);
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+    return true;
+#elif defined(__arm__) && defined(__VFP_FP__) && !defined(__SOFTFP__)
+    unsigned int fpscr;
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+    fpscr = (onoff) ? (fpscr | JACK_FPCR_FZ) : (fpscr & ~(unsigned int)JACK_FPCR_FZ);
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+    return true;
+#else
+    return !onoff;
+#endif
+}
+
+} // end of namespace
+
+#endif
@@ -28,6 +28,7 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include "JackEngineControl.h"
 #include "JackClientControl.h"
 #include "JackLockedEngine.h"
+#include "JackProbes.h"
 #include "JackTime.h"
 #include <math.h>
 #include <assert.h>
@@ -188,12 +189,26 @@ bool JackDriver::IsRealTime() const
 void JackDriver::CycleIncTime()
 {
     fEngineControl->CycleIncTime(fBeginDateUst);
+    CycleNextSlot();
 }
 
 void JackDriver::CycleTakeBeginTime()
 {
     fBeginDateUst = GetMicroSeconds();  // Take callback date here
+    JACK_PROBE1(driver_cycle_begin, fBeginDateUst);
     fEngineControl->CycleIncTime(fBeginDateUst);
+    CycleNextSlot();
+}
+
+/*
+A new cycle uses the next buffers of the output ports when the graph is pipelined: done by the master driver before it
+writes its outputs, the slaves write theirs in the same cycle.
+*/
+void JackDriver::CycleNextSlot()
+{
+    if (fIsMaster) {
+        fGraphManager->NextPipelineSlot();
+    }
 }
 
 void JackDriver::CycleTakeEndTime()
@@ -167,6 +167,7 @@ class SERVER_EXPORT JackDriver : public JackDriverClientInterface
 
         void CycleIncTime();
         void CycleTakeBeginTime();
+        void CycleNextSlot();
         void CycleTakeEndTime();
 
         void SetupDriverSync(int ref, bool freewheel);
@@ -55,6 +55,9 @@ extern "C"
         value.ui = 21333U;
         jack_driver_descriptor_add_parameter(desc, &filler, "wait", 'w', JackDriverParamUInt, &value, NULL, "Number of usecs to wait between engine processes", NULL);
 
+        value.i = 0;
+        jack_driver_descriptor_add_parameter(desc, &filler, "virtual-time", 'V', JackDriverParamBool, &value, NULL, "Run cycles back-to-back on a virtual clock", "Run cycles back-to-back on a virtual clock advanced by one period per cycle, needs the server in synchronous mode");
+
         return desc;
     }
 
@@ -67,6 +70,7 @@ extern "C"
         const JSList * node;
         const jack_driver_param_t * param;
         bool monitor = false;
+        bool virtual_time = false;
 
         for (node = params; node; node = jack_slist_next (node)) {
             param = (const jack_driver_param_t *) node->data;
@@ -96,6 +100,10 @@ extern "C"
                 case 'm':
                     monitor = param->value.i;
                     break;
+
+                case 'V':
+                    virtual_time = param->value.i;
+                    break;
             }
         }
 
@@ -108,7 +116,9 @@ extern "C"
             jack_error("Buffer size set to %d", BUFFER_SIZE_MAX);
         }
 
-        Jack::JackDriverClientInterface* driver = new Jack::JackThreadedDriver(new Jack::JackDummyDriver("system", "dummy_pcm", engine, table));
+        Jack::JackDummyDriver* dummy_driver = new Jack::JackDummyDriver("system", "dummy_pcm", engine, table);
+        dummy_driver->SetVirtualTime(virtual_time);
+        Jack::JackDriverClientInterface* driver = new Jack::JackThreadedDriver(dummy_driver);
         if (driver->Open(buffer_size, sample_rate, 1, 1, capture_ports, playback_ports, monitor, "dummy", "dummy", 0, 0) == 0) {
             return driver;
         } else {
@@ -20,8 +20,10 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include <iostream>
 #include <fstream>
 #include <set>
+#include <algorithm>
 #include <assert.h>
 #include <ctype.h>
+#include <inttypes.h>
 
 #include "JackSystemDeps.h"
 #include "JackLockedEngine.h"
@@ -33,6 +35,7 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include "JackGlobals.h"
 #include "JackChannel.h"
 #include "JackError.h"
+#include "JackProbes.h"
 
 namespace Jack
 {
@@ -56,10 +59,26 @@ JackEngine::JackEngine(JackGraphManager* manager,
     fSessionPendingReplies = 0;
     fSessionTransaction = NULL;
     fSessionResult = NULL;
+    fProfiler = new JackCycleProfiler();
+    fEngineControl->fProfilerIndex = fProfiler->GetShmIndex();
+    fXRunRecorder = new JackXRunRecorder();
+    fEngineControl->fXRunRecorderIndex = fXRunRecorder->GetShmIndex();
+    fCycleRecorder = NULL;
+    fNextCPU = 0;
+    fStageCount = 0;
+    fNotificationDate = 0;
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        fStage[i] = 0;
+    }
 }
 
 JackEngine::~JackEngine()
-{}
+{
+    fEngineControl->fProfilerIndex = -1;
+    fEngineControl->fXRunRecorderIndex = -1;
+    delete fProfiler;
+    delete fXRunRecorder;
+}
 
 int JackEngine::Open()
 {
@@ -69,27 +88,34 @@ int JackEngine::Open()
     if (fChannel.Open(fEngineControl->fServerName) < 0) {
         jack_error("Cannot connect to server");
         return -1;
+    }
+
+    // Metadata are not mandatory
+    if (fMetadata.Open(fEngineControl->fServerName, true) < 0) {
+        jack_error("Cannot open metadata store, metadata API will not be available");
     } else {
-        return 0;
+        fMetadata.RemovePortProperties();
     }
+    return 0;
 }
 
 int JackEngine::Close()
 {
     jack_log("JackEngine::Close");
     fChannel.Close();
+    fMetadata.Close();
 
     // Close remaining clients (RT is stopped)
     for (int i = fEngineControl->fDriverNum; i < CLIENT_NUM; i++) {
         if (JackLoadableInternalClient* loadable_client = dynamic_cast<JackLoadableInternalClient*>(fClientTable[i])) {
             jack_log("JackEngine::Close loadable client = %s", loadable_client->GetClientControl()->fName);
             loadable_client->Close();
-            fClientTable[i] = NULL;
+            SetClient(i, NULL);
             delete loadable_client;
         } else if (JackExternalClient* external_client = dynamic_cast<JackExternalClient*>(fClientTable[i])) {
             jack_log("JackEngine::Close external client = %s", external_client->GetClientControl()->fName);
             external_client->Close();
-            fClientTable[i] = NULL;
+            SetClient(i, NULL);
             delete external_client;
         }
     }
@@ -117,9 +143,17 @@ int JackEngine::AllocateRefnum()
     return -1;
 }
 
+void JackEngine::SetClient(int refnum, JackClientInterface* client)
+{
+    JackWriteLock lock(&fClientLock);
+    fClientTable[refnum] = client;
+}
+
 void JackEngine::ReleaseRefnum(int refnum)
 {
-    fClientTable[refnum] = NULL;
+    SetClient(refnum, NULL);
+    fProfiler->SetClientName(refnum, NULL);
+    fGraphManager->InitClientTimingStats(refnum, NULL);
 
     if (fEngineControl->fTemporary) {
         int i;
@@ -145,6 +179,7 @@ void JackEngine::ProcessNext(jack_time_t cur_cycle_begin)
 {
     fLastSwitchUsecs = cur_cycle_begin;
     if (fGraphManager->RunNextGraph())  {   // True if the graph actually switched to a new state
+        fEngineControl->fGraphSwitches++;
         fChannel.Notify(ALL_CLIENTS, kGraphOrderCallback, 0);
     }
     fSignal.Signal();                       // Signal for threads waiting for next cycle
@@ -161,9 +196,17 @@ void JackEngine::ProcessCurrent(jack_time_t cur_cycle_begin)
 bool JackEngine::Process(jack_time_t cur_cycle_begin, jack_time_t prev_cycle_end)
 {
     bool res = true;
+    JACK_PROBE2(cycle_begin, cur_cycle_begin, prev_cycle_end);
 
     // Cycle  begin
     fEngineControl->CycleBegin(fClientTable, fGraphManager, cur_cycle_begin, prev_cycle_end);
+    if (fProfiler->IsEnabled()) {
+        fProfiler->Profile(fClientTable, fGraphManager, fEngineControl, cur_cycle_begin, prev_cycle_end);
+    }
+    fXRunRecorder->Record(fClientTable, fGraphManager, fEngineControl, cur_cycle_begin, prev_cycle_end);
+    if (fCycleRecorder) {
+        fCycleRecorder->Record(fGraphManager, fEngineControl);
+    }
   
     // Graph
     if (fGraphManager->IsFinishedGraph()) {
@@ -173,10 +216,12 @@ bool JackEngine::Process(jack_time_t cur_cycle_begin, jack_time_t prev_cycle_end
         jack_log("Process: graph not finished!");
         if (cur_cycle_begin > fLastSwitchUsecs + fEngineControl->fTimeOutUsecs) {
             jack_log("Process: switch to next state delta = %ld", long(cur_cycle_begin - fLastSwitchUsecs));
+            fEngineControl->fGraphForcedSwitches++;
             ProcessNext(cur_cycle_begin);
             res = true;
         } else {
             jack_log("Process: waiting to switch delta = %ld", long(cur_cycle_begin - fLastSwitchUsecs));
+            fEngineControl->fGraphWaits++;
             ProcessCurrent(cur_cycle_begin);
             res = false;
         }
@@ -184,6 +229,7 @@ bool JackEngine::Process(jack_time_t cur_cycle_begin, jack_time_t prev_cycle_end
 
     // Cycle end
     fEngineControl->CycleEnd(fClientTable);
+    JACK_PROBE2(cycle_end, cur_cycle_begin, res);
     return res;
 }
 
@@ -210,6 +256,8 @@ static const char* State2String(jack_client_state_t state)
 
 void JackEngine::CheckXRun(jack_time_t callback_usecs)  // REVOIR les conditions de fin
 {
+    bool xrun = false;
+
     for (int i = fEngineControl->fDriverNum; i < CLIENT_NUM; i++) {
         JackClientInterface* client = fClientTable[i];
         if (client && client->GetClientControl()->fActive) {
@@ -220,14 +268,20 @@ void JackEngine::CheckXRun(jack_time_t callback_usecs)  // REVOIR les conditions
             if (status != NotTriggered && status != Finished) {
                 jack_error("JackEngine::XRun: client = %s was not finished, state = %s", client->GetClientControl()->fName, State2String(status));
                 fChannel.Notify(ALL_CLIENTS, kXRunCallback, 0);  // Notify all clients
+                xrun = true;
             }
 
             if (status == Finished && (long)(finished_date - callback_usecs) > 0) {
                 jack_error("JackEngine::XRun: client %s finished after current callback", client->GetClientControl()->fName);
                 fChannel.Notify(ALL_CLIENTS, kXRunCallback, 0);  // Notify all clients
+                xrun = true;
             }
         }
     }
+
+    if (xrun) {
+        fXRunRecorder->Report(JackXRunGraph, fClientTable, fGraphManager, fEngineControl, callback_usecs);
+    }
 }
 
 int JackEngine::ComputeTotalLatencies()
@@ -272,6 +326,10 @@ int JackEngine::ClientNotify(JackClientInterface* client, int refnum, const char
     // External client
     if (dynamic_cast<JackExternalClient*>(client)) {
        res1 = client->ClientNotify(refnum, name, notify, sync, message, value1, value2);
+       // Queued in the notification ring, delivered with the current batch
+       if (!sync && JackNotificationRing::IsQueued(notify) && fNotificationDate == 0) {
+           fNotificationDate = GetMicroSeconds();
+       }
     // Important for internal client : unlock before calling the notification callbacks
     } else {
         bool res2 = Unlock();
@@ -302,6 +360,35 @@ void JackEngine::NotifyClients(int event, int sync, const char* message, int val
     }
 }
 
+void JackEngine::FlushNotifications()
+{
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        JackClientInterface* client = fClientTable[i];
+        if (client) {
+            client->FlushNotifications();
+        }
+    }
+    fNotificationDate = 0;
+}
+
+/*!
+\brief Flushes the queued notifications once the current batch is NOTIFICATION_BATCH_USECS old, called by the server request thread.
+
+Returns the time left before the pending batch is due in usecs, 0 when no notification is pending.
+*/
+int JackEngine::FlushPendingNotifications()
+{
+    if (fNotificationDate == 0) {
+        return 0;
+    }
+    jack_time_t elapsed = GetMicroSeconds() - fNotificationDate;
+    if (elapsed < NOTIFICATION_BATCH_USECS) {
+        return int(NOTIFICATION_BATCH_USECS - elapsed);
+    }
+    FlushNotifications();
+    return 0;
+}
+
 int JackEngine::NotifyAddClient(JackClientInterface* new_client, const char* new_name, int refnum)
 {
     jack_log("JackEngine::NotifyAddClient: name = %s", new_name);
@@ -340,6 +427,7 @@ void JackEngine::NotifyRemoveClient(const char* name, int refnum)
 void JackEngine::NotifyDriverXRun()
 {
     // Use the audio thread => request thread communication channel
+    fXRunRecorder->Report(JackXRunDriver, fClientTable, fGraphManager, fEngineControl, 0);
     fChannel.Notify(ALL_CLIENTS, kXRunCallback, 0);
 }
 
@@ -352,8 +440,165 @@ void JackEngine::NotifyClientXRun(int refnum)
     }
 }
 
+/*
+Gives a CPU of the RT core set to each active client, the RT thread of the client moves to it at its next cycle. The first CPU
+is left to the driver thread when there are others. With the round-robin policy a client keeps the CPU it got when it entered
+the graph. With the level policy the level of a client is its longest path from the drivers: the clients of a same level may
+run in parallel and get different CPUs, the clients of different levels run one after the other and can share them.
+*/
+void JackEngine::AssignCPUs()
+{
+    int count = fEngineControl->fRTCPUCount;
+    int first = (count > 1) ? 1 : 0;
+    bool active[CLIENT_NUM];
+
+    if (count == 0) {
+        return;
+    }
+
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        JackClientInterface* client = fClientTable[i];
+        active[i] = (i >= fEngineControl->fDriverNum && client && client->GetClientControl()->fActive);
+        if (!active[i] && client) {
+            client->GetClientControl()->fCPU = -1;
+        }
+    }
+
+    if (fEngineControl->fRTCPUPolicy == JACK_CPU_POLICY_ROUND_ROBIN) {
+        for (int i = 0; i < CLIENT_NUM; i++) {
+            JackClientControl* control = (active[i]) ? fClientTable[i]->GetClientControl() : NULL;
+            if (control && control->fCPU < 0) {
+                control->fCPU = fEngineControl->fRTCPUs[first + fNextCPU++ % (count - first)];
+                jack_log("JackEngine::AssignCPUs ref = %ld name = %s cpu = %d", i, control->fName, control->fCPU);
+            }
+        }
+        return;
+    }
+
+    int level[CLIENT_NUM];
+    int used[CLIENT_NUM];
+
+    ComputeLevels(active, level);
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        used[i] = 0;
+    }
+
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        if (active[i]) {
+            JackClientControl* control = fClientTable[i]->GetClientControl();
+            int cpu = fEngineControl->fRTCPUs[first + used[level[i]]++ % (count - first)];
+            if (control->fCPU != cpu) {
+                control->fCPU = cpu;
+                jack_log("JackEngine::AssignCPUs ref = %ld name = %s level = %d cpu = %d", i, control->fName, level[i], cpu);
+            }
+        }
+    }
+}
+
+/*
+Level of each active client: its longest path from the drivers, counted in the activation order.
+*/
+void JackEngine::ComputeLevels(const bool* active, int* level)
+{
+    int inputs[CLIENT_NUM];
+    bool done[CLIENT_NUM];
+    int remaining = 0;
+
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        level[i] = 0;
+        inputs[i] = 0;
+        done[i] = !active[i];
+        if (active[i]) {
+            remaining++;
+        }
+    }
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        for (int j = 0; j < CLIENT_NUM; j++) {
+            if (active[i] && active[j] && i != j && fGraphManager->IsDirectConnection(i, j)) {
+                inputs[j]++;
+            }
+        }
+    }
+
+    // Same order as the activation: a client once all the clients it depends on are done
+    while (remaining > 0) {
+        int next = -1;
+        for (int i = 0; i < CLIENT_NUM && next < 0; i++) {
+            if (!done[i] && inputs[i] == 0) {
+                next = i;
+            }
+        }
+        for (int i = 0; i < CLIENT_NUM && next < 0; i++) {
+            // Clients left are in a feedback loop, take them in refnum order
+            if (!done[i]) {
+                next = i;
+            }
+        }
+        done[next] = true;
+        remaining--;
+        for (int j = 0; j < CLIENT_NUM; j++) {
+            if (!done[j] && j != next && fGraphManager->IsDirectConnection(next, j)) {
+                inputs[j]--;
+                level[j] = std::max(level[j], level[next] + 1);
+            }
+        }
+    }
+}
+
+/*
+With the pipelined execution the levels of the clients are split in consecutive stages, as many as the pipeline depth when the
+graph has enough levels. All the stages run in the same cycle, each one on what the previous stage computed in the previous
+cycle: the data takes one cycle per stage from the capture to the playback ports. Stages only change with the graph, so that
+writing them does not trigger another graph reorder.
+*/
+void JackEngine::AssignStages()
+{
+    int depth = fEngineControl->fPipelineDepth;
+    bool active[CLIENT_NUM];
+    int level[CLIENT_NUM];
+    int stage[CLIENT_NUM];
+    int levels = 0;
+
+    if (depth <= 1) {
+        return;
+    }
+
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        JackClientInterface* client = fClientTable[i];
+        active[i] = (i >= fEngineControl->fDriverNum && client && client->GetClientControl()->fActive);
+    }
+
+    ComputeLevels(active, level);
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        if (active[i]) {
+            levels = std::max(levels, level[i] + 1);
+        }
+    }
+
+    int count = std::max(1, std::min(depth, levels));
+    bool changed = (count != fStageCount);
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        if (i < fEngineControl->fDriverNum) {
+            stage[i] = PIPELINE_DRIVER_STAGE;
+        } else {
+            stage[i] = (active[i]) ? level[i] * count / levels : 0;
+        }
+        changed |= (stage[i] != fStage[i]);
+        fStage[i] = stage[i];
+    }
+
+    if (changed) {
+        fStageCount = count;
+        jack_log("JackEngine::AssignStages levels = %d stages = %d", levels, count);
+        // In asynchronous mode the drivers read the outputs of the graph in the next cycle
+        fGraphManager->SetStages(stage, count, (fEngineControl->fSyncMode) ? 0 : 1);
+    }
+}
+
 void JackEngine::NotifyGraphReorder()
 {
+    AssignCPUs();
+    AssignStages();
     ComputeTotalLatencies();
     NotifyClients(kGraphOrderCallback, false, "", 0, 0);
 }
@@ -402,6 +647,20 @@ void JackEngine::NotifyPortConnect(jack_port_id_t src, jack_port_id_t dst, bool
     NotifyClients((onoff ? kPortConnectCallback : kPortDisconnectCallback), false, "", src, dst);
 }
 
+void JackEngine::NotifyPropertyChange(jack_uuid_t subject, const char* key, jack_property_change_t change)
+{
+    char uuid_buf[JACK_UUID_STRING_SIZE];
+    snprintf(uuid_buf, sizeof(uuid_buf), "%" PRIu64, subject);
+
+    // Subject is given as a string in the notification name
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        JackClientInterface* client = fClientTable[i];
+        if (client) {
+            ClientNotify(client, i, uuid_buf, kPropertyChangeCallback, false, (key) ? key : "", change, 0);
+        }
+    }
+}
+
 void JackEngine::NotifyActivate(int refnum)
 {
     NotifyClient(refnum, kActivateClient, true, "", 0, 0);
@@ -598,6 +857,7 @@ int JackEngine::ClientExternalOpen(const char* name, int pid, int uuid, int* ref
         std::map<int, std::string>::iterator res = fReservationMap.find(uuid);
         if (res != fReservationMap.end()) {
             strncpy(real_name, res->second.c_str(), JACK_CLIENT_NAME_SIZE);
+            JackWriteLock lock(&fClientLock);
             fReservationMap.erase(uuid);
         } else {
             strncpy(real_name, name, JACK_CLIENT_NAME_SIZE);
@@ -631,7 +891,9 @@ int JackEngine::ClientExternalOpen(const char* name, int pid, int uuid, int* ref
         goto error;
     }
 
-    fClientTable[refnum] = client;
+    SetClient(refnum, client);
+    fProfiler->SetClientName(refnum, real_name);
+    fGraphManager->InitClientTimingStats(refnum, real_name);
 
     if (NotifyAddClient(client, real_name, refnum) < 0) {
         jack_error("Cannot notify add client");
@@ -648,7 +910,8 @@ int JackEngine::ClientExternalOpen(const char* name, int pid, int uuid, int* ref
 error:
     // Cleanup...
     fSynchroTable[refnum].Destroy();
-    fClientTable[refnum] = 0;
+    SetClient(refnum, NULL);
+    fGraphManager->InitClientTimingStats(refnum, NULL);
     client->Close();
     delete client;
     return -1;
@@ -676,7 +939,9 @@ int JackEngine::ClientInternalOpen(const char* name, int* ref, JackEngineControl
         goto error;
     }
 
-    fClientTable[refnum] = client;
+    SetClient(refnum, client);
+    fProfiler->SetClientName(refnum, name);
+    fGraphManager->InitClientTimingStats(refnum, name);
 
     if (NotifyAddClient(client, name, refnum) < 0) {
         jack_error("Cannot notify add client");
@@ -693,7 +958,10 @@ int JackEngine::ClientInternalOpen(const char* name, int* ref, JackEngineControl
 error:
     // Cleanup...
     fSynchroTable[refnum].Destroy();
-    fClientTable[refnum] = 0;
+    SetClient(refnum, NULL);
+    if (refnum >= 0) {
+        fGraphManager->InitClientTimingStats(refnum, NULL);
+    }
     return -1;
 }
 
@@ -737,6 +1005,12 @@ int JackEngine::ClientCloseAux(int refnum, bool wait)
         PortUnRegister(refnum, ports[i]);
     }
 
+    // Session IDs are reused, so properties do not survive the client
+    jack_uuid_t client_uuid = JackMetadata::SessionUUID(client->GetClientControl()->fSessionID);
+    if (client->GetClientControl()->fSessionID >= 0 && fMetadata.IsOpened() && fMetadata.RemoveProperties(client_uuid) > 0) {
+        NotifyPropertyChange(client_uuid, NULL, PropertyDeleted);
+    }
+
     // Remove the client from the table
     ReleaseRefnum(refnum);
 
@@ -789,6 +1063,7 @@ int JackEngine::ClientActivate(int refnum, bool is_real_time)
             NotifyPortRegistation(output_ports[i], true);
         }
 
+        FlushNotifications();
         return 0;
     }
 }
@@ -820,6 +1095,7 @@ int JackEngine::ClientDeactivate(int refnum)
         NotifyPortRegistation(output_ports[i], false);
     }
 
+    FlushNotifications();
     fGraphManager->Deactivate(refnum);
     fLastSwitchUsecs = 0; // Force switch to occur next cycle, even when called with "dead" clients
 
@@ -883,6 +1159,11 @@ int JackEngine::PortUnRegister(int refnum, jack_port_id_t port_index)
         if (client->GetClientControl()->fActive) {
             NotifyPortRegistation(port_index, false);
         }
+        // Port UUIDs are reused, so properties do not survive the port
+        jack_uuid_t port_uuid = JackMetadata::PortUUID(port_index);
+        if (fMetadata.IsOpened() && fMetadata.RemoveProperties(port_uuid) > 0) {
+            NotifyPropertyChange(port_uuid, NULL, PropertyDeleted);
+        }
         return 0;
     } else {
         return -1;
@@ -1041,6 +1322,7 @@ int JackEngine::PortRename(int refnum, jack_port_id_t port, const char* name)
     char old_name[REAL_JACK_PORT_NAME_SIZE];
     strcpy(old_name, fGraphManager->GetPort(port)->GetName());
     fGraphManager->GetPort(port)->SetName(name);
+    fGraphManager->IncEpoch();
     NotifyPortRename(port, old_name);
     return 0;
 }
@@ -1175,6 +1457,7 @@ int JackEngine::GetClientNameForUUID(const char *uuid, char *name_res)
 int JackEngine::ReserveClientName(const char *name, const char *uuid)
 {
     jack_log("JackEngine::ReserveClientName ( name = %s, uuid = %s )", name, uuid);
+    JackWriteLock lock(&fClientLock);
 
     if (ClientCheckName(name)) {
         jack_log("name already taken");
@@ -1203,5 +1486,56 @@ int JackEngine::ClientHasSessionCallback(const char *name)
     }
 }
 
-} // end of namespace
+//-------------------
+// Metadata
+//-------------------
 
+int JackEngine::MetadataChange(int refnum, int action, jack_uuid_t subject, const char* key, const char* value, const char* type)
+{
+    jack_log("JackEngine::MetadataChange ref = %ld action = %ld key = %s", refnum, action, key);
+
+    if (!fMetadata.IsOpened()) {
+        return -1;
+    }
+
+    switch (action) {
+
+        case kSetProperty: {
+            jack_property_change_t change;
+            if (fMetadata.SetProperty(subject, key, value, type, &change) < 0) {
+                return -1;
+            }
+            NotifyPropertyChange(subject, key, change);
+            return 0;
+        }
+
+        case kRemoveProperty:
+            if (fMetadata.RemoveProperty(subject, key) < 0) {
+                return -1;
+            }
+            NotifyPropertyChange(subject, key, PropertyDeleted);
+            return 0;
+
+        case kRemoveProperties: {
+            // A single notification (with a NULL key) for all the removed properties
+            int count = fMetadata.RemoveProperties(subject);
+            if (count > 0) {
+                NotifyPropertyChange(subject, NULL, PropertyDeleted);
+            }
+            return count;
+        }
+
+        case kRemoveAllProperties:
+            if (fMetadata.RemoveAllProperties() < 0) {
+                return -1;
+            }
+            NotifyPropertyChange(0, NULL, PropertyDeleted);
+            return 0;
+
+        default:
+            jack_error("JackEngine::MetadataChange unknown action = %ld", action);
+            return -1;
+    }
+}
+
+} // end of namespace
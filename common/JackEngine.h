@@ -28,6 +28,10 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include "JackPlatformPlug.h"
 #include "JackRequest.h"
 #include "JackChannel.h"
+#include "JackMetadata.h"
+#include "JackCycleProfiler.h"
+#include "JackXRunRecorder.h"
+#include "JackCycleRecorder.h"
 #include <map>
 
 namespace Jack
@@ -51,6 +55,7 @@ class SERVER_EXPORT JackEngine : public JackLockAble
         JackEngineControl* fEngineControl;
         char fSelfConnectMode;
         JackClientInterface* fClientTable[CLIENT_NUM];
+        JackRWLock fClientLock;                         /*! Written with the engine lock held, read by the queries that do not take it */
         JackSynchro* fSynchroTable;
         JackServerNotifyChannel fChannel;              /*! To communicate between the RT thread and server */
         JackProcessSync fSignal;
@@ -61,9 +66,20 @@ class SERVER_EXPORT JackEngine : public JackLockAble
         JackSessionNotifyResult* fSessionResult;
         std::map<int,std::string> fReservationMap;
         int fMaxUUID;
+        JackMetadata fMetadata;
+        JackCycleProfiler* fProfiler;
+        JackXRunRecorder* fXRunRecorder;
+        JackCycleRecorder* fCycleRecorder;
+        unsigned int fNextCPU;
+        int fStage[CLIENT_NUM];     /*! Pipeline stage of each refnum, as last given to the graph manager */
+        int fStageCount;
+        jack_time_t fNotificationDate;  /*! Date of the first notification queued since the last flush, 0 when none */
 
         int ClientCloseAux(int refnum, bool wait);
         void CheckXRun(jack_time_t callback_usecs);
+        void ComputeLevels(const bool* active, int* level);
+        void AssignCPUs();
+        void AssignStages();
 
         int NotifyAddClient(JackClientInterface* new_client, const char* new_name, int refnum);
         void NotifyRemoveClient(const char* name, int refnum);
@@ -76,16 +92,19 @@ class SERVER_EXPORT JackEngine : public JackLockAble
 
         int AllocateRefnum();
         void ReleaseRefnum(int refnum);
+        void SetClient(int refnum, JackClientInterface* client);
 
         int ClientNotify(JackClientInterface* client, int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2);
         
         void NotifyClient(int refnum, int event, int sync, const char*  message, int value1, int value2);
         void NotifyClients(int event, int sync, const char*  message,  int value1, int value2);
+        void FlushNotifications();
 
         void NotifyPortRegistation(jack_port_id_t port_index, bool onoff);
         void NotifyPortConnect(jack_port_id_t src, jack_port_id_t dst, bool onoff);
         void NotifyPortRename(jack_port_id_t src, const char* old_name);
         void NotifyActivate(int refnum);
+        void NotifyPropertyChange(jack_uuid_t subject, const char* key, jack_property_change_t change);
 
         int GetNewUUID();
         void EnsureUUID(int uuid);
@@ -149,6 +168,7 @@ class SERVER_EXPORT JackEngine : public JackLockAble
         void NotifyClientXRun(int refnum);
         void NotifyFailure(int code, const char* reason);
         void NotifyGraphReorder();
+        int FlushPendingNotifications();
         void NotifyBufferSize(jack_nframes_t buffer_size);
         void NotifySampleRate(jack_nframes_t sample_rate);
         void NotifyFreewheel(bool onoff);
@@ -162,6 +182,25 @@ class SERVER_EXPORT JackEngine : public JackLockAble
         int GetClientNameForUUID(const char *uuid, char *name_res);
         int ReserveClientName(const char *name, const char *uuid);
         int ClientHasSessionCallback(const char *name);
+
+        // Metadata
+        int MetadataChange(int refnum, int action, jack_uuid_t subject, const char* key, const char* value, const char* type);
+
+        JackXRunRecorder* GetXRunRecorder()
+        {
+            return fXRunRecorder;
+        }
+
+        // Set while the driver is stopped
+        void SetCycleRecorder(JackCycleRecorder* recorder)
+        {
+            fCycleRecorder = recorder;
+        }
+
+        JackMetadata* GetMetadata()
+        {
+            return &fMetadata;
+        }
 };
 
 
@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackFrameTimer.h"
 #include "JackTransportEngine.h"
 #include "JackConstants.h"
+#include "JackAtomic.h"
 #include "types.h"
 #include <stdio.h>
 
@@ -41,6 +42,23 @@ class JackGraphManager;
 #define JACK_ENGINE_ROLLING_COUNT 32
 #define JACK_ENGINE_ROLLING_INTERVAL 1024
 
+/*!
+\brief Monitoring counters of the engine control, only incremented.
+They are updated with atomic operations by the RT threads: each counter is naturally aligned so that
+a locked instruction never straddles two cache lines of the packed segment.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackEngineCounters
+{
+    MEM_ALIGN(volatile SInt32 fNetPacketErrors, CACHE_LINE_SIZE);  // Cycles with missing packets in the net driver
+    MEM_ALIGN(volatile SInt32 fMidiLostEvents, sizeof(SInt32));    // MIDI events lost by the MIDI drivers
+
+    JackEngineCounters(): fNetPacketErrors(0), fMidiLostEvents(0)
+    {}
+
+} POST_PACKED_STRUCTURE;
+
 /*!
 \brief Engine control in shared memory.
 */
@@ -68,6 +86,16 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
     jack_timer_type_t fClockSource;
     int fDriverNum;
     bool fVerbose;
+    int fProfilerIndex;     // Shared memory index of the JackCycleProfiler segment
+    int fXRunRecorderIndex; // Shared memory index of the JackXRunRecorder segment
+
+    // Core set of the RT threads, the driver thread is pinned to the first CPU
+    int fRTCPUs[RT_CPU_NUM];
+    int fRTCPUCount;        // 0 when the RT threads are not pinned
+    char fRTCPUPolicy;      // How the CPUs are given to the clients
+    bool fDeadline;         // RT threads try SCHED_DEADLINE before SCHED_FIFO
+    bool fFlushDenormals;   // RT threads flush denormals to zero, unless a client asks otherwise
+    int fPipelineDepth;     // Stages of the pipelined graph execution, 1 when the graph is not pipelined
 
     // CPU Load
     jack_time_t fPrevCycleTime;
@@ -88,6 +116,15 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
     // Timer
     JackFrameTimer fFrameTimer;
 
+    // Monitoring counters, only incremented
+    MEM_ALIGN(JackEngineCounters fCounters, CACHE_LINE_SIZE);
+    SInt32 fGraphSwitches;              // Graph state changes applied at cycle begin, only written by the RT thread
+    SInt32 fGraphWaits;                 // Cycles run with the current state because the previous cycle was not finished
+    SInt32 fGraphForcedSwitches;        // Switches done after the time out although the previous cycle was not finished
+
+    // Advanced by the driver when the clock source is JACK_TIMER_VIRTUAL, aligned so that clients read it in one access
+    MEM_ALIGN(volatile jack_time_t fVirtualTime, sizeof(jack_time_t));
+
 #ifdef JACK_MONITOR
     JackEngineProfiling fProfiler;
 #endif
@@ -126,6 +163,17 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
         fXrunDelayedUsecs = 0.f;
         fClockSource = clock;
         fDriverNum = 0;
+        fProfilerIndex = -1;
+        fXRunRecorderIndex = -1;
+        fRTCPUCount = 0;
+        fRTCPUPolicy = JACK_DEFAULT_CPU_POLICY;
+        fDeadline = false;
+        fFlushDenormals = false;
+        fPipelineDepth = 1;
+        fGraphSwitches = 0;
+        fGraphWaits = 0;
+        fGraphForcedSwitches = 0;
+        fVirtualTime = 0;
     }
 
     ~JackEngineControl()
@@ -139,6 +187,25 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
         }
     }
 
+    /*
+    SCHED_DEADLINE runtime in nanoseconds of a thread whose process callback lasts process_usecs (0 when not measured yet),
+    the deadline and period being the buffer period.
+    */
+    UInt64 DeadlineRuntime(jack_time_t process_usecs)
+    {
+        jack_time_t runtime = (process_usecs > 0)
+            ? process_usecs * DEADLINE_RUNTIME_MARGIN / 100 + DEADLINE_RUNTIME_MIN
+            : fPeriodUsecs * DEADLINE_RUNTIME_DEFAULT / 100;
+        jack_time_t max = fPeriodUsecs * DEADLINE_RUNTIME_MAX / 100;
+        if (runtime < DEADLINE_RUNTIME_MIN) {
+            runtime = DEADLINE_RUNTIME_MIN;
+        }
+        if (runtime > max) {
+            runtime = max;
+        }
+        return UInt64(runtime) * 1000;
+    }
+
     // Cycle
     void CycleIncTime(jack_time_t callback_usecs)
     {
@@ -183,6 +250,20 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
         fMaxDelayedUsecs = 0.f;
     }
 
+    // Monitoring
+    void IncNetPacketErrors()
+    {
+        INC_ATOMIC(&fCounters.fNetPacketErrors);
+    }
+
+    void AddMidiLostEvents(SInt32 count)
+    {
+        SInt32 actual;
+        do {
+            actual = fCounters.fMidiLostEvents;
+        } while (!CAS(actual, actual + count, &fCounters.fMidiLostEvents));
+    }
+
     // Private
     void CalcCPULoad(JackClientInterface** table, JackGraphManager* manager, jack_time_t cur_cycle_begin, jack_time_t prev_cycle_end);
     void ResetRollingUsecs();
@@ -27,11 +27,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 
 namespace Jack
 {
 
-JackEngineProfiling::JackEngineProfiling():fAudioCycle(0),fMeasuredClient(0)
+JackEngineProfiling::JackEngineProfiling():fAudioCycle(0),fMeasuredClient(0),fCycle(0),fTopologyCount(0)
 {
     jack_info("Engine profiling activated, beware %ld MBytes are needed to record profiling points...", sizeof(fProfileTable) / (1024 * 1024));
 
@@ -327,6 +329,276 @@ JackEngineProfiling::~JackEngineProfiling()
         fStream7 << "gnuplot -persist Timing4.plot\n";
         fStream7 << "gnuplot -persist Timing5.plot\n";
     }
+
+    SaveTrace("JackEngineProfiling.json");
+}
+
+/*!
+\brief Writes events in the Chrome trace event format, which Perfetto and chrome://tracing load.
+*/
+
+class JackTraceWriter
+{
+
+    private:
+
+        std::ofstream& fStream;
+        jack_time_t fOrigin;
+        bool fFirst;
+
+        void Begin(const char* phase, int tid, const char* name)
+        {
+            fStream << (fFirst ? "\n" : ",\n") << "{\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << tid << ",\"name\":";
+            fFirst = false;
+            String(name);
+        }
+
+        void Date(jack_time_t date)
+        {
+            fStream << ",\"ts\":" << (long long)(date - fOrigin);
+        }
+
+        void String(const char* str)
+        {
+            fStream << '"';
+            for (; *str; str++) {
+                if (*str == '"' || *str == '\\') {
+                    fStream << '\\' << *str;
+                } else if ((unsigned char)*str < 0x20) {
+                    fStream << ' ';
+                } else {
+                    fStream << *str;
+                }
+            }
+            fStream << '"';
+        }
+
+    public:
+
+        JackTraceWriter(std::ofstream& stream, jack_time_t origin)
+            :fStream(stream), fOrigin(origin), fFirst(true)
+        {
+            fStream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        }
+
+        ~JackTraceWriter()
+        {
+            fStream << "\n]}\n";
+        }
+
+        void ThreadName(int tid, const char* name, int sort_index)
+        {
+            Begin("M", tid, "thread_name");
+            fStream << ",\"args\":{\"name\":";
+            String(name);
+            fStream << "}}";
+            Begin("M", tid, "thread_sort_index");
+            fStream << ",\"args\":{\"sort_index\":" << sort_index << "}}";
+        }
+
+        void ProcessName(const char* name)
+        {
+            Begin("M", 0, "process_name");
+            fStream << ",\"args\":{\"name\":";
+            String(name);
+            fStream << "}}";
+        }
+
+        void Slice(int tid, const char* name, jack_time_t begin, jack_time_t end, unsigned int cycle)
+        {
+            Begin("X", tid, name);
+            Date(begin);
+            fStream << ",\"dur\":" << (long long)(end - begin) << ",\"args\":{\"cycle\":" << cycle << "}}";
+        }
+
+        void Instant(int tid, const char* name, jack_time_t date)
+        {
+            Begin("i", tid, name);
+            Date(date);
+            fStream << ",\"s\":\"t\"}";
+        }
+
+        // A flow starts in the slice beginning at date on tid, "f" binds to the enclosing slice
+        void Flow(const char* phase, unsigned int id, int tid, jack_time_t date)
+        {
+            Begin(phase, tid, "activation");
+            Date(date);
+            fStream << ",\"cat\":\"activation\",\"id\":" << id << ((phase[0] == 'f') ? ",\"bp\":\"e\"}" : "}");
+        }
+};
+
+/*
+Activation order of the clients in a topology: drivers first, then each client once all the clients it depends on.
+*/
+static void SortTopology(JackTimingTopology* topology, std::vector<int>& sorted)
+{
+    int input_count[CLIENT_NUM];
+    bool done[CLIENT_NUM];
+
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        input_count[i] = 0;
+        done[i] = !topology->fActive[i];
+        for (int j = 0; j < CLIENT_NUM; j++) {
+            if (topology->fActivation[j][i] && j >= topology->fDriverNum) {
+                input_count[i]++;
+            }
+        }
+    }
+
+    while (true) {
+        int next = -1;
+        for (int i = 0; i < CLIENT_NUM && next < 0; i++) {
+            if (!done[i] && (i < topology->fDriverNum || input_count[i] == 0)) {
+                next = i;
+            }
+        }
+        if (next < 0) {
+            // Clients left are in a feedback loop, take them in refnum order
+            for (int i = 0; i < CLIENT_NUM; i++) {
+                if (!done[i]) {
+                    sorted.push_back(i);
+                }
+            }
+            break;
+        }
+        done[next] = true;
+        sorted.push_back(next);
+        if (next >= topology->fDriverNum) {
+            for (int j = 0; j < CLIENT_NUM; j++) {
+                if (topology->fActivation[next][j]) {
+                    input_count[j]--;
+                }
+            }
+        }
+    }
+}
+
+/*
+Chrome trace of the recorded cycles: one track per client with its wakeup and process durations, one track per driver with
+its read and write durations, and flow arrows following the activation connections of the graph each cycle ran with.
+*/
+void JackEngineProfiling::SaveTrace(const char* name)
+{
+    std::ofstream stream(name, std::ios_base::ate);
+    if (!stream.is_open()) {
+        jack_error("JackEngineProfiling::SaveTrace cannot open %s file", name);
+        return;
+    }
+
+    // The oldest point follows the last written one in the ring
+    unsigned int first = (fAudioCycle + 1) % TIME_POINTS;
+    unsigned int first_topology = (fTopologyCount > TOPOLOGY_POINTS) ? fTopologyCount - TOPOLOGY_POINTS : 0;
+    jack_time_t origin = 0;
+
+    for (int k = 0; k < TIME_POINTS && origin == 0; k++) {
+        JackTimingMeasure* measure = &fProfileTable[(first + k) % TIME_POINTS];
+        if (measure->fCycle > 0) {
+            origin = measure->fCurCycleBegin;
+        }
+    }
+
+    JackTraceWriter writer(stream, origin);
+    unsigned int topology_index = first_topology;
+    unsigned int flow_id = 0;
+
+    for (int k = 1; k < TIME_POINTS && fTopologyCount > 0; k++) {
+
+        JackTimingMeasure* prev = &fProfileTable[(first + k - 1) % TIME_POINTS];
+        JackTimingMeasure* cur = &fProfileTable[(first + k) % TIME_POINTS];
+        if (prev->fCycle == 0 || cur->fCycle != prev->fCycle + 1) {
+            continue; // Skip non valid cycles
+        }
+
+        while (topology_index + 1 < fTopologyCount && fTopologyTable[(topology_index + 1) % TOPOLOGY_POINTS].fCycle <= cur->fCycle) {
+            topology_index++;
+        }
+        JackTimingTopology* topology = &fTopologyTable[topology_index % TOPOLOGY_POINTS];
+        if (topology->fCycle > cur->fCycle) {
+            continue; // Topology already overwritten
+        }
+
+        // The point keeps the timings of the cycle that began at the previous point
+        jack_time_t begin = prev->fCurCycleBegin;
+        jack_time_t end = (cur->fPrevCycleEnd > begin) ? cur->fPrevCycleEnd : begin;
+        jack_time_t src_date[CLIENT_NUM];
+        jack_time_t dst_date[CLIENT_NUM];
+
+        for (int i = 0; i < CLIENT_NUM; i++) {
+
+            JackTimingMeasureClient* timing = &cur->fClientTable[i];
+            src_date[i] = dst_date[i] = 0;
+            if (!topology->fActive[i] || timing->fStatus == NotTriggered) {
+                continue;
+            }
+
+            if (i < topology->fDriverNum) {
+                if (timing->fFinishedAt >= begin) {
+                    writer.Slice(i, (topology->fSyncMode) ? "read" : "read/write", begin, timing->fFinishedAt, prev->fCycle);
+                    src_date[i] = begin;
+                }
+                if (timing->fSignaledAt >= begin && timing->fSignaledAt >= timing->fFinishedAt) {
+                    if (topology->fSyncMode && end >= timing->fSignaledAt) {
+                        writer.Slice(i, "write", timing->fSignaledAt, end, prev->fCycle);
+                        dst_date[i] = timing->fSignaledAt;
+                    } else {
+                        writer.Instant(i, "graph end", timing->fSignaledAt);
+                    }
+                }
+            } else {
+                if (timing->fSignaledAt >= begin && timing->fAwakeAt >= timing->fSignaledAt) {
+                    writer.Slice(i, "wakeup", timing->fSignaledAt, timing->fAwakeAt, prev->fCycle);
+                    dst_date[i] = timing->fSignaledAt;
+                }
+                if (timing->fAwakeAt >= begin && timing->fFinishedAt >= timing->fAwakeAt) {
+                    writer.Slice(i, "process", timing->fAwakeAt, timing->fFinishedAt, prev->fCycle);
+                    src_date[i] = timing->fAwakeAt;
+                    if (dst_date[i] == 0) {
+                        dst_date[i] = timing->fAwakeAt;
+                    }
+                }
+                if (timing->fStatus != Finished) {
+                    writer.Instant(i, "not finished", (timing->fAwakeAt >= begin) ? timing->fAwakeAt : begin);
+                }
+            }
+
+            if (timing->fFinishedAt > end) {
+                end = timing->fFinishedAt;
+            }
+        }
+
+        writer.Slice(CLIENT_NUM, "cycle", begin, end, prev->fCycle);
+        if (end > begin + cur->fPeriodUsecs) {
+            writer.Instant(CLIENT_NUM, "late", begin + cur->fPeriodUsecs);
+        }
+
+        for (int i = 0; i < CLIENT_NUM; i++) {
+            for (int j = 0; j < CLIENT_NUM && src_date[i] > 0; j++) {
+                if (topology->fActivation[i][j] && dst_date[j] > 0) {
+                    writer.Flow("s", flow_id, i, src_date[i]);
+                    writer.Flow("f", flow_id, j, dst_date[j]);
+                    flow_id++;
+                }
+            }
+        }
+    }
+
+    // Tracks are named after the latest client that used the refnum, and sorted in the last activation order
+    writer.ProcessName("jackd");
+    writer.ThreadName(CLIENT_NUM, "cycles", 0);
+    if (fTopologyCount > 0) {
+        std::vector<int> sorted;
+        SortTopology(&fTopologyTable[(fTopologyCount - 1) % TOPOLOGY_POINTS], sorted);
+        for (int i = 0; i < CLIENT_NUM; i++) {
+            for (unsigned int t = fTopologyCount; t > first_topology; t--) {
+                JackTimingTopology* topology = &fTopologyTable[(t - 1) % TOPOLOGY_POINTS];
+                if (topology->fActive[i]) {
+                    int index = int(std::find(sorted.begin(), sorted.end(), i) - sorted.begin());
+                    writer.ThreadName(i, topology->fNames[i], index + 1);
+                    break;
+                }
+            }
+        }
+    }
 }
 
 bool JackEngineProfiling::CheckClient(const char* name, int cur_point)
@@ -340,6 +612,44 @@ bool JackEngineProfiling::CheckClient(const char* name, int cur_point)
     return false;
 }
 
+bool JackEngineProfiling::CheckTopology(JackClientInterface** table, JackGraphManager* manager)
+{
+    JackTimingTopology* last = (fTopologyCount > 0) ? &fTopologyTable[(fTopologyCount - 1) % TOPOLOGY_POINTS] : NULL;
+    UInt32 epoch = manager->GetEpoch();
+    bool changed = (last == NULL || last->fEpoch != epoch);
+
+    for (int i = 0; i < CLIENT_NUM && !changed; i++) {
+        JackClientInterface* client = table[i];
+        changed = (last->fActive[i] != (client && client->GetClientControl()->fActive));
+    }
+    if (!changed) {
+        return false;
+    }
+
+    // Keep the new topology, it will be used from the current cycle on
+    JackTimingTopology* topology = &fTopologyTable[fTopologyCount % TOPOLOGY_POINTS];
+    topology->fCycle = fCycle;
+    topology->fEpoch = epoch;
+    topology->fDriverNum = GetEngineControl()->fDriverNum;
+    topology->fSyncMode = GetEngineControl()->fSyncMode;
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        JackClientInterface* client = table[i];
+        topology->fActive[i] = (client && client->GetClientControl()->fActive);
+        if (topology->fActive[i]) {
+            strcpy(topology->fNames[i], client->GetClientControl()->fName);
+        } else {
+            topology->fNames[i][0] = 0;
+        }
+    }
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        for (int j = 0; j < CLIENT_NUM; j++) {
+            topology->fActivation[i][j] = (topology->fActive[i] && topology->fActive[j] && manager->IsDirectConnection(i, j));
+        }
+    }
+    fTopologyCount++;
+    return true;
+}
+
 void JackEngineProfiling::Profile(JackClientInterface** table,
                                    JackGraphManager* manager,
                                    jack_time_t period_usecs,
@@ -347,19 +657,27 @@ void JackEngineProfiling::Profile(JackClientInterface** table,
                                    jack_time_t prev_cycle_end)
 {
     fAudioCycle = (fAudioCycle + 1) % TIME_POINTS;
+    fCycle++;
 
     // Keeps cycle data
     fProfileTable[fAudioCycle].fPeriodUsecs = period_usecs;
     fProfileTable[fAudioCycle].fCurCycleBegin = cur_cycle_begin;
     fProfileTable[fAudioCycle].fPrevCycleEnd = prev_cycle_end;
     fProfileTable[fAudioCycle].fAudioCycle = fAudioCycle;
+    fProfileTable[fAudioCycle].fCycle = fCycle;
+
+    // Timings are the ones of the previous cycle, which ran with the current graph state (the engine switches to the next one later)
+    CheckTopology(table, manager);
 
-    for (int i = GetEngineControl()->fDriverNum; i < CLIENT_NUM; i++) {
+    for (int i = 0; i < CLIENT_NUM; i++) {
         JackClientInterface* client = table[i];
         JackClientTiming* timing = manager->GetClientTiming(i);
-        if (client && client->GetClientControl()->fActive && client->GetClientControl()->fCallback[kRealTimeCallback]) {
+        if (client && client->GetClientControl()->fActive) {
 
-            if (!CheckClient(client->GetClientControl()->fName, fAudioCycle)) {
+            // Drivers and clients without process callback are only kept for the trace
+            if (i >= GetEngineControl()->fDriverNum
+                && client->GetClientControl()->fCallback[kRealTimeCallback]
+                && !CheckClient(client->GetClientControl()->fName, fAudioCycle)) {
                 // Keep new measured client
                 fIntervalTable[fMeasuredClient].fRefNum = i;
                 strcpy(fIntervalTable[fMeasuredClient].fName, client->GetClientControl()->fName);
@@ -372,6 +690,8 @@ void JackEngineProfiling::Profile(JackClientInterface** table,
             fProfileTable[fAudioCycle].fClientTable[i].fAwakeAt = timing->fAwakeAt;
             fProfileTable[fAudioCycle].fClientTable[i].fFinishedAt = timing->fFinishedAt;
             fProfileTable[fAudioCycle].fClientTable[i].fStatus = timing->fStatus;
+        } else {
+            fProfileTable[fAudioCycle].fClientTable[i].fStatus = NotTriggered;
         }
     }
 }
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackTypes.h"
 #include "JackConstants.h"
 #include "JackShmMem.h"
+#include <string.h>
 
 namespace Jack
 {
@@ -32,6 +33,7 @@ namespace Jack
 #define FAILURE_TIME_POINTS 10000
 #define FAILURE_WINDOW 10
 #define MEASURED_CLIENTS 32
+#define TOPOLOGY_POINTS 256
 
 /*!
 \brief Timing stucture for a client.
@@ -84,13 +86,15 @@ PRE_PACKED_STRUCTURE
 struct JackTimingMeasure
 {
     unsigned int fAudioCycle;
+    unsigned int fCycle;            // Cycle number since the server started, 0 for an unused point
     jack_time_t fPeriodUsecs;
     jack_time_t fCurCycleBegin;
     jack_time_t fPrevCycleEnd;
     JackTimingMeasureClient fClientTable[CLIENT_NUM];
     
     JackTimingMeasure()
-        :fAudioCycle(0), 
+        :fAudioCycle(0),
+        fCycle(0),
         fPeriodUsecs(0),
         fCurCycleBegin(0),
         fPrevCycleEnd(0)
@@ -98,6 +102,34 @@ struct JackTimingMeasure
     
 } POST_PACKED_STRUCTURE;
 
+/*!
+\brief Active clients, their names and activation connections, kept each time the graph changes.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackTimingTopology
+{
+    unsigned int fCycle;            // First cycle using this topology
+    UInt32 fEpoch;
+    int fDriverNum;
+    bool fSyncMode;
+    bool fActive[CLIENT_NUM];
+    bool fActivation[CLIENT_NUM][CLIENT_NUM];
+    char fNames[CLIENT_NUM][JACK_CLIENT_NAME_SIZE + 1];
+
+    JackTimingTopology()
+        :fCycle(0),
+        fEpoch(0),
+        fDriverNum(0),
+        fSyncMode(false)
+    {
+        memset(fActive, 0, sizeof(fActive));
+        memset(fActivation, 0, sizeof(fActivation));
+        memset(fNames, 0, sizeof(fNames));
+    }
+
+} POST_PACKED_STRUCTURE;
+
 /*!
 \brief Client timing monitoring.
 */
@@ -113,11 +145,16 @@ class SERVER_EXPORT JackEngineProfiling
     
         JackTimingMeasure fProfileTable[TIME_POINTS];
         JackTimingClientInterval fIntervalTable[MEASURED_CLIENTS];
-         
+        JackTimingTopology fTopologyTable[TOPOLOGY_POINTS];
+
         unsigned int fAudioCycle;
         unsigned int fMeasuredClient;
-        
+        unsigned int fCycle;
+        unsigned int fTopologyCount;
+
         bool CheckClient(const char* name, int cur_point);
+        bool CheckTopology(JackClientInterface** table, JackGraphManager* manager);
+        void SaveTrace(const char* name);
         
     public:
     
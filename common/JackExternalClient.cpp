@@ -37,10 +37,42 @@ int JackExternalClient::ClientNotify(int refnum, const char* name, int notify, i
 {
     int result = -1;
     jack_log("JackExternalClient::ClientNotify ref = %ld client = %s name = %s notify = %ld", refnum, fClientControl->fName, name, notify);
+
+    // Asynchronous notifications without payload are queued in the shared memory ring, and delivered by batch
+    if (!sync && JackNotificationRing::IsQueued(notify)) {
+        JackNotificationRing* ring = &fClientControl->fNotificationRing;
+        if (ring->Push(notify, value1, value2, name, message)) {
+            return 0;
+        }
+        // Ring is full: wait for the client to drain it, then retry
+        jack_log("JackExternalClient::ClientNotify notification ring full client = %s", fClientControl->fName);
+        FlushNotificationsAux(true);
+        if (ring->Push(notify, value1, value2, name, message)) {
+            return 0;
+        }
+    }
+
+    // Queued notifications have to be delivered first to keep ordering
+    FlushNotificationsAux(false);
     fChannel.ClientNotify(refnum, name, notify, sync, message, value1, value2, &result);
     return result;
 }
 
+int JackExternalClient::FlushNotificationsAux(bool sync)
+{
+    JackNotificationRing* ring = &fClientControl->fNotificationRing;
+    int result = 0;
+    if (!ring->IsFlushed()) {
+        fChannel.ClientNotify(fClientControl->fRefNum, fClientControl->fName, kNotificationRing, sync, "", ring->Flush(), 0, &result);
+    }
+    return result;
+}
+
+void JackExternalClient::FlushNotifications()
+{
+    FlushNotificationsAux(false);
+}
+
 int JackExternalClient::Open(const char* name, int pid, int refnum, int uuid, int* shared_client)
 {
     try {
@@ -41,6 +41,8 @@ class JackExternalClient : public JackClientInterface
         JackNotifyChannel fChannel;           /*! Server/client communication channel */
         JackClientControl* fClientControl;    /*! Client control in shared memory     */
 
+        int FlushNotificationsAux(bool sync);
+
     public:
 
         JackExternalClient();
@@ -50,6 +52,7 @@ class JackExternalClient : public JackClientInterface
         int Close();
 
         int ClientNotify(int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2);
+        void FlushNotifications();
 
         JackClientControl* GetClientControl() const;
 };
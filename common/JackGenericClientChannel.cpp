@@ -247,6 +247,13 @@ void JackGenericClientChannel::ClientHasSessionCallback(const char* client_name,
     ServerSyncCall(&req, &res, result);
 }
 
+void JackGenericClientChannel::MetadataChange(int refnum, int action, jack_uuid_t subject, const char* key, const char* value, const char* type, int* result)
+{
+    JackMetadataRequest req(refnum, action, subject, key, value, type);
+    JackResult res;
+    ServerSyncCall(&req, &res, result);
+}
+
 void JackGenericClientChannel::ReserveClientName(int refnum, const char* client_name, const char* uuid, int* result)
 {
     JackReserveNameRequest req(refnum, client_name, uuid);
@@ -93,6 +93,9 @@ class JackGenericClientChannel : public detail::JackClientChannelInterface
         void GetClientNameForUUID(int refnum, const char* uuid, char* name_res, int* result);
         void ReserveClientName(int refnum, const char* client_name, const char *uuid, int* result);
         void ClientHasSessionCallback(const char* client_name, int* result);
+
+        // Metadata API
+        void MetadataChange(int refnum, int action, jack_uuid_t subject, const char* key, const char* value, const char* type, int* result);
 };
 
 } // end of namespace
@@ -18,6 +18,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 */
 
 #include "JackGlobals.h"
+#include "JackMessageBuffer.h"
 
 namespace Jack
 {
@@ -33,10 +34,14 @@ static bool gKeyNotificationThreadInitialized = jack_tls_allocate_key(&JackGloba
 jack_tls_key JackGlobals::fKeyLogFunction;
 static bool fKeyLogFunctionInitialized = jack_tls_allocate_key(&JackGlobals::fKeyLogFunction);
 
+jack_tls_key JackGlobals::fKeyMessageProducer;
+static bool fKeyMessageProducerInitialized = jack_tls_allocate_key(&JackGlobals::fKeyMessageProducer, JackMessageBufferReleaseProducer);
+
 JackMutex* JackGlobals::fOpenMutex = new JackMutex();
 JackMutex* JackGlobals::fSynchroMutex = new JackMutex();
 volatile bool JackGlobals::fServerRunning = false;
 JackClient* JackGlobals::fClientTable[CLIENT_NUM] = {};
+volatile bool JackGlobals::fChainRunning[CLIENT_NUM] = {};
 
 #ifndef WIN32
 jack_thread_creator_t JackGlobals::fJackThreadCreator = pthread_create;
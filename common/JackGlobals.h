@@ -40,10 +40,12 @@ struct JackGlobals {
     static jack_tls_key fRealTimeThread;
     static jack_tls_key fNotificationThread;
     static jack_tls_key fKeyLogFunction;
+    static jack_tls_key fKeyMessageProducer;
     static JackMutex* fOpenMutex;
     static JackMutex* fSynchroMutex;
     static volatile bool fServerRunning;
     static JackClient* fClientTable[CLIENT_NUM];
+    static volatile bool fChainRunning[CLIENT_NUM];     // Set while a client is executed on the thread of the previous client of a chain
     static bool fVerbose;
 #ifndef WIN32
     static jack_thread_creator_t fJackThreadCreator;
@@ -55,10 +57,15 @@ struct JackGlobals {
      static void CheckContext(const char* name);
 };
 
+class JackMetadata;
+class JackXRunRecorder;
+
 // Each "side" server and client will implement this to get the shared graph manager, engine control and inter-process synchro table.
 extern SERVER_EXPORT JackGraphManager* GetGraphManager();
 extern SERVER_EXPORT JackEngineControl* GetEngineControl();
 extern SERVER_EXPORT JackSynchro* GetSynchroTable();
+extern SERVER_EXPORT JackMetadata* GetMetadata();
+extern SERVER_EXPORT JackXRunRecorder* GetXRunRecorder();
 
 } // end of namespace
 
@@ -19,8 +19,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 */
 
 #include "JackGraphManager.h"
+#include "JackClientControl.h"
 #include "JackConstants.h"
 #include "JackError.h"
+#include "JackProbes.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <algorithm>
@@ -45,11 +47,12 @@ void JackGraphManager::AssertPort(jack_port_id_t port_index)
     }
 }
 
-JackGraphManager* JackGraphManager::Allocate(int port_max)
+JackGraphManager* JackGraphManager::Allocate(int port_max, int pipeline_slots)
 {
     // Using "Placement" new
-    void* shared_ptr = JackShmMem::operator new(sizeof(JackGraphManager) + port_max * sizeof(JackPort));
-    return new(shared_ptr) JackGraphManager(port_max);
+    void* shared_ptr = JackShmMem::operator new(sizeof(JackGraphManager) + port_max * sizeof(JackPort)
+                                                + (pipeline_slots - 1) * port_max * sizeof(JackPortBuffer));
+    return new(shared_ptr) JackGraphManager(port_max, pipeline_slots);
 }
 
 void JackGraphManager::Destroy(JackGraphManager* manager)
@@ -59,15 +62,25 @@ void JackGraphManager::Destroy(JackGraphManager* manager)
     JackShmMem::operator delete(manager);
 }
 
-JackGraphManager::JackGraphManager(int port_max)
+JackGraphManager::JackGraphManager(int port_max, int pipeline_slots)
 {
     assert(port_max <= PORT_NUM_MAX);
+    assert(pipeline_slots >= 1);
 
     for (int i = 0; i < port_max; i++) {
         fPortArray[i].Release();
     }
 
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        fClientTimingStats[i].fCounter = 0;
+        fClientTimingStats[i].Init(NULL);
+    }
+
     fPortMax = port_max;
+    fEpoch = 0;
+    fPipelineSlots = pipeline_slots;
+    fPipelineSlot = 0;
+    fBufferSize = 0;
 }
 
 JackPort* JackGraphManager::GetPort(jack_port_id_t port_index)
@@ -81,6 +94,43 @@ jack_default_audio_sample_t* JackGraphManager::GetBuffer(jack_port_id_t port_ind
     return fPortArray[port_index].GetBuffer();
 }
 
+/*
+With the pipelined execution an output port has a buffer per cycle in flight: the one written in the current cycle and those
+written in the previous cycles, still read by the next stages. They are used in turn, the port buffer being the first one.
+A client uses those of the cycle it was signaled in, so that a late client does not mix the buffers of 2 cycles, drivers always
+run in the current cycle.
+*/
+int JackGraphManager::GetPipelineSlot(JackConnectionManager* manager, int refnum)
+{
+    if (manager->IsDriverStage(refnum)) {
+        return fPipelineSlot;
+    } else {
+        return fClientTiming[refnum].fPipelineSlot;
+    }
+}
+
+jack_default_audio_sample_t* JackGraphManager::GetSlotBuffer(JackConnectionManager* manager, jack_port_id_t port_index, int refnum, int delay)
+{
+    int slot = (GetPipelineSlot(manager, refnum) + fPipelineSlots - delay) % fPipelineSlots;
+
+    if (slot == 0) {
+        return fPortArray[port_index].GetBuffer();
+    } else {
+        JackPortBuffer* buffers = (JackPortBuffer*)&fPortArray[fPortMax];
+        return buffers[(slot - 1) * fPortMax + port_index].GetBuffer();
+    }
+}
+
+void JackGraphManager::ClearSlotBuffers(jack_port_id_t port_index, jack_nframes_t buffer_size)
+{
+    JackPortBuffer* buffers = (JackPortBuffer*)&fPortArray[fPortMax];
+    JackPort* port = GetPort(port_index);
+
+    for (int slot = 1; slot < fPipelineSlots; slot++) {
+        port->ClearBuffer(buffers[(slot - 1) * fPortMax + port_index].GetBuffer(), buffer_size);
+    }
+}
+
 // Server
 void JackGraphManager::InitRefNum(int refnum)
 {
@@ -89,6 +139,22 @@ void JackGraphManager::InitRefNum(int refnum)
     WriteNextStateStop();
 }
 
+// Server
+void JackGraphManager::SetStages(const int* stages, int stage_count, int sink_delay)
+{
+    JackConnectionManager* manager = WriteNextStateStart();
+    manager->SetStages(stages, stage_count, sink_delay);
+    WriteNextStateStop();
+}
+
+// RT, at the beginning of a cycle of the master driver, before it writes its outputs
+void JackGraphManager::NextPipelineSlot()
+{
+    if (fPipelineSlots > 1) {
+        fPipelineSlot = (fPipelineSlot + 1) % fPipelineSlots;
+    }
+}
+
 // RT
 void JackGraphManager::RunCurrentGraph()
 {
@@ -113,10 +179,13 @@ bool JackGraphManager::IsFinishedGraph()
 }
 
 // RT
-int JackGraphManager::ResumeRefNum(JackClientControl* control, JackSynchro* table)
+int JackGraphManager::ResumeRefNum(JackClientControl* control, JackSynchro* table, int chained)
 {
     JackConnectionManager* manager = ReadCurrentState();
-    return manager->ResumeRefNum(control, table, fClientTiming);
+    int res = manager->ResumeRefNum(control, table, fClientTiming, GetPipelineSlot(manager, control->fRefNum), chained);
+    // Done once the next clients are signaled, not to delay them
+    fClientTimingStats[control->fRefNum].Add(&fClientTiming[control->fRefNum]);
+    return res;
 }
 
 // RT
@@ -126,6 +195,31 @@ int JackGraphManager::SuspendRefNum(JackClientControl* control, JackSynchro* tab
     return manager->SuspendRefNum(control, table, fClientTiming, usec);
 }
 
+// RT
+int JackGraphManager::GetChainedRefNum(int refnum)
+{
+    JackConnectionManager* manager = ReadCurrentState();
+    return manager->GetChainedRefNum(refnum);
+}
+
+// RT
+void JackGraphManager::AwakeRefNum(JackClientControl* control)
+{
+    JackConnectionManager::AwakeRefNum(control->fRefNum, fClientTiming);
+}
+
+// Client
+int JackGraphManager::GetClientTimingStats(const char* name, jack_client_timing_stats_t* stats)
+{
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        if (fClientTimingStats[i].Match(name)) {
+            fClientTimingStats[i].GetStats(stats);
+            return 0;
+        }
+    }
+    return -1;
+}
+
 void JackGraphManager::TopologicalSort(std::vector<jack_int_t>& sorted)
 {
     UInt16 cur_index;
@@ -183,7 +277,7 @@ void* JackGraphManager::GetBuffer(jack_port_id_t port_index, jack_nframes_t buff
 
     // Output port
     if (port->fFlags & JackPortIsOutput) {
-        return (port->fTied != NO_PORT) ? GetBuffer(port->fTied, buffer_size) : GetBuffer(port_index);
+        return (port->fTied != NO_PORT) ? GetBuffer(port->fTied, buffer_size) : GetSlotBuffer(manager, port_index, port->GetRefNum(), 0);
     }
 
     // No connections : return a zero-filled buffer
@@ -198,12 +292,12 @@ void* JackGraphManager::GetBuffer(jack_port_id_t port_index, jack_nframes_t buff
         // Ports in same client : copy the buffer
         if (GetPort(src_index)->GetRefNum() == port->GetRefNum()) {
             void* buffers[1];
-            buffers[0] = GetBuffer(src_index, buffer_size);
+            buffers[0] = GetSourceBuffer(manager, src_index, port, buffer_size);
             port->MixBuffers(buffers, 1, buffer_size);
             return port->GetBuffer();
         // Otherwise, use zero-copy mode, just pass the buffer of the connected (output) port.
         } else {
-            return GetBuffer(src_index, buffer_size);
+            return GetSourceBuffer(manager, src_index, port, buffer_size);
         }
 
     // Multiple connections : mix all buffers
@@ -216,14 +310,28 @@ void* JackGraphManager::GetBuffer(jack_port_id_t port_index, jack_nframes_t buff
 
         for (i = 0; (i < CONNECTION_NUM_FOR_PORT) && ((src_index = connections[i]) != EMPTY); i++) {
             AssertPort(src_index);
-            buffers[i] = GetBuffer(src_index, buffer_size);
+            buffers[i] = GetSourceBuffer(manager, src_index, port, buffer_size);
         }
 
+        JACK_PROBE2(port_mixdown, port_index, i);
         port->MixBuffers(buffers, i, buffer_size);
         return port->GetBuffer();
     }
 }
 
+// RT, the buffer of a connected output port as written the number of cycles before given by the pipeline
+void* JackGraphManager::GetSourceBuffer(JackConnectionManager* manager, jack_port_id_t src_index, JackPort* dst_port, jack_nframes_t buffer_size)
+{
+    JackPort* src_port = GetPort(src_index);
+
+    if (fPipelineSlots == 1 || !src_port->IsUsed() || src_port->fTied != NO_PORT) {
+        return GetBuffer(src_index, buffer_size);
+    } else {
+        int refnum = dst_port->GetRefNum();
+        return GetSlotBuffer(manager, src_index, refnum, manager->GetDelay(src_port->GetRefNum(), refnum));
+    }
+}
+
 // Server
 int JackGraphManager::RequestMonitor(jack_port_id_t port_index, bool onoff) // Client
 {
@@ -270,6 +378,7 @@ jack_nframes_t JackGraphManager::ComputeTotalLatencyAux(jack_port_id_t port_inde
             jack_nframes_t this_latency = (dst_port->fFlags & JackPortIsTerminal)
                                           ? dst_port->GetLatency()
                                           : ComputeTotalLatencyAux(dst_index, port_index, manager, hop_count + 1);
+            this_latency += GetPipelineLatency(manager, port_index, dst_index);
             max_latency = ((max_latency > this_latency) ? max_latency : this_latency);
         }
     }
@@ -277,6 +386,15 @@ jack_nframes_t JackGraphManager::ComputeTotalLatencyAux(jack_port_id_t port_inde
     return max_latency + GetPort(port_index)->GetLatency();
 }
 
+// Client, latency added by the pipeline on the connection of the 2 ports
+jack_nframes_t JackGraphManager::GetPipelineLatency(JackConnectionManager* manager, jack_port_id_t port_index, jack_port_id_t other_index)
+{
+    int ref1 = GetPort(port_index)->GetRefNum();
+    int ref2 = GetPort(other_index)->GetRefNum();
+    int delay = (GetPort(port_index)->fFlags & JackPortIsOutput) ? manager->GetLatencyDelay(ref1, ref2) : manager->GetLatencyDelay(ref2, ref1);
+    return delay * fBufferSize;
+}
+
 // Client
 int JackGraphManager::ComputeTotalLatency(jack_port_id_t port_index)
 {
@@ -285,12 +403,19 @@ int JackGraphManager::ComputeTotalLatency(jack_port_id_t port_index)
     JackPort* port = GetPort(port_index);
     AssertPort(port_index);
 
+    jack_nframes_t total_latency;
+
     do {
         cur_index = GetCurrentIndex();
-        port->fTotalLatency = ComputeTotalLatencyAux(port_index, port_index, ReadCurrentState(), 0);
+        total_latency = ComputeTotalLatencyAux(port_index, port_index, ReadCurrentState(), 0);
         next_index = GetCurrentIndex();
     } while (cur_index != next_index); // Until a coherent state has been read
 
+    if (port->fTotalLatency != total_latency) {
+        port->fTotalLatency = total_latency;
+        IncEpoch();
+    }
+
     jack_log("JackGraphManager::GetTotalLatency port_index = %ld total latency = %ld", port_index, port->fTotalLatency);
     return 0;
 }
@@ -309,7 +434,8 @@ int JackGraphManager::ComputeTotalLatencies()
 
 void JackGraphManager::RecalculateLatencyAux(jack_port_id_t port_index, jack_latency_callback_mode_t mode)
 {
-    const jack_int_t* connections = ReadCurrentState()->GetConnections(port_index);
+    JackConnectionManager* manager = ReadCurrentState();
+    const jack_int_t* connections = manager->GetConnections(port_index);
     JackPort* port = GetPort(port_index);
     jack_latency_range_t latency = { UINT32_MAX, 0 };
     jack_port_id_t dst_index;
@@ -320,6 +446,9 @@ void JackGraphManager::RecalculateLatencyAux(jack_port_id_t port_index, jack_lat
         jack_latency_range_t other_latency;
 
         dst_port->GetLatencyRange(mode, &other_latency);
+        jack_nframes_t pipeline_latency = GetPipelineLatency(manager, port_index, dst_index);
+        other_latency.min += pipeline_latency;
+        other_latency.max += pipeline_latency;
 
         if (other_latency.max > latency.max)
 			latency.max = other_latency.max;
@@ -330,7 +459,12 @@ void JackGraphManager::RecalculateLatencyAux(jack_port_id_t port_index, jack_lat
     if (latency.min == UINT32_MAX)
 		latency.min = 0;
 
-	port->SetLatencyRange(mode, &latency);
+    jack_latency_range_t cur_latency;
+    port->GetLatencyRange(mode, &cur_latency);
+    if (cur_latency.min != latency.min || cur_latency.max != latency.max) {
+        port->SetLatencyRange(mode, &latency);
+        IncEpoch();
+    }
 }
 
 void JackGraphManager::RecalculateLatency(jack_port_id_t port_index, jack_latency_callback_mode_t mode)
@@ -355,9 +489,12 @@ void JackGraphManager::SetBufferSize(jack_nframes_t buffer_size)
     jack_port_id_t port_index;
     for (port_index = FIRST_AVAILABLE_PORT; port_index < fPortMax; port_index++) {
         JackPort* port = GetPort(port_index);
-        if (port->IsUsed())
+        if (port->IsUsed()) {
             port->ClearBuffer(buffer_size);
+            ClearSlotBuffers(port_index, buffer_size);
+        }
     }
+    fBufferSize = buffer_size;
 }
 
 // Server
@@ -389,6 +526,7 @@ jack_port_id_t JackGraphManager::AllocatePort(int refnum, const char* port_name,
         JackPort* port = GetPort(port_index);
         assert(port);
         port->ClearBuffer(buffer_size);
+        ClearSlotBuffers(port_index, buffer_size);
 
         int res;
         if (flags & JackPortIsOutput) {
@@ -403,6 +541,7 @@ jack_port_id_t JackGraphManager::AllocatePort(int refnum, const char* port_name,
         }
     }
 
+    IncEpoch();
     WriteNextStateStop();
     return port_index;
 }
@@ -423,6 +562,7 @@ int JackGraphManager::ReleasePort(int refnum, jack_port_id_t port_index)
     }
 
     port->Release();
+    IncEpoch();
     WriteNextStateStop();
     return res;
 }
@@ -641,6 +781,8 @@ int JackGraphManager::Connect(jack_port_id_t port_src, jack_port_id_t port_dst)
         manager->IncDirectConnection(port_src, port_dst);
     }
 
+    IncEpoch();
+
 end:
     WriteNextStateStop();
     return res;
@@ -687,6 +829,8 @@ int JackGraphManager::Disconnect(jack_port_id_t port_src, jack_port_id_t port_ds
         manager->DecDirectConnection(port_src, port_dst);
     }
 
+    IncEpoch();
+
 end:
     WriteNextStateStop();
     return res;
@@ -881,6 +1025,205 @@ const char** JackGraphManager::GetPorts(const char* port_name_pattern, const cha
     }
 }
 
+// Client
+void JackGraphManager::CountSnapshotAux(JackConnectionManager* manager, jack_graph_snapshot_t* counts, size_t* strings_size)
+{
+    counts->client_count = 0;
+    counts->port_count = 0;
+    counts->connection_count = 0;
+    *strings_size = 0;
+
+    for (int refnum = 0; refnum < CLIENT_NUM; refnum++) {
+        const jack_int_t* port_lists[2] = { manager->GetInputPorts(refnum), manager->GetOutputPorts(refnum) };
+        char name[JACK_CLIENT_NAME_SIZE + 1];
+        GetClientName(refnum, name, sizeof(name));
+        bool has_client = (name[0] != 0);
+        if (has_client) {
+            *strings_size += strlen(name) + 1;
+        }
+        for (int j = 0; j < 2; j++) {
+            jack_int_t port_index;
+            for (int i = 0; (i < PORT_NUM_FOR_CLIENT) && ((port_index = port_lists[j][i]) != EMPTY); i++) {
+                JackPort* port = GetPort(port_index);
+                counts->port_count++;
+                counts->connection_count += manager->Connections(port_index);
+                *strings_size += strlen(port->fName) + strlen(port->GetType()) + strlen(port->fAlias1) + strlen(port->fAlias2) + 4;
+                if (!has_client) {
+                    // Client being closed: its name is the port name prefix
+                    *strings_size += strlen(port->fName) + 1;
+                    has_client = true;
+                }
+            }
+        }
+        if (has_client) {
+            counts->client_count++;
+        }
+    }
+}
+
+// Client
+bool JackGraphManager::GetSnapshotAux(JackConnectionManager* manager, jack_graph_snapshot_t* snapshot, size_t size, jack_int_t* port_map)
+{
+    char* strings = (char*)&snapshot->connections[snapshot->connection_count];
+    char* strings_end = (char*)snapshot + size;
+    uint32_t client_count = 0;
+    uint32_t port_count = 0;
+    uint32_t connection_count = 0;
+
+    #define SNAPSHOT_STRING(dst, src)                         \
+    {                                                         \
+        size_t len = strlen(src) + 1;                         \
+        if (strings + len > strings_end) return false;        \
+        memcpy(strings, src, len);                            \
+        dst = strings;                                        \
+        strings += len;                                       \
+    }
+
+    // Clients and ports, ports of a given client are stored contiguously
+    for (int refnum = 0; refnum < CLIENT_NUM; refnum++) {
+        const jack_int_t* port_lists[2] = { manager->GetInputPorts(refnum), manager->GetOutputPorts(refnum) };
+        jack_graph_client_t* client = NULL;
+        char name[JACK_CLIENT_NAME_SIZE + 1];
+        GetClientName(refnum, name, sizeof(name));
+        if (name[0] != 0) {
+            // Clients without any port are also part of the snapshot
+            if (client_count == snapshot->client_count) {
+                return false;
+            }
+            client = &snapshot->clients[client_count++];
+            SNAPSHOT_STRING(client->name, name);
+            client->first_port = port_count;
+            client->port_count = 0;
+        }
+        for (int j = 0; j < 2; j++) {
+            jack_int_t port_index;
+            for (int i = 0; (i < PORT_NUM_FOR_CLIENT) && ((port_index = port_lists[j][i]) != EMPTY); i++) {
+                JackPort* port = GetPort(port_index);
+                if (!client) {
+                    if (client_count == snapshot->client_count) {
+                        return false;
+                    }
+                    client = &snapshot->clients[client_count++];
+                    SNAPSHOT_STRING(client->name, port->fName);
+                    char* sep = strchr((char*)client->name, ':');
+                    if (sep) {
+                        *sep = 0;
+                    }
+                    client->first_port = port_count;
+                    client->port_count = 0;
+                }
+                if (port_count == snapshot->port_count) {
+                    return false;
+                }
+                port_map[port_index] = port_count;
+                jack_graph_port_t* dst = &snapshot->ports[port_count++];
+                client->port_count++;
+                dst->id = port_index;
+                dst->client = client_count - 1;
+                dst->flags = port->fFlags;
+                SNAPSHOT_STRING(dst->name, port->fName);
+                SNAPSHOT_STRING(dst->type, port->GetType());
+                SNAPSHOT_STRING(dst->aliases[0], port->fAlias1);
+                SNAPSHOT_STRING(dst->aliases[1], port->fAlias2);
+                if (port->fAlias1[0] == 0) {
+                    dst->aliases[0] = NULL;
+                }
+                if (port->fAlias2[0] == 0) {
+                    dst->aliases[1] = NULL;
+                }
+                port->GetLatencyRange(JackCaptureLatency, &dst->capture_latency);
+                port->GetLatencyRange(JackPlaybackLatency, &dst->playback_latency);
+                dst->total_latency = port->GetTotalLatency();
+            }
+        }
+    }
+
+    #undef SNAPSHOT_STRING
+
+    // Then connections, as indexes in the ports array
+    for (uint32_t i = 0; i < port_count; i++) {
+        jack_graph_port_t* port = &snapshot->ports[i];
+        const jack_int_t* connections = manager->GetConnections(port->id);
+        jack_int_t index;
+        port->first_connection = connection_count;
+        port->connection_count = 0;
+        for (int j = 0; (j < CONNECTION_NUM_FOR_PORT) && ((index = connections[j]) != EMPTY); j++) {
+            if (connection_count == snapshot->connection_count || port_map[index] == EMPTY) {
+                return false;
+            }
+            snapshot->connections[connection_count++] = port_map[index];
+            port->connection_count++;
+        }
+    }
+
+    return (client_count == snapshot->client_count
+            && port_count == snapshot->port_count
+            && connection_count == snapshot->connection_count);
+}
+
+/*
+	The snapshot is computed in two steps (count, then fill) in a single coherent read loop:
+	the graph epoch is also checked, since port names, aliases and latencies are changed
+	without any connection manager state switch.
+*/
+
+// Client
+jack_graph_snapshot_t* JackGraphManager::GetSnapshot()
+{
+    jack_int_t* port_map = (jack_int_t*)malloc(sizeof(jack_int_t) * fPortMax);
+    jack_graph_snapshot_t* snapshot = NULL;
+    UInt16 cur_index, next_index;
+    UInt32 epoch;
+    bool complete;
+
+    if (!port_map)
+        return NULL;
+
+    do {
+        free(snapshot);
+        for (unsigned int i = 0; i < fPortMax; i++) {
+            port_map[i] = EMPTY;
+        }
+
+        epoch = GetEpoch();
+        cur_index = GetCurrentIndex();
+        JackConnectionManager* manager = ReadCurrentState();
+
+        jack_graph_snapshot_t counts;
+        size_t strings_size;
+        CountSnapshotAux(manager, &counts, &strings_size);
+
+        size_t size = sizeof(jack_graph_snapshot_t)
+                    + counts.client_count * sizeof(jack_graph_client_t)
+                    + counts.port_count * sizeof(jack_graph_port_t)
+                    + counts.connection_count * sizeof(uint32_t)
+                    + strings_size;
+
+        snapshot = (jack_graph_snapshot_t*)malloc(size);
+        if (!snapshot) {
+            free(port_map);
+            return NULL;
+        }
+
+        snapshot->version = JACK_GRAPH_SNAPSHOT_VERSION;
+        snapshot->size = size;
+        snapshot->epoch = epoch;
+        snapshot->client_count = counts.client_count;
+        snapshot->port_count = counts.port_count;
+        snapshot->connection_count = counts.connection_count;
+        snapshot->clients = (jack_graph_client_t*)(snapshot + 1);
+        snapshot->ports = (jack_graph_port_t*)(snapshot->clients + counts.client_count);
+        snapshot->connections = (uint32_t*)(snapshot->ports + counts.port_count);
+
+        complete = GetSnapshotAux(manager, snapshot, size, port_map);
+        next_index = GetCurrentIndex();
+
+    } while (!complete || cur_index != next_index || epoch != GetEpoch()); // Until a coherent state has been read
+
+    free(port_map);
+    return snapshot;
+}
+
 // Server
 void JackGraphManager::Save(JackConnectionManager* dst)
 {
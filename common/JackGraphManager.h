@@ -25,9 +25,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackPort.h"
 #include "JackConstants.h"
 #include "JackConnectionManager.h"
+#include "JackTimingStats.h"
 #include "JackAtomicState.h"
 #include "JackPlatformPlug.h"
 #include "JackSystemDeps.h"
+#include "graph.h"
 
 namespace Jack
 {
@@ -43,21 +45,34 @@ class SERVER_EXPORT JackGraphManager : public JackShmMem, public JackAtomicState
     private:
 
         unsigned int fPortMax;
-        JackClientTiming fClientTiming[CLIENT_NUM];
+        volatile SInt32 fEpoch;    // Incremented on each visible change of ports or connections
+        int fPipelineSlots;        // Buffers of an output port, 1 when the graph is not pipelined
+        volatile int fPipelineSlot;    // Buffers written in the current cycle by the drivers
+        jack_nframes_t fBufferSize;
+        MEM_ALIGN(JackClientTiming fClientTiming[CLIENT_NUM], CACHE_LINE_SIZE);
+        MEM_ALIGN(JackClientTimingStats fClientTimingStats[CLIENT_NUM], CACHE_LINE_SIZE);
         JackPort fPortArray[0];    // The actual size depends of port_max, it will be dynamically computed and allocated using "placement" new
+                                   // and is followed by the (fPipelineSlots - 1) * port_max buffers of the previous cycles
 
         void AssertPort(jack_port_id_t port_index);
         jack_port_id_t AllocatePortAux(int refnum, const char* port_name, const char* port_type, JackPortFlags flags);
         void GetConnectionsAux(JackConnectionManager* manager, const char** res, jack_port_id_t port_index);
         void GetPortsAux(const char** matching_ports, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags);
         jack_default_audio_sample_t* GetBuffer(jack_port_id_t port_index);
+        int GetPipelineSlot(JackConnectionManager* manager, int refnum);
+        jack_default_audio_sample_t* GetSlotBuffer(JackConnectionManager* manager, jack_port_id_t port_index, int refnum, int delay);
+        void* GetSourceBuffer(JackConnectionManager* manager, jack_port_id_t src_index, JackPort* dst_port, jack_nframes_t frames);
+        void ClearSlotBuffers(jack_port_id_t port_index, jack_nframes_t frames);
         void* GetBufferAux(JackConnectionManager* manager, jack_port_id_t port_index, jack_nframes_t frames);
         jack_nframes_t ComputeTotalLatencyAux(jack_port_id_t port_index, jack_port_id_t src_port_index, JackConnectionManager* manager, int hop_count);
         void RecalculateLatencyAux(jack_port_id_t port_index, jack_latency_callback_mode_t mode);
+        jack_nframes_t GetPipelineLatency(JackConnectionManager* manager, jack_port_id_t port_index, jack_port_id_t other_index);
+        void CountSnapshotAux(JackConnectionManager* manager, jack_graph_snapshot_t* counts, size_t* strings_size);
+        bool GetSnapshotAux(JackConnectionManager* manager, jack_graph_snapshot_t* snapshot, size_t size, jack_int_t* port_map);
 
     public:
 
-        JackGraphManager(int port_max);
+        JackGraphManager(int port_max, int pipeline_slots);
         ~JackGraphManager()
         {}
 
@@ -80,6 +95,19 @@ class SERVER_EXPORT JackGraphManager : public JackShmMem, public JackAtomicState
 
         int RequestMonitor(jack_port_id_t port_index, bool onoff);
 
+        // Server, client
+        void IncEpoch()
+        {
+            INC_ATOMIC(&fEpoch);
+        }
+
+        UInt32 GetEpoch() const
+        {
+            return UInt32(fEpoch);
+        }
+
+        jack_graph_snapshot_t* GetSnapshot();
+
         // Connections management
         int Connect(jack_port_id_t src_index, jack_port_id_t dst_index);
         int Disconnect(jack_port_id_t src_index, jack_port_id_t dst_index);
@@ -116,14 +144,20 @@ class SERVER_EXPORT JackGraphManager : public JackShmMem, public JackAtomicState
         // Buffer management
         void* GetBuffer(jack_port_id_t port_index, jack_nframes_t frames);
 
+        // Pipeline management
+        void SetStages(const int* stages, int stage_count, int sink_delay);
+        void NextPipelineSlot();
+
         // Activation management
         void RunCurrentGraph();
         bool RunNextGraph();
         bool IsFinishedGraph();
 
         void InitRefNum(int refnum);
-        int ResumeRefNum(JackClientControl* control, JackSynchro* table);
+        int ResumeRefNum(JackClientControl* control, JackSynchro* table, int chained = EMPTY);
         int SuspendRefNum(JackClientControl* control, JackSynchro* table, long usecs);
+        int GetChainedRefNum(int refnum);
+        void AwakeRefNum(JackClientControl* control);
         void TopologicalSort(std::vector<jack_int_t>& sorted);
 
         JackClientTiming* GetClientTiming(int refnum)
@@ -131,10 +165,29 @@ class SERVER_EXPORT JackGraphManager : public JackShmMem, public JackAtomicState
             return &fClientTiming[refnum];
         }
 
+        // The timing stats entries also hold the name of every opened client, used by snapshots
+        void InitClientTimingStats(int refnum, const char* name)
+        {
+            fClientTimingStats[refnum].Init(name);
+            IncEpoch();
+        }
+
+        void GetClientName(int refnum, char* name, size_t size)
+        {
+            fClientTimingStats[refnum].GetName(name, size);
+        }
+
+        JackClientTimingStats* GetClientTimingStats(int refnum)
+        {
+            return &fClientTimingStats[refnum];
+        }
+
+        int GetClientTimingStats(const char* name, jack_client_timing_stats_t* stats);
+
         void Save(JackConnectionManager* dst);
         void Restore(JackConnectionManager* src);
 
-        static JackGraphManager* Allocate(int port_max);
+        static JackGraphManager* Allocate(int port_max, int pipeline_slots);
         static void Destroy(JackGraphManager* manager);
 
 } POST_PACKED_STRUCTURE;
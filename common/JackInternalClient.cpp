@@ -53,9 +53,21 @@ SERVER_EXPORT JackSynchro* GetSynchroTable()
     return JackServerGlobals::fInstance->GetSynchroTable();
 }
 
+SERVER_EXPORT JackMetadata* GetMetadata()
+{
+    JackMetadata* metadata = JackServerGlobals::fInstance->GetEngine()->GetMetadata();
+    return (metadata->IsOpened() ? metadata : NULL);
+}
+
+SERVER_EXPORT JackXRunRecorder* GetXRunRecorder()
+{
+    return JackServerGlobals::fInstance->GetEngine()->GetXRunRecorder();
+}
+
 JackInternalClient::JackInternalClient(JackServer* server, JackSynchro* table): JackClient(table)
 {
     fChannel = new JackInternalClientChannel(server);
+    fChainable = true;
 }
 
 JackInternalClient::~JackInternalClient()
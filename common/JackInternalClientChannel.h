@@ -176,6 +176,11 @@ class JackInternalClientChannel : public detail::JackClientChannelInterface
             *result = fEngine->ClientHasSessionCallback(client_name);
         }
 
+        void MetadataChange(int refnum, int action, jack_uuid_t subject, const char* key, const char* value, const char* type, int* result)
+        {
+            *result = fEngine->MetadataChange(refnum, action, subject, key, value, type);
+        }
+
 
 };
 
@@ -51,6 +51,46 @@ JackSynchro* GetSynchroTable()
     return (JackLibGlobals::fGlobals ? JackLibGlobals::fGlobals->fSynchroTable : 0);
 }
 
+JackMetadata* GetMetadata()
+{
+    JackLibGlobals* globals = JackLibGlobals::fGlobals;
+    if (!globals) {
+        return NULL;
+    }
+    if (!globals->fMetadata.IsOpened()) {
+        JackGlobals::fOpenMutex->Lock();
+        if (!globals->fMetadata.IsOpened()) {
+            globals->fMetadata.Open(GetEngineControl()->fServerName, false);
+        }
+        JackGlobals::fOpenMutex->Unlock();
+    }
+    return (globals->fMetadata.IsOpened() ? &globals->fMetadata : NULL);
+}
+
+JackXRunRecorder* GetXRunRecorder()
+{
+    JackLibGlobals* globals = JackLibGlobals::fGlobals;
+    if (!globals) {
+        return NULL;
+    }
+    if (!globals->fXRunRecorder) {
+        JackGlobals::fOpenMutex->Lock();
+        JackEngineControl* control = GetEngineControl();
+        if (!globals->fXRunRecorder && control && control->fXRunRecorderIndex >= 0) {
+            JackShmReadWritePtr<JackXRunRecorder>* recorder = new JackShmReadWritePtr<JackXRunRecorder>();
+            try {
+                recorder->SetShmIndex(control->fXRunRecorderIndex, control->fServerName);
+                globals->fXRunRecorder = recorder;
+            } catch (std::bad_alloc&) {
+                jack_error("Cannot attach XRun recorder segment");
+                delete recorder;
+            }
+        }
+        JackGlobals::fOpenMutex->Unlock();
+    }
+    return (globals->fXRunRecorder ? globals->fXRunRecorder->GetShmAddress() : NULL);
+}
+
 //-------------------
 // Client management
 //-------------------
@@ -141,6 +181,7 @@ int JackLibClient::Open(const char* server_name, const char* name, int uuid, jac
     }
 
     JackGlobals::fClientTable[GetClientControl()->fRefNum] = this;
+    SetVirtualClock(&GetEngineControl()->fVirtualTime);
     SetClockSource(GetEngineControl()->fClockSource);
     jack_log("JackLibClient::Open name = %s refnum = %ld", name_res, GetClientControl()->fRefNum);
     return 0;
@@ -26,6 +26,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackPlatformPlug.h"
 #include "JackGraphManager.h"
 #include "JackMessageBuffer.h"
+#include "JackMetadata.h"
+#include "JackXRunRecorder.h"
 #include "JackTime.h"
 #include "JackClient.h"
 #include "JackError.h"
@@ -55,6 +57,8 @@ struct JackLibGlobals
     JackShmReadWritePtr<JackGraphManager> fGraphManager;	/*! Shared memory Port manager */
     JackShmReadWritePtr<JackEngineControl> fEngineControl;	/*! Shared engine control */  // transport engine has to be writable
     JackSynchro fSynchroTable[CLIENT_NUM];                  /*! Shared synchro table */
+    JackMetadata fMetadata;                                 /*! Metadata store, mapped read-only on first use */
+    JackShmReadWritePtr<JackXRunRecorder>* fXRunRecorder;   /*! XRun flight recorder, attached on first use */
     sigset_t fProcessSignals;
 
     static int fClientCount;
@@ -68,6 +72,7 @@ struct JackLibGlobals
         }
         fGraphManager = -1;
         fEngineControl = -1;
+        fXRunRecorder = NULL;
 
         // Filter SIGPIPE to avoid having client get a SIGPIPE when trying to access a died server.
     #ifdef WIN32
@@ -83,9 +88,14 @@ struct JackLibGlobals
     ~JackLibGlobals()
     {
         jack_log("~JackLibGlobals");
+        // The virtual clock lives in the engine control, which is released with the globals
+        SetClockSource(JACK_TIMER_SYSTEM_CLOCK);
+        SetVirtualClock(NULL);
         for (int i = 0; i < CLIENT_NUM; i++) {
             fSynchroTable[i].Disconnect();
         }
+        fMetadata.Close();
+        delete fXRunRecorder;
         JackMessageBuffer::Destroy();
 
        // Restore old signal mask
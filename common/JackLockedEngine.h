@@ -73,6 +73,11 @@ catch (...) {
 
 /*!
 \brief Locked Engine, access to methods is serialized using a mutex.
+
+Requests that change the graph or the clients take the engine mutex, those that also change the client table or the
+name reservations take the client lock for writing while they do it. Queries on the clients only read the client table
+and the client controls in shared memory: they take the client lock for reading, so that a slow client open or session
+notify does not delay them. Port and connection queries are answered by the clients from the shared graph state.
 */
 
 class SERVER_EXPORT JackLockedEngine
@@ -112,7 +117,7 @@ class SERVER_EXPORT JackLockedEngine
         int ClientCheck(const char* name, int uuid, char* name_res, int protocol, int options, int* status)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackReadLock lock(&fEngine.fClientLock);
             return fEngine.ClientCheck(name, uuid, name_res, protocol, options, status);
             CATCH_EXCEPTION_RETURN
         }
@@ -172,14 +177,14 @@ class SERVER_EXPORT JackLockedEngine
         int GetInternalClientName(int int_ref, char* name_res)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
-            return fEngine.GetInternalClientName(int_ref, name_res);
+            JackReadLock lock(&fEngine.fClientLock);
+            return (fEngine.CheckClient(int_ref)) ? fEngine.GetInternalClientName(int_ref, name_res) : -1;
             CATCH_EXCEPTION_RETURN
         }
         int InternalClientHandle(const char* client_name, int* status, int* int_ref)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackReadLock lock(&fEngine.fClientLock);
             return fEngine.InternalClientHandle(client_name, status, int_ref);
             CATCH_EXCEPTION_RETURN
         }
@@ -284,6 +289,22 @@ class SERVER_EXPORT JackLockedEngine
             CATCH_EXCEPTION
         }
 
+        int FlushPendingNotifications()
+        {
+            TRY_CALL
+            JackLock lock(&fEngine);
+            return fEngine.FlushPendingNotifications();
+            CATCH_EXCEPTION_RETURN
+        }
+
+        void FlushNotifications()
+        {
+            TRY_CALL
+            JackLock lock(&fEngine);
+            fEngine.FlushNotifications();
+            CATCH_EXCEPTION
+        }
+
         void NotifyBufferSize(jack_nframes_t buffer_size)
         {
             TRY_CALL
@@ -317,7 +338,7 @@ class SERVER_EXPORT JackLockedEngine
         int GetClientPID(const char* name)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackReadLock lock(&fEngine.fClientLock);
             return fEngine.GetClientPID(name);
             CATCH_EXCEPTION_RETURN
         }
@@ -325,7 +346,7 @@ class SERVER_EXPORT JackLockedEngine
         int GetClientRefNum(const char* name)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackReadLock lock(&fEngine.fClientLock);
             return fEngine.GetClientRefNum(name);
             CATCH_EXCEPTION_RETURN
         }
@@ -357,14 +378,14 @@ class SERVER_EXPORT JackLockedEngine
         int GetUUIDForClientName(const char *client_name, char *uuid_res)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackReadLock lock(&fEngine.fClientLock);
             return fEngine.GetUUIDForClientName(client_name, uuid_res);
             CATCH_EXCEPTION_RETURN
         }
         int GetClientNameForUUID(const char *uuid, char *name_res)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackReadLock lock(&fEngine.fClientLock);
             return fEngine.GetClientNameForUUID(uuid, name_res);
             CATCH_EXCEPTION_RETURN
         }
@@ -379,10 +400,39 @@ class SERVER_EXPORT JackLockedEngine
         int ClientHasSessionCallback(const char *name)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackReadLock lock(&fEngine.fClientLock);
             return fEngine.ClientHasSessionCallback(name);
             CATCH_EXCEPTION_RETURN
         }
+
+        // Metadata
+        int MetadataChange(int refnum, int action, jack_uuid_t subject, const char* key, const char* value, const char* type)
+        {
+            TRY_CALL
+            JackLock lock(&fEngine);
+            return fEngine.MetadataChange(refnum, action, subject, key, value, type);
+            CATCH_EXCEPTION_RETURN
+        }
+
+        JackMetadata* GetMetadata()
+        {
+            // Read only access is lock-free
+            return fEngine.GetMetadata();
+        }
+
+        JackXRunRecorder* GetXRunRecorder()
+        {
+            // Reports are read lock-free
+            return fEngine.GetXRunRecorder();
+        }
+
+        void SetCycleRecorder(JackCycleRecorder* recorder)
+        {
+            TRY_CALL
+            JackLock lock(&fEngine);
+            fEngine.SetCycleRecorder(recorder);
+            CATCH_EXCEPTION
+        }
 };
 
 } // end of namespace
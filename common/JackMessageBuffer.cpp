@@ -23,6 +23,10 @@
 #include "JackGlobals.h"
 #include "JackError.h"
 #include "JackTime.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
 
 namespace Jack
 {
@@ -38,7 +42,14 @@ JackMessageBuffer::JackMessageBuffer()
     fOutBuffer(0),
     fOverruns(0),
     fRunning(false)
-{}
+{
+    for (int i = 0; i < MB_BUFFERS; i++) {
+        fBuffers[i].sequence = i;
+    }
+    memset(fProducers, 0, sizeof(fProducers));
+    // Entry 0 is shared by threads that find the table full
+    fProducers[0].fUsed = 1;
+}
 
 JackMessageBuffer::~JackMessageBuffer()
 {}
@@ -57,12 +68,6 @@ bool JackMessageBuffer::Start()
 
 bool JackMessageBuffer::Stop()
 {
-    if (fOverruns > 0) {
-        jack_error("WARNING: %d message buffer overruns!", fOverruns);
-    } else {
-        jack_log("no message buffer overruns");
-    }
-
     if (fGuard.Lock()) {
         fRunning = false;
         fGuard.Signal();
@@ -73,35 +78,409 @@ bool JackMessageBuffer::Stop()
     }
 
     Flush();
+
+    if (fOverruns > 0) {
+        jack_error("WARNING: %d message buffer overruns!", fOverruns);
+        for (int i = 0; i < MB_PRODUCERS; i++) {
+            if (fProducers[i].fDropped > 0) {
+                jack_error("WARNING: producer %d: %d messages added, %d dropped", i, fProducers[i].fAdded, fProducers[i].fDropped);
+            }
+        }
+    } else {
+        jack_log("no message buffer overruns");
+    }
     return true;
 }
 
-void JackMessageBuffer::Flush()
+/*
+The thread keeps its entry index + 1, which stays valid if the message buffer is created again,
+and gives the entry back when it exits through the destructor of the key.
+*/
+JackMessageProducer* JackMessageBuffer::GetProducer()
 {
-    while (fOutBuffer != fInBuffer) {
-        jack_log_function(fBuffers[fOutBuffer].level, fBuffers[fOutBuffer].message);
-        fOutBuffer = MB_NEXT(fOutBuffer);
+    intptr_t entry = (intptr_t)jack_tls_get(JackGlobals::fKeyMessageProducer);
+    if (entry > 0 && entry <= MB_PRODUCERS) {
+        return &fProducers[entry - 1];
     }
+
+    // First message of this thread: claim an entry, or use the shared one
+    entry = 0;
+    for (int i = 1; i < MB_PRODUCERS; i++) {
+        if (fProducers[i].fUsed == 0 && CAS(0, 1, &fProducers[i].fUsed)) {
+            entry = i;
+            break;
+        }
+    }
+    jack_tls_set(JackGlobals::fKeyMessageProducer, (void*)(entry + 1));
+    return &fProducers[entry];
 }
 
-void JackMessageBuffer::AddMessage(int level, const char *message)
+void JackMessageBuffer::ReleaseProducer(void* entry)
+{
+    intptr_t index = (intptr_t)entry - 1;
+    // Entry 0 is shared and never released
+    if (index > 0 && index < MB_PRODUCERS) {
+        fProducers[index].fUsed = 0;
+    }
+}
+
+// Producers
+JackMessage* JackMessageBuffer::Reserve(JackMessageProducer* producer)
+{
+    while (true) {
+        UInt32 in_buffer = fInBuffer;
+        JackMessage* message = &fBuffers[in_buffer & MB_MASK];
+        UInt32 sequence = message->sequence;
+        if (sequence == in_buffer) {
+            if (CAS(in_buffer, in_buffer + 1, &fInBuffer)) {
+                INC_ATOMIC(&producer->fAdded);
+                return message;
+            }
+        } else if ((SInt32)(sequence - in_buffer) < 0) {
+            // Slot not consumed yet: queue is full
+            INC_ATOMIC(&producer->fDropped);
+            INC_ATOMIC(&fOverruns);
+            return NULL;
+        }
+        // Otherwise another producer claimed the slot, try again
+    }
+}
+
+// Producers
+void JackMessageBuffer::Publish(JackMessage* message)
+{
+    // CAS acts as a full barrier: the message content is visible before the sequence
+    UInt32 sequence = message->sequence;
+    CAS(sequence, sequence + 1, &message->sequence);
+    Wakeup();
+}
+
+void JackMessageBuffer::Wakeup()
 {
+    /*
+    The message buffer thread checks for pending messages with the lock taken before waiting,
+    so a failed Trylock only loses the wakeup if the message was published between that check
+    and the wait: the message is then delivered when the wait times out.
+    */
     if (fGuard.Trylock()) {
-        fBuffers[fInBuffer].level = level;
-        strncpy(fBuffers[fInBuffer].message, message, MB_BUFFERSIZE);
-        fInBuffer = MB_NEXT(fInBuffer);
         fGuard.Signal();
         fGuard.Unlock();
-    } else {            /* lock collision */
-        INC_ATOMIC(&fOverruns);
     }
 }
 
+void JackMessageBuffer::Flush()
+{
+    char buffer[MB_BUFFERSIZE];
+
+    while (true) {
+        JackMessage* message = &fBuffers[fOutBuffer & MB_MASK];
+        UInt32 sequence = message->sequence;
+        if (sequence != fOutBuffer + 1) {
+            break;
+        }
+        // CAS acts as a full barrier: the message content is read after the sequence
+        CAS(sequence, sequence, &message->sequence);
+        if (message->arg_count < 0) {
+            jack_log_function(message->level, message->message);
+        } else {
+            FormatRecord(message, buffer, sizeof(buffer));
+            jack_log_function(message->level, buffer);
+        }
+        // Give the slot back to producers for the next round
+        CAS(sequence, fOutBuffer + MB_BUFFERS, &message->sequence);
+        fOutBuffer++;
+    }
+
+    ReportOverruns();
+}
+
+void JackMessageBuffer::ReportOverruns()
+{
+    for (int i = 0; i < MB_PRODUCERS; i++) {
+        SInt32 dropped = fProducers[i].fDropped;
+        if (dropped != fProducers[i].fReported) {
+            char buffer[MB_BUFFERSIZE];
+            snprintf(buffer, sizeof(buffer), "JackMessageBuffer: %d messages dropped by producer %d", dropped - fProducers[i].fReported, i);
+            jack_log_function(LOG_LEVEL_ERROR, buffer);
+            fProducers[i].fReported = dropped;
+        }
+    }
+}
+
+void JackMessageBuffer::GetCounters(SInt32* added, SInt32* dropped)
+{
+    *added = 0;
+    *dropped = 0;
+    for (int i = 0; i < MB_PRODUCERS; i++) {
+        *added += fProducers[i].fAdded;
+        *dropped += fProducers[i].fDropped;
+    }
+}
+
+void JackMessageBuffer::AddMessage(int level, const char *message)
+{
+    JackMessage* slot = Reserve(GetProducer());
+    if (slot) {
+        slot->level = level;
+        slot->prefix = NULL;
+        slot->arg_count = -1;
+        strncpy(slot->message, message, MB_BUFFERSIZE);
+        slot->message[MB_BUFFERSIZE - 1] = 0;
+        Publish(slot);
+    }
+}
+
+void JackMessageBuffer::AddRecord(int level, const char* prefix, const char* fmt, va_list ap)
+{
+    JackMessage* slot = Reserve(GetProducer());
+    if (slot) {
+        va_list aq;
+        slot->level = level;
+        slot->prefix = prefix;
+        va_copy(aq, ap);
+        if (!WriteRecord(slot, fmt, aq)) {
+            // Format not supported by records: format it here
+            size_t len = 0;
+            if (prefix) {
+                len = strlen(prefix);
+                memcpy(slot->message, prefix, len);
+            }
+            vsnprintf(slot->message + len, MB_BUFFERSIZE - len, fmt, ap);
+            slot->arg_count = -1;
+        }
+        va_end(aq);
+        Publish(slot);
+    }
+}
+
+/*
+Walks a printf conversion specification starting after '%'. Returns the conversion character
+and its argument type, the number of '*' width or precision fields, and the end of the specification.
+Returns 0 for conversions that records do not support.
+*/
+static char ParseSpec(const char* spec, const char** end, int* type, int* stars)
+{
+    const char* p = spec;
+    int length = 0;     // 'H' hh, 'h', 'l', 'q' ll, 'z', 'j', 't', 'L'
+    *stars = 0;
+
+    while (*p && strchr("-+ #0'", *p)) {
+        p++;
+    }
+    if (*p == '*') {
+        (*stars)++;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            (*stars)++;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+        }
+    }
+    switch (*p) {
+        case 'h':
+            length = (p[1] == 'h') ? 'H' : 'h';
+            p += (p[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            length = (p[1] == 'l') ? 'q' : 'l';
+            p += (p[1] == 'l') ? 2 : 1;
+            break;
+        case 'q':
+        case 'z':
+        case 'j':
+        case 't':
+        case 'L':
+            length = *p++;
+            break;
+    }
+
+    *end = p + 1;
+    switch (*p) {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            switch (length) {
+                case 'l': *type = kArgLong; break;
+                case 'q': *type = kArgLongLong; break;
+                case 'z': *type = kArgSize; break;
+                case 'j': *type = kArgIntMax; break;
+                case 't': *type = kArgPtrDiff; break;
+                case 'L': return 0;
+                default: *type = kArgInt; break;
+            }
+            return (*p == 'c' && length != 0) ? 0 : *p;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            *type = kArgDouble;
+            return (length == 0 || length == 'l') ? *p : 0;
+        case 'p':
+            *type = kArgPointer;
+            return (length == 0) ? *p : 0;
+        case 's':
+            *type = kArgString;
+            return (length == 0) ? *p : 0;
+        default:
+            return 0;
+    }
+}
+
+// Producers: copy the format and the string arguments, and store the other arguments unformatted
+bool JackMessageBuffer::WriteRecord(JackMessage* message, const char* fmt, va_list ap)
+{
+    size_t len = strlen(fmt);
+    if (len >= MB_BUFFERSIZE - 1) {
+        return false;
+    }
+    memcpy(message->message, fmt, len + 1);
+    size_t offset = len + 1;
+    message->message[MB_BUFFERSIZE - 1] = 0;    // empty string for truncated arguments
+    int count = 0;
+
+    for (const char* p = fmt; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        if (p[1] == '%') {
+            p++;
+            continue;
+        }
+        const char* end;
+        int type, stars;
+        if (ParseSpec(p + 1, &end, &type, &stars) == 0 || count + stars + 1 > MB_ARGS) {
+            return false;
+        }
+        for (int i = 0; i < stars; i++) {
+            message->args[count].type = kArgInt;
+            message->args[count++].i = va_arg(ap, int);
+        }
+        JackMessageArg* arg = &message->args[count++];
+        arg->type = type;
+        switch (type) {
+            case kArgInt: arg->i = va_arg(ap, int); break;
+            case kArgLong: arg->i = va_arg(ap, long); break;
+            case kArgLongLong: arg->i = va_arg(ap, long long); break;
+            case kArgSize: arg->i = (long long)va_arg(ap, size_t); break;
+            case kArgIntMax: arg->i = (long long)va_arg(ap, intmax_t); break;
+            case kArgPtrDiff: arg->i = (long long)va_arg(ap, ptrdiff_t); break;
+            case kArgDouble: arg->d = va_arg(ap, double); break;
+            case kArgPointer: arg->p = va_arg(ap, void*); break;
+            case kArgString: {
+                const char* str = va_arg(ap, const char*);
+                size_t str_len;
+                if (str == NULL) {
+                    str = "(null)";
+                }
+                str_len = strlen(str);
+                if (offset + str_len + 1 > MB_BUFFERSIZE - 1) {
+                    // Truncate to the remaining room
+                    str_len = (offset < MB_BUFFERSIZE - 1) ? (MB_BUFFERSIZE - 2 - offset) : 0;
+                }
+                if (str_len > 0 || offset < MB_BUFFERSIZE - 1) {
+                    memcpy(&message->message[offset], str, str_len);
+                    message->message[offset + str_len] = 0;
+                    arg->i = offset;
+                    offset += str_len + 1;
+                } else {
+                    arg->i = MB_BUFFERSIZE - 1;
+                }
+                break;
+            }
+        }
+        p = end - 1;
+    }
+
+    message->arg_count = count;
+    return true;
+}
+
+// Message buffer thread: format a binary record
+void JackMessageBuffer::FormatRecord(const JackMessage* message, char* buffer, size_t size)
+{
+    size_t len = 0;
+    int count = 0;
+
+    if (message->prefix) {
+        len = snprintf(buffer, size, "%s", message->prefix);
+    }
+
+    for (const char* p = message->message; *p && len < size - 1; p++) {
+        if (*p != '%') {
+            buffer[len++] = *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            buffer[len++] = '%';
+            p++;
+            continue;
+        }
+
+        // Rebuild the specification with '*' fields replaced by their values
+        char spec[64];
+        size_t spec_len = 0;
+        const char* end;
+        int type, stars;
+        ParseSpec(p + 1, &end, &type, &stars);
+        for (const char* q = p; q < end && spec_len < sizeof(spec) - 16; q++) {
+            if (*q == '*') {
+                spec_len += snprintf(spec + spec_len, sizeof(spec) - spec_len, "%d", (int)message->args[count++].i);
+            } else {
+                spec[spec_len++] = *q;
+            }
+        }
+        spec[spec_len] = 0;
+
+        const JackMessageArg* arg = &message->args[count++];
+        int res = 0;
+        switch (arg->type) {
+            case kArgInt: res = snprintf(buffer + len, size - len, spec, (int)arg->i); break;
+            case kArgLong: res = snprintf(buffer + len, size - len, spec, (long)arg->i); break;
+            case kArgLongLong: res = snprintf(buffer + len, size - len, spec, arg->i); break;
+            case kArgSize: res = snprintf(buffer + len, size - len, spec, (size_t)arg->i); break;
+            case kArgIntMax: res = snprintf(buffer + len, size - len, spec, (intmax_t)arg->i); break;
+            case kArgPtrDiff: res = snprintf(buffer + len, size - len, spec, (ptrdiff_t)arg->i); break;
+            case kArgDouble: res = snprintf(buffer + len, size - len, spec, arg->d); break;
+            case kArgPointer: res = snprintf(buffer + len, size - len, spec, arg->p); break;
+            case kArgString: res = snprintf(buffer + len, size - len, spec, &message->message[arg->i]); break;
+        }
+        if (res > 0) {
+            len += res;
+        }
+        if (len >= size) {
+            len = size - 1;
+        }
+        p = end - 1;
+    }
+
+    buffer[len] = 0;
+}
+
 bool JackMessageBuffer::Execute()
 {
     if (fGuard.Lock()) {
         while (fRunning) {
-            fGuard.Wait();
+            if (!IsPending() && !fInit) {
+                fGuard.TimedWait(MB_WAKEUP_USECS);
+            }
             /* the client asked for all threads to run a thread
             initialization callback, which includes us.
             */
@@ -162,6 +541,23 @@ void JackMessageBufferAdd(int level, const char *message)
     }
 }
 
+void JackMessageBufferAddRecord(int level, const char* prefix, const char* fmt, va_list ap)
+{
+    if (Jack::JackMessageBuffer::fInstance == NULL) {
+        /* Unable to print message with realtime safety. Complain and print it anyway. */
+        jack_log_function(LOG_LEVEL_ERROR, "messagebuffer not initialized, skip message");
+    } else {
+        Jack::JackMessageBuffer::fInstance->AddRecord(level, prefix, fmt, ap);
+    }
+}
+
+void JackMessageBufferReleaseProducer(void* entry)
+{
+    if (Jack::JackMessageBuffer::fInstance != NULL) {
+        Jack::JackMessageBuffer::fInstance->ReleaseProducer(entry);
+    }
+}
+
 int JackMessageBuffer::SetInitCallback(JackThreadInitCallback callback, void *arg)
 {
     if (fInstance && callback && fRunning && fGuard.Lock()) {
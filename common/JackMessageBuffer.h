@@ -33,26 +33,80 @@
 #include "JackPlatformPlug.h"
 #include "JackMutex.h"
 #include "JackAtomic.h"
+#include <stdarg.h>
 
 namespace Jack
 {
 
-/* MB_NEXT() relies on the fact that MB_BUFFERS is a power of two */
+/* MB_BUFFERS must be a power of two */
 #define MB_BUFFERS  128
-#define MB_NEXT(index) ((index+1) & (MB_BUFFERS-1))
+#define MB_MASK     (MB_BUFFERS - 1)
 #define MB_BUFFERSIZE   256     /* message length limit */
+#define MB_ARGS     8           /* arguments of a binary record */
+#define MB_PRODUCERS    32      /* producer 0 accounts for threads that did not get their own entry */
+#define MB_WAKEUP_USECS 100000  /* bounds the delay of a message whose wakeup was lost */
+
+enum JackMessageArgType {
+    kArgInt = 0,
+    kArgLong,
+    kArgLongLong,
+    kArgSize,
+    kArgIntMax,
+    kArgPtrDiff,
+    kArgDouble,
+    kArgPointer,
+    kArgString      // offset of the copied string in the message buffer
+};
+
+struct JackMessageArg
+{
+    int type;
+    union {
+        long long i;
+        double d;
+        const void* p;
+    };
+};
+
+/*!
+\brief A message slot. A slot either holds a text message (arg_count < 0), or a binary record made of a copy
+of the format string followed by the copied string arguments, and of the raw argument values: formatting is then
+done by the message buffer thread, not by the RT thread that logged it.
+*/
 
 struct JackMessage
 {
+    volatile UInt32 sequence;
     int level;
+    const char* prefix;
+    int arg_count;
+    JackMessageArg args[MB_ARGS];
     char message[MB_BUFFERSIZE];
 };
 
+/*!
+\brief Messages added and dropped by a producer thread.
+*/
+
+struct JackMessageProducer
+{
+    volatile UInt32 fUsed;
+    SInt32 fAdded;
+    SInt32 fDropped;
+    SInt32 fReported;    // Message buffer thread only
+};
+
 /*!
 \brief Message buffer to be used from RT threads.
+
+This is a bounded multiple producers / single consumer queue: each slot carries a sequence number, producers
+claim a slot with a CAS on the write index and publish it by updating the slot sequence, so concurrent producers
+no longer lose messages when they collide. A message is only dropped when the queue is full, and drops are
+accounted per producer thread. Producers never block: they only signal the message buffer thread when its lock is
+free, and the thread also wakes up periodically to catch a wakeup that was missed this way.
 */
 
-class JackMessageBuffer : public JackRunnableInterface
+class SERVER_EXPORT JackMessageBuffer : public JackRunnableInterface
 {
 
     private:
@@ -60,18 +114,33 @@ class JackMessageBuffer : public JackRunnableInterface
         volatile JackThreadInitCallback fInit;
         void* fInitArg;
         JackMessage fBuffers[MB_BUFFERS];
+        JackMessageProducer fProducers[MB_PRODUCERS];
         JackThread fThread;
         JackProcessSync fGuard;
-        volatile unsigned int fInBuffer;
-        volatile unsigned int fOutBuffer;
+        volatile UInt32 fInBuffer;
+        volatile UInt32 fOutBuffer;
         SInt32 fOverruns;
         bool fRunning;
 
         void Flush();
 
+        bool IsPending()
+        {
+            return (fBuffers[fOutBuffer & MB_MASK].sequence == fOutBuffer + 1);
+        }
+        void ReportOverruns();
+
         bool Start();
         bool Stop();
 
+        JackMessageProducer* GetProducer();
+        JackMessage* Reserve(JackMessageProducer* producer);
+        void Publish(JackMessage* message);
+        void Wakeup();
+
+        static bool WriteRecord(JackMessage* message, const char* fmt, va_list ap);
+        static void FormatRecord(const JackMessage* message, char* buffer, size_t size);
+
     public:
 
         JackMessageBuffer();
@@ -84,7 +153,10 @@ class JackMessageBuffer : public JackRunnableInterface
 	    bool static Destroy();
 
         void AddMessage(int level, const char *message);
+        void AddRecord(int level, const char* prefix, const char* fmt, va_list ap);
         int SetInitCallback(JackThreadInitCallback callback, void *arg);
+        void GetCounters(SInt32* added, SInt32* dropped);
+        void ReleaseProducer(void* entry);
 
 	    static JackMessageBuffer* fInstance;
 };
@@ -95,6 +167,8 @@ extern "C"
 #endif
 
 void JackMessageBufferAdd(int level, const char *message);
+void JackMessageBufferAddRecord(int level, const char* prefix, const char* fmt, va_list ap);
+void JackMessageBufferReleaseProducer(void* entry);
 
 #ifdef __cplusplus
 }
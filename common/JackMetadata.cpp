@@ -0,0 +1,505 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackMetadata.h"
+#include "JackAtomic.h"
+#include "JackTools.h"
+#include "JackError.h"
+#include "JackTime.h"
+#include "driver_interface.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Jack
+{
+
+#define METADATA_MAGIC 0x4A4D4454   // "JMDT"
+#define METADATA_VERSION 2       // 2: removals shift the following slots back, there are no deleted slots
+
+#define SLOT_EMPTY 0
+#define SLOT_USED 1
+
+JackMetadata::JackMetadata(): fTable(NULL), fFd(-1), fWritable(false)
+{}
+
+JackMetadata::~JackMetadata()
+{
+    Close();
+}
+
+void JackMetadata::GetPath(const char* server_name, char* path)
+{
+    snprintf(path, JACK_PATH_MAX + 1, "%s/metadata-%s.db", JackTools::UserDir(), server_name);
+}
+
+#ifdef WIN32
+
+int JackMetadata::Open(const char* server_name, bool writable)
+{
+    jack_error("JackMetadata::Open metadata store is not available on this platform");
+    return -1;
+}
+
+void JackMetadata::Close()
+{}
+
+#else
+
+int JackMetadata::Open(const char* server_name, bool writable)
+{
+    char path[JACK_PATH_MAX + 1];
+    GetPath(server_name, path);
+
+    if (writable) {
+        JackTools::MkDir(JackTools::UserDir());
+    }
+
+    if ((fFd = open(path, (writable) ? (O_RDWR | O_CREAT) : O_RDONLY, 0600)) < 0) {
+        jack_error("JackMetadata::Open cannot open %s err = %s", path, strerror(errno));
+        return -1;
+    }
+
+    if (writable && ftruncate(fFd, sizeof(JackMetadataTable)) < 0) {
+        jack_error("JackMetadata::Open cannot resize %s err = %s", path, strerror(errno));
+        goto error;
+    }
+
+    fTable = (JackMetadataTable*)mmap(NULL, sizeof(JackMetadataTable), (writable) ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fFd, 0);
+    if (fTable == MAP_FAILED) {
+        jack_error("JackMetadata::Open cannot map %s err = %s", path, strerror(errno));
+        fTable = NULL;
+        goto error;
+    }
+
+    fWritable = writable;
+
+    if (fTable->fMagic != METADATA_MAGIC || fTable->fVersion != METADATA_VERSION) {
+        if (!writable) {
+            jack_error("JackMetadata::Open %s is not a valid metadata store", path);
+            Close();
+            return -1;
+        }
+        jack_log("JackMetadata::Open initialize %s", path);
+        memset(fTable, 0, sizeof(JackMetadataTable));
+        fTable->fMagic = METADATA_MAGIC;
+        fTable->fVersion = METADATA_VERSION;
+    } else if (writable) {
+        // Restore a coherent counter in case the previous server died while writing
+        fTable->fCounter &= ~1;
+    }
+
+    jack_log("JackMetadata::Open path = %s writable = %d count = %ld", path, writable, fTable->fCount);
+    return 0;
+
+error:
+    close(fFd);
+    fFd = -1;
+    return -1;
+}
+
+void JackMetadata::Close()
+{
+    if (fTable) {
+        if (fWritable) {
+            msync(fTable, sizeof(JackMetadataTable), MS_SYNC);
+        }
+        munmap(fTable, sizeof(JackMetadataTable));
+        fTable = NULL;
+    }
+    if (fFd >= 0) {
+        close(fFd);
+        fFd = -1;
+    }
+}
+
+#endif
+
+UInt32 JackMetadata::Hash(jack_uuid_t subject, const char* key)
+{
+    // FNV-1a
+    UInt32 hash = 2166136261U;
+    for (unsigned int i = 0; i < sizeof(jack_uuid_t); i++) {
+        hash = (hash ^ ((subject >> (i * 8)) & 0xFF)) * 16777619U;
+    }
+    for (const char* c = key; *c; c++) {
+        hash = (hash ^ (unsigned char)*c) * 16777619U;
+    }
+    return hash;
+}
+
+int JackMetadata::Find(jack_uuid_t subject, const char* key) const
+{
+    UInt32 hash = Hash(subject, key);
+    for (UInt32 i = 0; i < METADATA_SLOTS; i++) {
+        JackMetadataSlot* slot = &fTable->fSlots[(hash + i) & (METADATA_SLOTS - 1)];
+        if (slot->fState == SLOT_EMPTY) {
+            return -1;
+        } else if (slot->fSubject == subject && strncmp(slot->fKey, key, METADATA_KEY_SIZE) == 0) {
+            return (hash + i) & (METADATA_SLOTS - 1);
+        }
+    }
+    return -1;
+}
+
+/*!
+\brief Removes a slot without leaving a deleted marker, called between WriteStart and WriteStop.
+
+Slots of the following probe sequence that could be found from the freed slot are moved back into it, until an empty
+slot is reached, so that a lookup still stops at the first empty slot and misses do not probe the whole table after churn.
+*/
+void JackMetadata::Clear(int index)
+{
+    UInt32 hole = index;
+    for (UInt32 i = 1; i < METADATA_SLOTS; i++) {
+        UInt32 next = (index + i) & (METADATA_SLOTS - 1);
+        JackMetadataSlot* slot = &fTable->fSlots[next];
+        if (slot->fState == SLOT_EMPTY) {
+            break;
+        }
+        // The slot stays when its home lies cyclically in (hole, next]
+        UInt32 home = Hash(slot->fSubject, slot->fKey) & (METADATA_SLOTS - 1);
+        bool stays = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!stays) {
+            memcpy(&fTable->fSlots[hole], slot, sizeof(JackMetadataSlot));
+            hole = next;
+        }
+    }
+    fTable->fSlots[hole].fState = SLOT_EMPTY;
+    fTable->fCount--;
+}
+
+void JackMetadata::WriteStart()
+{
+    UInt32 counter = fTable->fCounter;
+    CAS(counter, counter + 1, &fTable->fCounter);
+}
+
+void JackMetadata::WriteStop()
+{
+    UInt32 counter = fTable->fCounter;
+    CAS(counter, counter + 1, &fTable->fCounter);
+}
+
+UInt32 JackMetadata::ReadStart() const
+{
+    UInt32 counter;
+    while ((counter = fTable->fCounter) & 1) {
+        JackSleep(10);
+    }
+    return counter;
+}
+
+bool JackMetadata::ReadRetry(UInt32 counter) const
+{
+    return (fTable->fCounter != counter);
+}
+
+// Server
+int JackMetadata::SetProperty(jack_uuid_t subject, const char* key, const char* value, const char* type, jack_property_change_t* change)
+{
+    if (!fWritable || !key || !key[0] || !value) {
+        return -1;
+    }
+    if (strlen(key) >= METADATA_KEY_SIZE || strlen(value) >= METADATA_VALUE_SIZE || (type && strlen(type) >= METADATA_TYPE_SIZE)) {
+        jack_error("JackMetadata::SetProperty property too large key = %s", key);
+        return -1;
+    }
+
+    int index = Find(subject, key);
+    *change = PropertyChanged;
+
+    if (index < 0) {
+        // Look for the first empty slot in the probe sequence
+        UInt32 hash = Hash(subject, key);
+        for (UInt32 i = 0; i < METADATA_SLOTS; i++) {
+            int probe = (hash + i) & (METADATA_SLOTS - 1);
+            if (fTable->fSlots[probe].fState == SLOT_EMPTY) {
+                index = probe;
+                break;
+            }
+        }
+        if (index < 0) {
+            jack_error("JackMetadata::SetProperty metadata store is full");
+            return -1;
+        }
+        *change = PropertyCreated;
+    }
+
+    WriteStart();
+    JackMetadataSlot* slot = &fTable->fSlots[index];
+    slot->fSubject = subject;
+    strcpy(slot->fKey, key);
+    strcpy(slot->fValue, value);
+    strcpy(slot->fType, (type) ? type : "");
+    if (*change == PropertyCreated) {
+        slot->fState = SLOT_USED;
+        fTable->fCount++;
+    }
+    WriteStop();
+    return 0;
+}
+
+// Server
+int JackMetadata::RemoveProperty(jack_uuid_t subject, const char* key)
+{
+    if (!fWritable || !key) {
+        return -1;
+    }
+
+    int index = Find(subject, key);
+    if (index < 0) {
+        return -1;
+    }
+
+    WriteStart();
+    Clear(index);
+    WriteStop();
+    return 0;
+}
+
+// Server
+int JackMetadata::RemoveProperties(jack_uuid_t subject)
+{
+    if (!fWritable) {
+        return -1;
+    }
+
+    int count = 0;
+    WriteStart();
+    for (int i = 0; i < METADATA_SLOTS; i++) {
+        // Clear may move a following slot in this one, which is checked again
+        while (fTable->fSlots[i].fState == SLOT_USED && fTable->fSlots[i].fSubject == subject) {
+            Clear(i);
+            count++;
+        }
+    }
+    WriteStop();
+    return count;
+}
+
+// Server
+int JackMetadata::RemoveAllProperties()
+{
+    if (!fWritable) {
+        return -1;
+    }
+
+    WriteStart();
+    for (int i = 0; i < METADATA_SLOTS; i++) {
+        fTable->fSlots[i].fState = SLOT_EMPTY;
+    }
+    fTable->fCount = 0;
+    WriteStop();
+    return 0;
+}
+
+/*
+    Port UUIDs are derived from port indexes which are reused by the next server instance:
+    properties of ports are not kept from one run to the other.
+*/
+
+// Server
+int JackMetadata::RemovePortProperties()
+{
+    if (!fWritable) {
+        return -1;
+    }
+
+    int count = 0;
+    WriteStart();
+    for (int i = 0; i < METADATA_SLOTS; i++) {
+        // Clear may move a following slot in this one, which is checked again
+        while (fTable->fSlots[i].fState == SLOT_USED && (fTable->fSlots[i].fSubject >> 32) == JACK_UUID_TYPE_PORT) {
+            Clear(i);
+            count++;
+        }
+    }
+    WriteStop();
+    return count;
+}
+
+// Client
+int JackMetadata::GetPropertyAux(jack_uuid_t subject, const char* key, char** value, char** type)
+{
+    int index = Find(subject, key);
+    if (index < 0) {
+        return -1;
+    }
+    JackMetadataSlot* slot = &fTable->fSlots[index];
+    *value = strndup(slot->fValue, METADATA_VALUE_SIZE);
+    *type = (slot->fType[0]) ? strndup(slot->fType, METADATA_TYPE_SIZE) : NULL;
+    return 0;
+}
+
+// Client
+int JackMetadata::GetProperty(jack_uuid_t subject, const char* key, char** value, char** type)
+{
+    char* value_res;
+    char* type_res;
+    UInt32 counter;
+    int res;
+
+    if (!fTable || !key || !value) {
+        return -1;
+    }
+
+    do {
+        value_res = type_res = NULL;
+        counter = ReadStart();
+        res = GetPropertyAux(subject, key, &value_res, &type_res);
+        if (ReadRetry(counter)) {
+            free(value_res);
+            free(type_res);
+        }
+    } while (ReadRetry(counter)); // Until a coherent state has been read
+
+    *value = value_res;
+    if (type) {
+        *type = type_res;
+    } else {
+        free(type_res);
+    }
+    return res;
+}
+
+// Client
+int JackMetadata::GetPropertiesAux(jack_uuid_t subject, jack_description_t* desc)
+{
+    desc->subject = subject;
+    desc->property_cnt = 0;
+    desc->property_size = 0;
+    desc->properties = NULL;
+
+    for (int i = 0; i < METADATA_SLOTS; i++) {
+        JackMetadataSlot* slot = &fTable->fSlots[i];
+        if (slot->fState == SLOT_USED && slot->fSubject == subject) {
+            if (desc->property_cnt == desc->property_size) {
+                desc->property_size = (desc->property_size) ? desc->property_size * 2 : 8;
+                desc->properties = (jack_property_t*)realloc(desc->properties, sizeof(jack_property_t) * desc->property_size);
+            }
+            jack_property_t* property = &desc->properties[desc->property_cnt++];
+            property->key = strndup(slot->fKey, METADATA_KEY_SIZE);
+            property->data = strndup(slot->fValue, METADATA_VALUE_SIZE);
+            property->type = (slot->fType[0]) ? strndup(slot->fType, METADATA_TYPE_SIZE) : NULL;
+        }
+    }
+
+    return desc->property_cnt;
+}
+
+// Client
+int JackMetadata::GetProperties(jack_uuid_t subject, jack_description_t* desc)
+{
+    UInt32 counter;
+    int res;
+
+    if (!fTable || !desc) {
+        return -1;
+    }
+
+    do {
+        counter = ReadStart();
+        res = GetPropertiesAux(subject, desc);
+        if (ReadRetry(counter)) {
+            FreeDescription(desc, 0);
+        }
+    } while (ReadRetry(counter)); // Until a coherent state has been read
+
+    return res;
+}
+
+// Client
+int JackMetadata::GetAllPropertiesAux(jack_description_t** descs)
+{
+    int subject_count = 0;
+    int subject_size = 0;
+    *descs = NULL;
+
+    for (int i = 0; i < METADATA_SLOTS; i++) {
+        JackMetadataSlot* slot = &fTable->fSlots[i];
+        if (slot->fState != SLOT_USED) {
+            continue;
+        }
+        // Each subject is only described once
+        bool found = false;
+        for (int j = 0; j < subject_count && !found; j++) {
+            found = ((*descs)[j].subject == slot->fSubject);
+        }
+        if (!found) {
+            if (subject_count == subject_size) {
+                subject_size = (subject_size) ? subject_size * 2 : 8;
+                *descs = (jack_description_t*)realloc(*descs, sizeof(jack_description_t) * subject_size);
+            }
+            GetPropertiesAux(slot->fSubject, &(*descs)[subject_count++]);
+        }
+    }
+
+    return subject_count;
+}
+
+// Client
+int JackMetadata::GetAllProperties(jack_description_t** descs)
+{
+    UInt32 counter;
+    int res;
+
+    if (!fTable || !descs) {
+        return -1;
+    }
+
+    do {
+        counter = ReadStart();
+        res = GetAllPropertiesAux(descs);
+        if (ReadRetry(counter)) {
+            for (int i = 0; i < res; i++) {
+                FreeDescription(&(*descs)[i], 0);
+            }
+            free(*descs);
+        }
+    } while (ReadRetry(counter)); // Until a coherent state has been read
+
+    return res;
+}
+
+void JackMetadata::FreeDescription(jack_description_t* desc, int free_description_itself)
+{
+    for (uint32_t i = 0; i < desc->property_cnt; i++) {
+        free((char*)desc->properties[i].key);
+        free((char*)desc->properties[i].data);
+        free((char*)desc->properties[i].type);
+    }
+    free(desc->properties);
+    desc->properties = NULL;
+    desc->property_cnt = 0;
+    desc->property_size = 0;
+
+    if (free_description_itself) {
+        free(desc);
+    }
+}
+
+} // end of namespace
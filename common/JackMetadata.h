@@ -21,6 +21,7 @@
 #define __jack_metadata_int_h__
 
 #include <stdint.h>
+#include "types.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,4 +54,143 @@ typedef void (*JackPropertyChangeCallback)(jack_uuid_t            subject,
 #ifdef __cplusplus
 }
 #endif
+
+#ifdef __cplusplus
+
+#include "JackCompilerDeps.h"
+#include "JackConstants.h"
+#include "JackTypes.h"
+#include "types.h"
+
+namespace Jack
+{
+
+#define METADATA_SLOTS 2048         // Must be a power of two
+#define METADATA_KEY_SIZE 256       // Fits in a notification message
+#define METADATA_TYPE_SIZE 128
+#define METADATA_VALUE_SIZE 2048
+
+#define JACK_UUID_TYPE_PORT 1       // High 32 bits of a port jack_uuid_t
+#define JACK_UUID_TYPE_CLIENT 2     // High 8 bits of a generated client jack_uuid_t, followed by the process ID and a counter
+
+/*!
+\brief Metadata actions sent from client to server.
+*/
+
+enum JackMetadataAction {
+    kSetProperty = 0,
+    kRemoveProperty = 1,
+    kRemoveProperties = 2,
+    kRemoveAllProperties = 3
+};
+
+/*!
+\brief A property slot in the metadata table.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackMetadataSlot
+{
+    jack_uuid_t fSubject;
+    UInt32 fState;
+    char fKey[METADATA_KEY_SIZE];
+    char fType[METADATA_TYPE_SIZE];
+    char fValue[METADATA_VALUE_SIZE];
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief The metadata table, memory mapped from a file so that it is persistent across server restarts.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackMetadataTable
+{
+    UInt32 fMagic;
+    UInt32 fVersion;
+    volatile UInt32 fCounter;   // Odd while the server is writing
+    UInt32 fCount;
+    JackMetadataSlot fSlots[METADATA_SLOTS];
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief Metadata store: properties hashed by subject and key, in an open addressing table.
+
+The server is the single writer (metadata requests are serialized by the engine lock). Clients map
+the same file read only and answer get requests without any server round trip, retrying until a
+coherent state has been read, the same way the graph manager is read.
+*/
+
+class SERVER_EXPORT JackMetadata
+{
+
+    private:
+
+        JackMetadataTable* fTable;
+        int fFd;
+        bool fWritable;
+
+        static UInt32 Hash(jack_uuid_t subject, const char* key);
+        int Find(jack_uuid_t subject, const char* key) const;
+        void Clear(int index);
+
+        void WriteStart();
+        void WriteStop();
+        UInt32 ReadStart() const;
+        bool ReadRetry(UInt32 counter) const;
+
+        int GetPropertyAux(jack_uuid_t subject, const char* key, char** value, char** type);
+        int GetPropertiesAux(jack_uuid_t subject, jack_description_t* desc);
+        int GetAllPropertiesAux(jack_description_t** descs);
+
+    public:
+
+        JackMetadata();
+        ~JackMetadata();
+
+        int Open(const char* server_name, bool writable);
+        void Close();
+
+        bool IsOpened() const
+        {
+            return (fTable != NULL);
+        }
+
+        static void GetPath(const char* server_name, char* path);
+
+        static jack_uuid_t PortUUID(UInt32 port_index)
+        {
+            return ((jack_uuid_t)JACK_UUID_TYPE_PORT << 32) | (port_index + 1);
+        }
+
+        static jack_uuid_t ClientUUID(UInt32 pid, UInt32 counter)
+        {
+            return ((jack_uuid_t)JACK_UUID_TYPE_CLIENT << 56) | ((jack_uuid_t)pid << 24) | (counter & 0xFFFFFF);
+        }
+
+        static jack_uuid_t SessionUUID(int session_id)
+        {
+            return (jack_uuid_t)session_id;
+        }
+
+        // Server
+        int SetProperty(jack_uuid_t subject, const char* key, const char* value, const char* type, jack_property_change_t* change);
+        int RemoveProperty(jack_uuid_t subject, const char* key);
+        int RemoveProperties(jack_uuid_t subject);
+        int RemoveAllProperties();
+        int RemovePortProperties();
+
+        // Client
+        int GetProperty(jack_uuid_t subject, const char* key, char** value, char** type);
+        int GetProperties(jack_uuid_t subject, jack_description_t* desc);
+        int GetAllProperties(jack_description_t** descs);
+
+        static void FreeDescription(jack_description_t* desc, int free_description_itself);
+};
+
+} // end of namespace
+
+#endif
+
 #endif
@@ -0,0 +1,410 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackMetrics.h"
+#include "JackServerGlobals.h"
+#include "JackEngineControl.h"
+#include "JackGraphManager.h"
+#include "JackLockedEngine.h"
+#include "JackXRunRecorder.h"
+#include "JackMessageBuffer.h"
+#include "JackArgParser.h"
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace Jack
+{
+
+static void AddMetric(std::string& page, const char* name, const char* type, const char* help)
+{
+    page += "# HELP ";
+    page += name;
+    page += " ";
+    page += help;
+    page += "\n# TYPE ";
+    page += name;
+    page += " ";
+    page += type;
+    page += "\n";
+}
+
+static void AddValue(std::string& page, const char* name, const char* labels, double value)
+{
+    char number[32];
+    snprintf(number, sizeof(number), "%.9g", value);
+    page += name;
+    page += "{";
+    page += labels;
+    page += "} ";
+    page += number;
+    page += "\n";
+}
+
+static void AddDistribution(std::string& page, const char* name, const char* client, const jack_timing_distribution_t* distribution)
+{
+    char labels[256];
+    snprintf(labels, sizeof(labels), "client=\"%s\",quantile=\"0.5\"", client);
+    AddValue(page, name, labels, double(distribution->p50));
+    snprintf(labels, sizeof(labels), "client=\"%s\",quantile=\"0.99\"", client);
+    AddValue(page, name, labels, double(distribution->p99));
+    snprintf(labels, sizeof(labels), "client=\"%s\",quantile=\"0.999\"", client);
+    AddValue(page, name, labels, double(distribution->p999));
+    snprintf(labels, sizeof(labels), "client=\"%s\",quantile=\"1\"", client);
+    AddValue(page, name, labels, double(distribution->max));
+    snprintf(labels, sizeof(labels), "client=\"%s\"", client);
+    AddValue(page, (std::string(name) + "_count").c_str(), labels, double(distribution->count));
+}
+
+JackMetrics::JackMetrics(jack_client_t* client, const JSList* params)
+    :fClient(client), fThread(this), fSocket(-1), fPort(METRICS_DEFAULT_PORT)
+{
+    jack_log("JackMetrics::JackMetrics");
+
+    const JSList* node;
+    const jack_driver_param_t* param;
+    for (node = params; node; node = jack_slist_next(node)) {
+        param = (const jack_driver_param_t*)node->data;
+
+        switch (param->character) {
+            case 'p':
+                fPort = param->value.ui;
+                break;
+
+            case 'u':
+                fPath = param->value.str;
+                break;
+        }
+    }
+}
+
+JackMetrics::~JackMetrics()
+{
+    jack_log("JackMetrics::~JackMetrics");
+    fThread.Stop();
+    if (fSocket >= 0) {
+        close(fSocket);
+    }
+    if (fPath.size() > 0) {
+        unlink(fPath.c_str());
+    }
+}
+
+int JackMetrics::Open()
+{
+    if (fPath.size() > 0) {
+        struct sockaddr_un addr;
+        if (fPath.size() >= sizeof(addr.sun_path)) {
+            jack_error("JackMetrics: socket path %s is too long", fPath.c_str());
+            return -1;
+        }
+        if ((fSocket = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+            jack_error("JackMetrics: cannot create socket err = %s", strerror(errno));
+            return -1;
+        }
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, fPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(fPath.c_str());
+        if (bind(fSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            jack_error("JackMetrics: cannot bind socket %s err = %s", fPath.c_str(), strerror(errno));
+            goto error;
+        }
+    } else {
+        struct sockaddr_in addr;
+        int on = 1;
+        if ((fSocket = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+            jack_error("JackMetrics: cannot create socket err = %s", strerror(errno));
+            return -1;
+        }
+        setsockopt(fSocket, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(fPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  // Never exposed outside of the machine
+        if (bind(fSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            jack_error("JackMetrics: cannot bind port %d err = %s", fPort, strerror(errno));
+            goto error;
+        }
+    }
+
+    if (listen(fSocket, 4) < 0) {
+        jack_error("JackMetrics: cannot listen err = %s", strerror(errno));
+        goto error;
+    }
+
+    if (fThread.Start() < 0) {
+        jack_error("JackMetrics: cannot start thread");
+        goto error;
+    }
+
+    if (fPath.size() > 0) {
+        jack_info("Serving metrics on %s", fPath.c_str());
+    } else {
+        jack_info("Serving metrics on http://127.0.0.1:%d/metrics", fPort);
+    }
+    return 0;
+
+error:
+    close(fSocket);
+    fSocket = -1;
+    return -1;
+}
+
+bool JackMetrics::Execute()
+{
+    fd_set fds;
+    struct timeval timeout;
+
+    // Wake up regularly to see if the thread has to stop
+    FD_ZERO(&fds);
+    FD_SET(fSocket, &fds);
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 200000;
+
+    int res = select(fSocket + 1, &fds, NULL, NULL, &timeout);
+    if (res < 0 && errno != EINTR) {
+        jack_error("JackMetrics: select err = %s", strerror(errno));
+        return false;
+    } else if (res > 0) {
+        int fd = accept(fSocket, NULL, NULL);
+        if (fd >= 0) {
+            Serve(fd);
+            close(fd);
+        }
+    }
+    return true;
+}
+
+void JackMetrics::Serve(int fd)
+{
+    char request[1024];
+    fd_set fds;
+    struct timeval timeout;
+
+    // The request itself does not matter, but reading it avoids a connection reset on some clients
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    if (select(fd + 1, &fds, NULL, NULL, &timeout) > 0) {
+        if (read(fd, request, sizeof(request)) < 0) {
+            return;
+        }
+    }
+
+    std::string page;
+    BuildPage(page);
+
+    char header[256];
+    snprintf(header, sizeof(header),
+             "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %ld\r\nConnection: close\r\n\r\n",
+             long(page.size()));
+    std::string response = std::string(header) + page;
+
+    const char* data = response.c_str();
+    size_t size = response.size();
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written <= 0) {
+            break;
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+void JackMetrics::BuildPage(std::string& page)
+{
+    JackEngineControl* control = JackServerGlobals::fInstance->GetEngineControl();
+    JackGraphManager* manager = JackServerGlobals::fInstance->GetGraphManager();
+    JackXRunRecorder* recorder = JackServerGlobals::fInstance->GetEngine()->GetXRunRecorder();
+    std::string server_labels = std::string("server=\"") + control->fServerName + "\"";
+    const char* labels = server_labels.c_str();
+
+    AddMetric(page, "jack_xruns_total", "counter", "XRuns since the server started.");
+    AddValue(page, "jack_xruns_total", labels, recorder->GetXRunCount());
+
+    AddMetric(page, "jack_dsp_load_percent", "gauge", "DSP load, as returned by jack_cpu_load().");
+    AddValue(page, "jack_dsp_load_percent", labels, control->fCPULoad);
+
+    AddMetric(page, "jack_max_delayed_usecs", "gauge", "Maximum delay reported by the backend.");
+    AddValue(page, "jack_max_delayed_usecs", labels, control->fMaxDelayedUsecs);
+
+    AddMetric(page, "jack_sample_rate", "gauge", "Sample rate in Hz.");
+    AddValue(page, "jack_sample_rate", labels, control->fSampleRate);
+
+    AddMetric(page, "jack_buffer_size", "gauge", "Buffer size in frames.");
+    AddValue(page, "jack_buffer_size", labels, control->fBufferSize);
+
+    // Drift of the driver clock, as seen by the DLL, compared to the nominal period
+    JackTimer timer;
+    jack_nframes_t frames;
+    jack_time_t current_usecs, next_usecs;
+    float period_usecs;
+    control->ReadFrameTime(&timer);
+    if (timer.GetCycleTimes(&frames, &current_usecs, &next_usecs, &period_usecs) == 0) {
+        double nominal_usecs = 1000000.0 * double(control->fBufferSize) / double(control->fSampleRate);
+        AddMetric(page, "jack_dll_period_usecs", "gauge", "Period estimated by the delay locked loop.");
+        AddValue(page, "jack_dll_period_usecs", labels, period_usecs);
+        AddMetric(page, "jack_dll_drift_ppm", "gauge", "Drift of the estimated period compared to the nominal one.");
+        AddValue(page, "jack_dll_drift_ppm", labels, (double(period_usecs) / nominal_usecs - 1.0) * 1000000.0);
+    }
+
+    AddMetric(page, "jack_net_packet_errors_total", "counter", "Cycles with missing packets in the net driver.");
+    AddValue(page, "jack_net_packet_errors_total", labels, UInt32(control->fCounters.fNetPacketErrors));
+
+    AddMetric(page, "jack_midi_lost_events_total", "counter", "MIDI events lost by the MIDI drivers.");
+    AddValue(page, "jack_midi_lost_events_total", labels, UInt32(control->fCounters.fMidiLostEvents));
+
+    AddMetric(page, "jack_graph_switches_total", "counter", "Cycles that began with a new graph state.");
+    AddValue(page, "jack_graph_switches_total", labels, UInt32(control->fGraphSwitches));
+
+    AddMetric(page, "jack_graph_waits_total", "counter", "Cycles that kept the current graph state because the previous cycle was not finished.");
+    AddValue(page, "jack_graph_waits_total", labels, UInt32(control->fGraphWaits));
+
+    AddMetric(page, "jack_graph_forced_switches_total", "counter", "Graph state switches forced after the time out.");
+    AddValue(page, "jack_graph_forced_switches_total", labels, UInt32(control->fGraphForcedSwitches));
+
+    if (JackMessageBuffer::fInstance) {
+        SInt32 added, dropped;
+        JackMessageBuffer::fInstance->GetCounters(&added, &dropped);
+        AddMetric(page, "jack_messages_total", "counter", "Messages logged by real-time threads.");
+        AddValue(page, "jack_messages_total", labels, UInt32(added));
+        AddMetric(page, "jack_messages_dropped_total", "counter", "Messages of real-time threads dropped because the message buffer was full.");
+        AddValue(page, "jack_messages_dropped_total", labels, UInt32(dropped));
+    }
+
+    // Timing percentiles, spin wait and worker counters of all clients, drivers included
+    std::string process, wakeup, spin_hits, spin_misses, workers;
+    AddMetric(process, "jack_client_process_usecs", "summary", "Duration of the client process callback.");
+    AddMetric(wakeup, "jack_client_wakeup_usecs", "summary", "Delay between the date a client is signaled and the date it wakes up.");
+    AddMetric(spin_hits, "jack_client_spin_hits_total", "counter", "Cycles a spinning client was activated before blocking.");
+    AddMetric(spin_misses, "jack_client_spin_misses_total", "counter", "Cycles a spinning client blocked once its spin budget was spent.");
+    AddMetric(workers, "jack_client_workers_usecs_total", "counter", "Time spent by the worker threads of a client.");
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        JackClientTimingStats* entry = manager->GetClientTimingStats(i);
+        jack_client_timing_stats_t stats;
+        char name[JACK_CLIENT_NAME_SIZE + 1];
+        entry->GetName(name, sizeof(name));
+        if (name[0] == 0 || strchr(name, '"') || strchr(name, '\\')) {
+            continue;
+        }
+        entry->GetStats(&stats);
+        AddDistribution(process, "jack_client_process_usecs", name, &stats.process);
+        AddDistribution(wakeup, "jack_client_wakeup_usecs", name, &stats.wakeup);
+        char client_labels[256];
+        snprintf(client_labels, sizeof(client_labels), "client=\"%s\"", name);
+        AddValue(spin_hits, "jack_client_spin_hits_total", client_labels, double(stats.spin_hits));
+        AddValue(spin_misses, "jack_client_spin_misses_total", client_labels, double(stats.spin_misses));
+        AddValue(workers, "jack_client_workers_usecs_total", client_labels, double(stats.workers_usecs));
+    }
+    page += process;
+    page += wakeup;
+    page += spin_hits;
+    page += spin_misses;
+    page += workers;
+}
+
+} // namespace Jack
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "driver_interface.h"
+
+    using namespace Jack;
+
+    static Jack::JackMetrics* metrics = NULL;
+
+    SERVER_EXPORT jack_driver_desc_t* jack_get_descriptor()
+    {
+        jack_driver_desc_t * desc;
+        jack_driver_desc_filler_t filler;
+        jack_driver_param_value_t value;
+
+        desc = jack_driver_descriptor_construct("metrics", JackDriverNone, "server metrics in the Prometheus text format", &filler);
+
+        value.ui = METRICS_DEFAULT_PORT;
+        jack_driver_descriptor_add_parameter(desc, &filler, "port", 'p', JackDriverParamUInt, &value, NULL, "Loopback TCP port", NULL);
+
+        strcpy(value.str, "");
+        jack_driver_descriptor_add_parameter(desc, &filler, "unix-socket", 'u', JackDriverParamString, &value, NULL, "UNIX socket path, used instead of the TCP port", NULL);
+
+        return desc;
+    }
+
+    SERVER_EXPORT int jack_internal_initialize(jack_client_t* jack_client, const JSList* params)
+    {
+        if (metrics) {
+            jack_info("metrics already loaded");
+            return 1;
+        }
+
+        jack_log("Loading metrics");
+        metrics = new Jack::JackMetrics(jack_client, params);
+        assert(metrics);
+        if (metrics->Open() < 0) {
+            delete metrics;
+            metrics = NULL;
+            return 1;
+        }
+        return 0;
+    }
+
+    SERVER_EXPORT int jack_initialize(jack_client_t* jack_client, const char* load_init)
+    {
+        JSList* params = NULL;
+        bool parse_params = true;
+        int res = 1;
+        jack_driver_desc_t* desc = jack_get_descriptor();
+
+        Jack::JackArgParser parser ( load_init );
+        if ( parser.GetArgc() > 0 )
+            parse_params = parser.ParseParams ( desc, &params );
+
+        if (parse_params) {
+            res = jack_internal_initialize ( jack_client, params );
+            parser.FreeParams ( params );
+        }
+        return res;
+    }
+
+    SERVER_EXPORT void jack_finish(void* arg)
+    {
+        if (metrics) {
+            jack_log("Unloading metrics");
+            delete metrics;
+            metrics = NULL;
+        }
+    }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,69 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackMetrics__
+#define __JackMetrics__
+
+#include "JackConstants.h"
+#include "JackPlatformPlug.h"
+#include "jack.h"
+#include "jslist.h"
+#include <string>
+
+namespace Jack
+{
+
+#define METRICS_DEFAULT_PORT 9153
+
+/*!
+\brief Serves server metrics in the Prometheus text format.
+
+The page is built by a non real-time thread on each request, reading counters in the engine control and the graph
+manager without taking any lock: the client is never activated and is not part of the graph.
+*/
+
+class JackMetrics : public JackRunnableInterface
+{
+
+    private:
+
+        jack_client_t* fClient;
+        JackThread fThread;
+        int fSocket;
+        int fPort;
+        std::string fPath;
+
+        void Serve(int fd);
+        void BuildPage(std::string& page);
+
+    public:
+
+        JackMetrics(jack_client_t* client, const JSList* params);
+        ~JackMetrics();
+
+        int Open();
+
+        // JackRunnableInterface interface
+        bool Execute();
+
+};
+
+}
+
+#endif
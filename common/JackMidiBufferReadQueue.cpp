@@ -19,7 +19,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "JackMidiBufferReadQueue.h"
 #include "JackMidiUtil.h"
+#include "JackEngineControl.h"
 #include "JackError.h"
+#include "JackGlobals.h"
 
 using Jack::JackMidiBufferReadQueue;
 
@@ -60,6 +62,7 @@ JackMidiBufferReadQueue::ResetMidiBuffer(JackMidiBuffer *buffer)
         if (lost_events) {
             jack_error("JackMidiBufferReadQueue::ResetMidiBuffer - %d events "
                        "lost during mixdown", lost_events);
+            GetEngineControl()->AddMidiLostEvents(lost_events);
         }
         this->buffer = buffer;
         event_count = buffer->event_count;
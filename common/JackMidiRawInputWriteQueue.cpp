@@ -22,7 +22,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include <new>
 
 #include "JackMidiRawInputWriteQueue.h"
+#include "JackEngineControl.h"
 #include "JackError.h"
+#include "JackGlobals.h"
 
 using Jack::JackMidiRawInputWriteQueue;
 
@@ -76,6 +78,7 @@ JackMidiRawInputWriteQueue::HandleBufferFailure(size_t unbuffered_bytes,
     jack_error("JackMidiRawInputWriteQueue::HandleBufferFailure - %d MIDI "
                "byte(s) of a %d byte message could not be buffered.  The "
                "message has been dropped.", unbuffered_bytes, total_bytes);
+    GetEngineControl()->AddMidiLostEvents(1);
 }
 
 void
@@ -85,6 +88,7 @@ JackMidiRawInputWriteQueue::HandleEventLoss(jack_midi_event_t *event)
                "event scheduled for frame '%d' could not be processed because "
                "the write queue cannot accomodate an event of that size.  The "
                "event has been discarded.", event->size, event->time);
+    GetEngineControl()->AddMidiLostEvents(1);
 }
 
 void
@@ -89,6 +89,44 @@ class JackLock
         }
 };
 
+class JackReadLock
+{
+    private:
+
+        JackRWLock* fLock;
+
+    public:
+
+        JackReadLock(JackRWLock* lock): fLock(lock)
+        {
+            fLock->ReadLock();
+        }
+
+        ~JackReadLock()
+        {
+            fLock->ReadUnlock();
+        }
+};
+
+class JackWriteLock
+{
+    private:
+
+        JackRWLock* fLock;
+
+    public:
+
+        JackWriteLock(JackRWLock* lock): fLock(lock)
+        {
+            fLock->WriteLock();
+        }
+
+        ~JackWriteLock()
+        {
+            fLock->WriteUnlock();
+        }
+};
+
 
 } // namespace
 
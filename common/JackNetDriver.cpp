@@ -571,6 +571,7 @@ namespace Jack
                 
             case SYNC_PACKET_ERROR:
                 // since sync packet is incorrect, don't decode it and continue with data
+                fEngineControl->IncNetPacketErrors();
                 break;
                 
             default:
@@ -595,6 +596,7 @@ namespace Jack
                 return SOCKET_ERROR;
                 
             case DATA_PACKET_ERROR:
+                fEngineControl->IncNetPacketErrors();
                 jack_time_t cur_time = GetMicroSeconds();
                 NotifyXRun(cur_time, float(cur_time - fBeginDateUst));  // Better this value than nothing...
                 break;
@@ -19,6 +19,7 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include "JackNetInterface.h"
 #include "JackException.h"
 #include "JackError.h"
+#include "JackProbes.h"
 
 #include <assert.h>
 
@@ -890,6 +891,7 @@ namespace Jack
         
         //PacketHeaderDisplay(rx_head);
         fRxHeader.fIsLastPckt = rx_head->fIsLastPckt;
+        JACK_PROBE1(net_sync_recv, rx_bytes);
         return rx_bytes;
     }
 
@@ -928,6 +930,7 @@ namespace Jack
         }
 
         fRxHeader.fCycle = rx_head->fCycle;
+        JACK_PROBE2(net_data_recv, rx_bytes, fRxHeader.fCycle);
         return rx_bytes;
     }
 
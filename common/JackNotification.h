@@ -47,6 +47,8 @@ enum NotificationType {
     kQUIT = 16,
     kSessionCallback = 17,
     kLatencyCallback = 18,
+    kNotificationRing = 19,     // Doorbell: drain the shared memory notification ring
+    kPropertyChangeCallback = 20,
     kMaxNotification = 64  // To keep some room in JackClientControl fCallback table
 };
 
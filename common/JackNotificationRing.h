@@ -0,0 +1,224 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackNotificationRing__
+#define __JackNotificationRing__
+
+#include "JackTypes.h"
+#include "JackAtomic.h"
+#include "JackConstants.h"
+#include "JackNotification.h"
+#include "JackCompilerDeps.h"
+#include <string.h>
+
+namespace Jack
+{
+
+#define NOTIFICATION_RING_SIZE 512      // Must be a power of two
+#define NOTIFICATION_RING_MASK (NOTIFICATION_RING_SIZE - 1)
+#define NOTIFICATION_PAYLOAD_NUM 64     // Must be a power of two
+#define NOTIFICATION_PAYLOAD_MASK (NOTIFICATION_PAYLOAD_NUM - 1)
+
+/*!
+\brief A notification event queued in shared memory.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackNotificationEvent
+{
+    SInt32 fNotify;
+    SInt32 fValue1;
+    SInt32 fValue2;
+    SInt32 fPayload;    // Index of the strings of the notification in the payload table, -1 when there are none
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief The strings of a queued notification.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackNotificationPayload
+{
+    char fName[JACK_CLIENT_NAME_SIZE + 1];
+    char fMessage[JACK_MESSAGE_SIZE + 1];
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief Indexes of the notification ring, each one on its own cache line.
+
+The ring is part of the packed client control: the indexes are aligned so that their atomic updates do not straddle
+two cache lines.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackNotificationIndexes
+{
+    MEM_ALIGN(volatile UInt32 fWrite, CACHE_LINE_SIZE);    // Written by the server only
+    MEM_ALIGN(volatile UInt32 fRead, CACHE_LINE_SIZE);     // Written by the client only
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief Single producer (server) / single consumer (client notification thread) ring of asynchronous notifications.
+
+Asynchronous notifications (port registration, port connection, graph order, property change) are queued here
+instead of being written one by one on the client notification socket. The strings of a property change are kept
+in a smaller payload table, a payload is reused once the client has read the event that refers to it. The server only
+writes a single kNotificationRing "doorbell" message on the socket when a batch is flushed: it carries
+the write index reached at flush time, so that the client drains exactly the events queued before
+any notification that follows on the socket, and ordering is preserved.
+*/
+
+PRE_PACKED_STRUCTURE
+class JackNotificationRing
+{
+
+    private:
+
+        MEM_ALIGN(JackNotificationIndexes fIndexes, CACHE_LINE_SIZE);
+        UInt32 fFlushIndex;             // Server side: write index at last flush
+        UInt32 fPayloadIndex;           // Server side: number of payloads used so far
+        UInt32 fPayloadEvents[NOTIFICATION_PAYLOAD_NUM];    // Server side: write index of the event of each payload
+        JackNotificationEvent fEvents[NOTIFICATION_RING_SIZE];
+        JackNotificationPayload fPayloads[NOTIFICATION_PAYLOAD_NUM];
+
+        // Events are read after the write index that publishes them
+        static void AcquireBarrier()
+        {
+        #if defined(__GNUC__)
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        #else
+            MemoryBarrier();
+        #endif
+        }
+
+    public:
+
+        JackNotificationRing()
+        {
+            Init();
+        }
+
+        void Init()
+        {
+            fIndexes.fWrite = 0;
+            fIndexes.fRead = 0;
+            fFlushIndex = 0;
+            fPayloadIndex = 0;
+        }
+
+        static bool IsQueued(int notify)
+        {
+            switch (notify) {
+                case kGraphOrderCallback:
+                case kPortRegistrationOnCallback:
+                case kPortRegistrationOffCallback:
+                case kPortConnectCallback:
+                case kPortDisconnectCallback:
+                case kPropertyChangeCallback:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        static bool HasPayload(int notify)
+        {
+            return (notify == kPropertyChangeCallback);
+        }
+
+        // Server
+        bool Push(int notify, int value1, int value2, const char* name, const char* message)
+        {
+            UInt32 write_index = fIndexes.fWrite;
+            if (write_index - fIndexes.fRead >= NOTIFICATION_RING_SIZE) {
+                return false;
+            }
+            SInt32 payload = -1;
+            if (HasPayload(notify)) {
+                payload = fPayloadIndex & NOTIFICATION_PAYLOAD_MASK;
+                // The event of the previous use of this payload has to be read
+                if (fPayloadIndex >= NOTIFICATION_PAYLOAD_NUM && SInt32(fIndexes.fRead - fPayloadEvents[payload]) <= 0) {
+                    return false;
+                }
+                strncpy(fPayloads[payload].fName, name, JACK_CLIENT_NAME_SIZE);
+                fPayloads[payload].fName[JACK_CLIENT_NAME_SIZE] = 0;
+                strncpy(fPayloads[payload].fMessage, message, JACK_MESSAGE_SIZE);
+                fPayloads[payload].fMessage[JACK_MESSAGE_SIZE] = 0;
+                fPayloadEvents[payload] = write_index;
+                fPayloadIndex++;
+            }
+            JackNotificationEvent* event = &fEvents[write_index & NOTIFICATION_RING_MASK];
+            event->fNotify = notify;
+            event->fValue1 = value1;
+            event->fValue2 = value2;
+            event->fPayload = payload;
+            // CAS acts as a full barrier: the event is visible before the new index
+            CAS(write_index, write_index + 1, &fIndexes.fWrite);
+            return true;
+        }
+
+        // Server
+        bool IsFlushed() const
+        {
+            return (fFlushIndex == fIndexes.fWrite);
+        }
+
+        // Server
+        UInt32 Flush()
+        {
+            fFlushIndex = fIndexes.fWrite;
+            return fFlushIndex;
+        }
+
+        // Client, the payload is copied before the event is released
+        bool Pop(UInt32 limit, JackNotificationEvent* event, JackNotificationPayload* payload = NULL)
+        {
+            UInt32 read_index = fIndexes.fRead;
+            if (read_index == limit || read_index == fIndexes.fWrite) {
+                return false;
+            }
+            AcquireBarrier();
+            *event = fEvents[read_index & NOTIFICATION_RING_MASK];
+            if (payload && event->fPayload >= 0) {
+                *payload = fPayloads[event->fPayload & NOTIFICATION_PAYLOAD_MASK];
+            }
+            CAS(read_index, read_index + 1, &fIndexes.fRead);
+            return true;
+        }
+
+        // Client
+        bool Peek(UInt32 limit, JackNotificationEvent* event) const
+        {
+            UInt32 read_index = fIndexes.fRead;
+            if (read_index == limit || read_index == fIndexes.fWrite) {
+                return false;
+            }
+            AcquireBarrier();
+            *event = fEvents[read_index & NOTIFICATION_RING_MASK];
+            return true;
+        }
+
+} POST_PACKED_STRUCTURE;
+
+} // end of namespace
+
+#endif
@@ -67,6 +67,7 @@ class SERVER_EXPORT JackPort
 
         // RT
         void ClearBuffer(jack_nframes_t frames);
+        void ClearBuffer(void* buffer, jack_nframes_t frames);
         void MixBuffers(void** src_buffers, int src_count, jack_nframes_t frames);
 
     public:
@@ -115,6 +116,23 @@ class SERVER_EXPORT JackPort
 
 } POST_PACKED_STRUCTURE;
 
+/*!
+\brief Buffer of an output port written in a previous cycle, for the pipelined graph execution.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackPortBuffer
+{
+    jack_default_audio_sample_t fBuffer[BUFFER_SIZE_MAX + 8];
+
+    // Aligned as the buffer of the port
+    jack_default_audio_sample_t* GetBuffer()
+    {
+        return (jack_default_audio_sample_t*)((uintptr_t)fBuffer & ~31L) + 8;
+    }
+
+} POST_PACKED_STRUCTURE;
+
 } // end of namespace
 
 
@@ -0,0 +1,52 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackProbes__
+#define __JackProbes__
+
+#include "JackConstants.h"
+
+/*
+USDT probes of the "jack" provider, a single nop instruction when they are not traced. They are compiled
+out when sys/sdt.h is not available (see the --sdt configure option). See the bpftrace scripts in tools/bpftrace.
+
+    cycle_begin(cur_cycle_begin, prev_cycle_end)    server RT thread, JackEngine::Process
+    cycle_end(cur_cycle_begin, graph_switched)
+    driver_cycle_begin(date)                        JackDriver::CycleTakeBeginTime
+    client_wait(refnum)                             client RT thread, before waiting for the activation
+    client_wakeup(refnum, signaled_at, awake_at)
+    client_signal(refnum, status)                   after the process callback, before signaling the next clients
+    activation_signal(refnum, remaining)            a client signals a next one, woken up when remaining is 0
+    port_mixdown(port_index, connections)           JackGraphManager::GetBuffer of an input with several connections
+    net_sync_recv(rx_bytes)                         net slave (netjack2 driver) interface
+    net_data_recv(rx_bytes, cycle)
+*/
+
+#if HAVE_SDT
+#include <sys/sdt.h>
+#define JACK_PROBE1(name, a1) DTRACE_PROBE1(jack, name, a1)
+#define JACK_PROBE2(name, a1, a2) DTRACE_PROBE2(jack, name, a1, a2)
+#define JACK_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(jack, name, a1, a2, a3)
+#else
+#define JACK_PROBE1(name, a1)
+#define JACK_PROBE2(name, a1, a2)
+#define JACK_PROBE3(name, a1, a2, a3)
+#endif
+
+#endif
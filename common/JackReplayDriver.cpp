@@ -0,0 +1,393 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackReplayDriver.h"
+#include "JackDriverLoader.h"
+#include "JackThreadedDriver.h"
+#include "JackEngineControl.h"
+#include "JackGraphManager.h"
+#include "JackLockedEngine.h"
+#include "JackMidiPort.h"
+#include "JackError.h"
+#include "JackCompilerDeps.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+namespace Jack
+{
+
+JackReplayDriver::JackReplayDriver(const char* name, const char* alias, JackLockedEngine* engine, JackSynchro* table)
+    : JackTimedDriver(name, alias, engine, table), fMap(NULL), fMapSize(0), fHeader(NULL), fOffset(0),
+    fCycle(0), fLoop(false), fFinished(false), fTransportState(JackTransportStopped)
+{
+    fPath[0] = 0;
+    memset(&fPosition, 0, sizeof(fPosition));
+    for (int i = 0; i < DRIVER_PORT_NUM; i++) {
+        fMidiCapturePortList[i] = 0;
+    }
+}
+
+JackReplayDriver::~JackReplayDriver()
+{}
+
+int JackReplayDriver::Open(const char* path,
+                           bool loop,
+                           int outchannels,
+                           bool monitor,
+                           const char* capture_driver_name,
+                           const char* playback_driver_name)
+{
+    struct stat st;
+    int fd;
+
+    strncpy(fPath, path, JACK_PATH_MAX);
+    fPath[JACK_PATH_MAX] = 0;
+    fLoop = loop;
+
+    if ((fd = open(fPath, O_RDONLY)) < 0) {
+        jack_error("JackReplayDriver::Open cannot open %s err = %s", fPath, strerror(errno));
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(JackCycleFileHeader)) {
+        jack_error("JackReplayDriver::Open %s is not a cycle record file", fPath);
+        close(fd);
+        return -1;
+    }
+    fMapSize = st.st_size;
+    // Records are read in the RT thread: the whole file is read now, and kept in memory
+#ifdef MAP_POPULATE
+    fMap = (char*)mmap(NULL, fMapSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+#else
+    fMap = (char*)mmap(NULL, fMapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+#endif
+    close(fd);
+    if (fMap == MAP_FAILED) {
+        jack_error("JackReplayDriver::Open cannot map %s err = %s", fPath, strerror(errno));
+        fMap = NULL;
+        return -1;
+    }
+    if (mlock(fMap, fMapSize) < 0) {
+        jack_error("JackReplayDriver::Open cannot lock %s in memory err = %s, pages may be read from disk during the cycles", fPath, strerror(errno));
+    }
+
+    fHeader = (const JackCycleFileHeader*)fMap;
+    if (memcmp(fHeader->fMagic, CYCLE_RECORD_MAGIC, sizeof(CYCLE_RECORD_MAGIC)) != 0
+        || fHeader->fVersion != CYCLE_RECORD_VERSION
+        || fHeader->fHeaderSize < sizeof(JackCycleFileHeader)
+        || fHeader->fHeaderSize > fMapSize) {
+        jack_error("JackReplayDriver::Open %s is not a cycle record file of version %d", fPath, CYCLE_RECORD_VERSION);
+        Unmap();
+        return -1;
+    }
+    if (fHeader->fBufferSize == 0 || fHeader->fBufferSize > BUFFER_SIZE_MAX
+        || fHeader->fAudioChannels > DRIVER_PORT_NUM || fHeader->fMidiChannels > DRIVER_PORT_NUM) {
+        jack_error("JackReplayDriver::Open %s has unsupported buffer size or channels", fPath);
+        Unmap();
+        return -1;
+    }
+    if (fHeader->fCycles == 0) {
+        jack_info("JackReplayDriver: recording of %s was interrupted, records are played up to the end of the file", fPath);
+    }
+    fOffset = fHeader->fHeaderSize;
+
+    jack_info("JackReplayDriver: %s has %d audio and %d MIDI channels, %d frames at %d Hz",
+              fPath, fHeader->fAudioChannels, fHeader->fMidiChannels, fHeader->fBufferSize, fHeader->fSampleRate);
+
+    if (JackTimedDriver::Open(fHeader->fBufferSize, fHeader->fSampleRate, true, true,
+                              fHeader->fAudioChannels, outchannels, monitor,
+                              capture_driver_name, playback_driver_name, 0, 0) < 0) {
+        Unmap();
+        return -1;
+    }
+    return 0;
+}
+
+void JackReplayDriver::Unmap()
+{
+    if (fMap) {
+        munmap(fMap, fMapSize);
+        fMap = NULL;
+        fHeader = NULL;
+    }
+}
+
+int JackReplayDriver::Close()
+{
+    int res = JackTimedDriver::Close();
+    Unmap();
+    return res;
+}
+
+int JackReplayDriver::Attach()
+{
+    JackPort* port;
+    jack_port_id_t port_index;
+    char name[REAL_JACK_PORT_NAME_SIZE+1];
+    char alias[REAL_JACK_PORT_NAME_SIZE+1];
+
+    if (JackTimedDriver::Attach() < 0) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < fHeader->fMidiChannels; i++) {
+        snprintf(alias, sizeof(alias), "%s:%s:midi_out%d", fAliasName, fCaptureDriverName, i + 1);
+        snprintf(name, sizeof(name), "%s:midi_capture_%d", fClientControl.fName, i + 1);
+        if (fEngine->PortRegister(fClientControl.fRefNum, name, JACK_DEFAULT_MIDI_TYPE, CaptureDriverFlags, fEngineControl->fBufferSize, &port_index) < 0) {
+            jack_error("driver: cannot register port for %s", name);
+            return -1;
+        }
+        port = fGraphManager->GetPort(port_index);
+        port->SetAlias(alias);
+        fMidiCapturePortList[i] = port_index;
+    }
+
+    return 0;
+}
+
+int JackReplayDriver::Detach()
+{
+    for (uint32_t i = 0; i < fHeader->fMidiChannels; i++) {
+        fEngine->PortUnRegister(fClientControl.fRefNum, fMidiCapturePortList[i]);
+    }
+    return JackTimedDriver::Detach();
+}
+
+const JackCycleRecordHeader* JackReplayDriver::NextRecord()
+{
+    if (fFinished) {
+        return NULL;
+    }
+
+    if (fOffset + sizeof(JackCycleRecordHeader) > fMapSize && fLoop && fCycle > 0) {
+        jack_log("JackReplayDriver: looping after %lld cycles", (long long)fCycle);
+        fOffset = fHeader->fHeaderSize;
+    }
+
+    const JackCycleRecordHeader* record = (const JackCycleRecordHeader*)(fMap + fOffset);
+    if (fOffset + sizeof(JackCycleRecordHeader) > fMapSize) {
+        jack_info("JackReplayDriver: end of %s after %lld cycles", fPath, (long long)fCycle);
+        fFinished = true;
+        return NULL;
+    }
+    if (record->fSize < sizeof(JackCycleRecordHeader) || record->fSize > fMapSize - fOffset) {
+        jack_error("JackReplayDriver: truncated record at cycle %lld", (long long)fCycle);
+        fFinished = true;
+        return NULL;
+    }
+    if (record->fFrames != fEngineControl->fBufferSize) {
+        jack_error("JackReplayDriver: buffer size changed to %d frames at cycle %lld", record->fFrames, (long long)fCycle);
+        fFinished = true;
+        return NULL;
+    }
+    if (record->fDropped > 0) {
+        jack_error("JackReplayDriver: %d cycles were not recorded before cycle %lld", record->fDropped, (long long)fCycle);
+    }
+
+    fOffset += record->fSize;
+    fCycle++;
+    return record;
+}
+
+void JackReplayDriver::ReplayTransport(const JackCycleRecordHeader* record)
+{
+    JackTransportEngine& transport = fEngineControl->fTransport;
+    bool rolling = (record->fTransportState == JackTransportRolling || record->fTransportState == JackTransportStarting);
+    bool was_rolling = (fTransportState == JackTransportRolling || fTransportState == JackTransportStarting);
+    jack_nframes_t expected = fPosition.frame + ((fTransportState == JackTransportRolling) ? record->fFrames : 0);
+
+    // Commands take effect at the end of the cycle, as those of the clients
+    if (rolling && !was_rolling) {
+        transport.SetCommand(TransportCommandStart);
+    } else if (!rolling && was_rolling) {
+        transport.SetCommand(TransportCommandStop);
+    }
+
+    // Locate when the recorded position jumped, or at the first cycle
+    if (fCycle == 1 || record->fPosition.frame != expected) {
+        jack_position_t pos;
+        memcpy(&pos, &record->fPosition, sizeof(pos));
+        transport.RequestNewPos(&pos);
+    }
+
+    memcpy(&fPosition, &record->fPosition, sizeof(fPosition));
+    fTransportState = record->fTransportState;
+}
+
+int JackReplayDriver::ReplayMidi(const char* data, const char* end)
+{
+    for (uint32_t i = 0; i < fHeader->fMidiChannels; i++) {
+        JackMidiBuffer* buffer = (JackMidiBuffer*)fGraphManager->GetBuffer(fMidiCapturePortList[i], fEngineControl->fBufferSize);
+        uint32_t count;
+
+        buffer->Reset(fEngineControl->fBufferSize);
+        if (data + sizeof(uint32_t) > end) {
+            return -1;
+        }
+        memcpy(&count, data, sizeof(uint32_t));
+        data += sizeof(uint32_t);
+
+        for (uint32_t j = 0; j < count; j++) {
+            JackCycleMidiEvent event;
+            if (data + sizeof(event) > end) {
+                return -1;
+            }
+            memcpy(&event, data, sizeof(event));
+            data += sizeof(event);
+            if (data + event.fSize > end) {
+                return -1;
+            }
+            jack_midi_data_t* dest = buffer->ReserveEvent(event.fTime, event.fSize);
+            if (dest) {
+                memcpy(dest, data, event.fSize);
+            }
+            data += (event.fSize + 3) & ~3;
+        }
+    }
+    return 0;
+}
+
+int JackReplayDriver::Read()
+{
+    const JackCycleRecordHeader* record = NextRecord();
+    size_t audio_size = fEngineControl->fBufferSize * sizeof(jack_default_audio_sample_t);
+
+    if (record == NULL) {
+        // Silence once the file is played
+        for (int i = 0; i < fCaptureChannels; i++) {
+            memset(GetInputBuffer(i), 0, audio_size);
+        }
+        for (uint32_t i = 0; i < fHeader->fMidiChannels; i++) {
+            ((JackMidiBuffer*)fGraphManager->GetBuffer(fMidiCapturePortList[i], fEngineControl->fBufferSize))->Reset(fEngineControl->fBufferSize);
+        }
+        return 0;
+    }
+
+    const char* data = (const char*)(record + 1);
+    const char* end = (const char*)record + record->fSize;
+
+    if (data + audio_size * fCaptureChannels > end) {
+        jack_error("JackReplayDriver: audio data missing at cycle %lld", (long long)fCycle);
+        fFinished = true;
+        return 0;
+    }
+    for (int i = 0; i < fCaptureChannels; i++) {
+        memcpy(GetInputBuffer(i), data, audio_size);
+        data += audio_size;
+    }
+
+    if (ReplayMidi(data, end) < 0) {
+        jack_error("JackReplayDriver: MIDI data missing at cycle %lld", (long long)fCycle);
+        fFinished = true;
+    }
+
+    ReplayTransport(record);
+    return 0;
+}
+
+} // end of namespace
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    SERVER_EXPORT jack_driver_desc_t * driver_get_descriptor () {
+        jack_driver_desc_t * desc;
+        jack_driver_desc_filler_t filler;
+        jack_driver_param_value_t value;
+
+        desc = jack_driver_descriptor_construct("replay", JackDriverMaster, "Plays a file recorded with the server --record option", &filler);
+
+        strcpy(value.str, "");
+        jack_driver_descriptor_add_parameter(desc, &filler, "file", 'f', JackDriverParamString, &value, NULL, "Cycle record file", NULL);
+
+        value.ui = 2U;
+        jack_driver_descriptor_add_parameter(desc, &filler, "playback", 'P', JackDriverParamUInt, &value, NULL, "Number of playback ports", NULL);
+
+        value.i = 0;
+        jack_driver_descriptor_add_parameter(desc, &filler, "monitor", 'm', JackDriverParamBool, &value, NULL, "Provide monitor ports for the output", NULL);
+
+        value.i = 0;
+        jack_driver_descriptor_add_parameter(desc, &filler, "loop", 'l', JackDriverParamBool, &value, NULL, "Play the file again when it ends", NULL);
+
+        value.i = 0;
+        jack_driver_descriptor_add_parameter(desc, &filler, "virtual-time", 'V', JackDriverParamBool, &value, NULL, "Run cycles back-to-back on a virtual clock", "Run cycles back-to-back on a virtual clock advanced by one period per cycle, as fast as the graph allows, needs the server in synchronous mode");
+
+        return desc;
+    }
+
+    SERVER_EXPORT Jack::JackDriverClientInterface* driver_initialize(Jack::JackLockedEngine* engine, Jack::JackSynchro* table, const JSList* params) {
+        const char* path = NULL;
+        unsigned int playback_ports = 2;
+        bool monitor = false;
+        bool loop = false;
+        bool virtual_time = false;
+        const JSList * node;
+        const jack_driver_param_t * param;
+
+        for (node = params; node; node = jack_slist_next (node)) {
+            param = (const jack_driver_param_t *) node->data;
+
+            switch (param->character) {
+
+                case 'f':
+                    path = param->value.str;
+                    break;
+
+                case 'P':
+                    playback_ports = param->value.ui;
+                    break;
+
+                case 'm':
+                    monitor = param->value.i;
+                    break;
+
+                case 'l':
+                    loop = param->value.i;
+                    break;
+
+                case 'V':
+                    virtual_time = param->value.i;
+                    break;
+            }
+        }
+
+        if (path == NULL || path[0] == 0) {
+            jack_error("replay: a file has to be given with -f");
+            return NULL;
+        }
+
+        Jack::JackReplayDriver* replay_driver = new Jack::JackReplayDriver("system", "replay_pcm", engine, table);
+        replay_driver->SetVirtualTime(virtual_time);
+        Jack::JackDriverClientInterface* driver = new Jack::JackThreadedDriver(replay_driver);
+        if (replay_driver->Open(path, loop, playback_ports, monitor, "replay", "replay") == 0) {
+            return driver;
+        } else {
+            delete driver;
+            return NULL;
+        }
+    }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,100 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackReplayDriver__
+#define __JackReplayDriver__
+
+#include "JackTimedDriver.h"
+#include "JackCycleRecorder.h"
+#include "driver_interface.h"
+
+namespace Jack
+{
+
+/*!
+\brief The replay driver.
+
+Plays a file recorded with the server --record option: the capture ports get the recorded audio and MIDI of each
+cycle and the transport follows the recorded state. The file is mapped in memory. With virtual time, cycles run
+back-to-back so that the same workload can be profiled again and again with the same dates.
+*/
+
+class JackReplayDriver : public JackTimedDriver
+{
+
+    private:
+
+        char fPath[JACK_PATH_MAX + 1];
+        char* fMap;
+        size_t fMapSize;
+        const JackCycleFileHeader* fHeader;
+        size_t fOffset;
+        UInt64 fCycle;
+        bool fLoop;
+        bool fFinished;
+        jack_port_id_t fMidiCapturePortList[DRIVER_PORT_NUM];
+        jack_position_t fPosition;          // Transport position of the previous replayed cycle
+        uint32_t fTransportState;
+
+        void Unmap();
+        const JackCycleRecordHeader* NextRecord();
+        void ReplayTransport(const JackCycleRecordHeader* record);
+        int ReplayMidi(const char* data, const char* end);
+
+    public:
+
+        JackReplayDriver(const char* name, const char* alias, JackLockedEngine* engine, JackSynchro* table);
+        virtual ~JackReplayDriver();
+
+        int Open(const char* path,
+                 bool loop,
+                 int outchannels,
+                 bool monitor,
+                 const char* capture_driver_name,
+                 const char* playback_driver_name);
+        int Close();
+
+        int Attach();
+        int Detach();
+
+        int Read();
+
+        // The recorded buffers have a fixed size
+        bool IsFixedBufferSize()
+        {
+            return true;
+        }
+
+        virtual int Process()
+        {
+            JackDriver::CycleTakeBeginTime();
+
+            if (JackAudioDriver::Process() < 0) {
+                return -1;
+            } else {
+                ProcessWait();
+                return 0;
+            }
+        }
+
+};
+
+} // end of namespace
+
+#endif
@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackChannel.h"
 #include "JackTime.h"
 #include "types.h"
+#include "JackMetadata.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -89,7 +90,8 @@ struct JackRequest
         kReserveClientName = 36,
         kGetUUIDByClient = 37,
         kClientHasSessionCallback = 38,
-        kComputeTotalLatencies = 39
+        kComputeTotalLatencies = 39,
+        kMetadata = 40
     };
 
     RequestType fType;
@@ -1562,6 +1564,58 @@ struct JackClientHasSessionCallbackRequest : public JackRequest
     
 };
 
+/*!
+\brief Metadata change request.
+*/
+
+struct JackMetadataRequest : public JackRequest
+{
+    int fRefNum;
+    int fAction;
+    jack_uuid_t fSubject;
+    char fKey[METADATA_KEY_SIZE];
+    char fType[METADATA_TYPE_SIZE];
+    char fValue[METADATA_VALUE_SIZE];
+
+    JackMetadataRequest()
+    {}
+
+    JackMetadataRequest(int refnum, int action, jack_uuid_t subject, const char* key, const char* value, const char* type)
+            : JackRequest(JackRequest::kMetadata), fRefNum(refnum), fAction(action), fSubject(subject)
+    {
+        snprintf(fKey, sizeof(fKey), "%s", (key) ? key : "");
+        snprintf(fValue, sizeof(fValue), "%s", (value) ? value : "");
+        snprintf(fType, sizeof(fType), "%s", (type) ? type : "");
+    }
+
+    int Read(detail::JackChannelTransactionInterface* trans)
+    {
+        CheckSize();
+        CheckRes(trans->Read(&fRefNum, sizeof(int)));
+        CheckRes(trans->Read(&fAction, sizeof(int)));
+        CheckRes(trans->Read(&fSubject, sizeof(jack_uuid_t)));
+        CheckRes(trans->Read(&fKey, sizeof(fKey)));
+        CheckRes(trans->Read(&fType, sizeof(fType)));
+        CheckRes(trans->Read(&fValue, sizeof(fValue)));
+        return 0;
+    }
+
+    int Write(detail::JackChannelTransactionInterface* trans)
+    {
+        CheckRes(JackRequest::Write(trans, Size()));
+        CheckRes(trans->Write(&fRefNum, sizeof(int)));
+        CheckRes(trans->Write(&fAction, sizeof(int)));
+        CheckRes(trans->Write(&fSubject, sizeof(jack_uuid_t)));
+        CheckRes(trans->Write(&fKey, sizeof(fKey)));
+        CheckRes(trans->Write(&fType, sizeof(fType)));
+        CheckRes(trans->Write(&fValue, sizeof(fValue)));
+        return 0;
+    }
+
+    int Size() { return 2 * sizeof(int) + sizeof(jack_uuid_t) + sizeof(fKey) + sizeof(fType) + sizeof(fValue); }
+
+};
+
 /*!
 \brief ClientNotification.
 */
@@ -338,6 +338,16 @@ int JackRequestDecoder::HandleRequest(detail::JackChannelTransactionInterface* s
             break;
         }
 
+        case JackRequest::kMetadata: {
+            jack_log("JackRequest::Metadata");
+            JackMetadataRequest req;
+            JackResult res;
+            CheckRead(req, socket);
+            res.fResult = fServer->GetEngine()->MetadataChange(req.fRefNum, req.fAction, req.fSubject, req.fKey, req.fValue, req.fType);
+            CheckWrite("JackRequest::Metadata", socket);
+            break;
+        }
+
         default:
             jack_error("Unknown request %ld", type);
             return -1;
@@ -42,7 +42,7 @@ namespace Jack
 //----------------
 // Server control 
 //----------------
-JackServer::JackServer(bool sync, bool temporary, int timeout, bool rt, int priority, int port_max, bool verbose, jack_timer_type_t clock, char self_connect_mode, const char* server_name)
+JackServer::JackServer(bool sync, bool temporary, int timeout, bool rt, int priority, int port_max, bool verbose, jack_timer_type_t clock, char self_connect_mode, const char* server_name, int pipeline)
 {
     if (rt) {
         jack_info("JACK server starting in realtime mode with priority %ld", priority);
@@ -52,8 +52,15 @@ JackServer::JackServer(bool sync, bool temporary, int timeout, bool rt, int prio
 
     jack_info("self-connect-mode is \"%s\"", jack_get_self_connect_mode_description(self_connect_mode));
 
-    fGraphManager = JackGraphManager::Allocate(port_max);
+    // A pipelined graph keeps the buffers of the output ports of the cycles in flight, one more in asynchronous mode
+    if (pipeline > 1) {
+        jack_info("Graph pipelined in %ld stages, adding %ld periods of latency", pipeline, pipeline - 1);
+        fGraphManager = JackGraphManager::Allocate(port_max, (sync) ? pipeline : pipeline + 1);
+    } else {
+        fGraphManager = JackGraphManager::Allocate(port_max, 1);
+    }
     fEngineControl = new JackEngineControl(sync, temporary, timeout, rt, priority, verbose, clock, server_name);
+    fEngineControl->fPipelineDepth = (pipeline > 1) ? pipeline : 1;
     fEngine = new JackLockedEngine(fGraphManager, GetSynchroTable(), fEngineControl, self_connect_mode);
 
     // A distinction is made between the threaded freewheel driver and the
@@ -66,6 +73,7 @@ JackServer::JackServer(bool sync, bool temporary, int timeout, bool rt, int prio
     fFreewheelDriver = freewheelDriver;
     fDriverInfo = new JackDriverInfo();
     fAudioDriver = NULL;
+    fCycleRecorder = NULL;
     fFreewheel = false;
     JackServerGlobals::fInstance = this;   // Unique instance
     JackServerGlobals::fUserCount = 1;     // One user
@@ -140,6 +148,7 @@ fail_close1:
 int JackServer::Close()
 {
     jack_log("JackServer::Close");
+    StopRecording();
     fRequestChannel.Close();
     fAudioDriver->Detach();
     fAudioDriver->Close();
@@ -182,6 +191,89 @@ int JackServer::Stop()
     return res;
 }
 
+/*
+The driver thread is pinned to the first CPU of the set and the client RT threads to the CPUs the engine gives them.
+The calling thread leaves the set, so that the non RT threads the server creates afterwards stay off these CPUs.
+*/
+int JackServer::SetCPUAffinity(const char* cpus, char policy)
+{
+    // The CPU set is built in a local array, fields of the packed engine control cannot be passed by address
+    int cpu_set[RT_CPU_NUM];
+    int count = JackTools::ParseCPUList(cpus, cpu_set, RT_CPU_NUM);
+    if (count <= 0) {
+        jack_error("Bad RT CPU list \"%s\"", cpus);
+        return -1;
+    }
+    if (policy != JACK_CPU_POLICY_ROUND_ROBIN && policy != JACK_CPU_POLICY_LEVEL) {
+        jack_error("Bad RT CPU policy '%c'", policy);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        fEngineControl->fRTCPUs[i] = cpu_set[i];
+    }
+    fEngineControl->fRTCPUCount = count;
+    fEngineControl->fRTCPUPolicy = policy;
+    jack_info("RT threads use %d CPUs from CPU %d with the %s policy", count, fEngineControl->fRTCPUs[0],
+              (policy == JACK_CPU_POLICY_LEVEL) ? "level" : "round-robin");
+
+    if (JackThread::ExcludeSelfAffinityImp(cpu_set, count) < 0) {
+        jack_error("Cannot keep the non RT threads off the RT CPUs");
+    }
+    return 0;
+}
+
+/*
+RT threads try SCHED_DEADLINE with the buffer period and fall back to SCHED_FIFO when the kernel refuses it.
+*/
+int JackServer::SetDeadline(bool onoff)
+{
+    if (onoff && fEngineControl->fRTCPUCount > 0) {
+        jack_error("Deadline scheduling cannot be used with RT CPUs, SCHED_DEADLINE threads cannot be pinned");
+        return -1;
+    }
+
+    fEngineControl->fDeadline = onoff;
+    if (onoff) {
+        jack_info("RT threads use deadline scheduling when the kernel allows it");
+    }
+    return 0;
+}
+
+/*
+RT threads of the server and of the clients flush denormals to zero, clients may change it for their own threads.
+*/
+int JackServer::SetFlushDenormals(bool onoff)
+{
+    fEngineControl->fFlushDenormals = onoff;
+    if (onoff) {
+        jack_info("RT threads flush denormals to zero");
+    }
+    return 0;
+}
+
+int JackServer::StartRecording(const char* path)
+{
+    JackCycleRecorder* recorder = new JackCycleRecorder();
+    if (recorder->Open(path, fAudioDriver->GetClientControl()->fRefNum, fGraphManager, fEngineControl) < 0) {
+        delete recorder;
+        return -1;
+    }
+    StopRecording();
+    fCycleRecorder = recorder;
+    fEngine->SetCycleRecorder(recorder);
+    return 0;
+}
+
+void JackServer::StopRecording()
+{
+    if (fCycleRecorder) {
+        fEngine->SetCycleRecorder(NULL);
+        delete fCycleRecorder;
+        fCycleRecorder = NULL;
+    }
+}
+
 bool JackServer::IsRunning()
 {
     jack_log("JackServer::IsRunning");
@@ -287,12 +379,15 @@ int JackServer::SetFreewheel(bool onoff)
             fEngine->NotifyFreewheel(onoff);
             fFreewheelDriver->SetMaster(false);
             fAudioDriver->SetMaster(true);
+            fEngine->SetCycleRecorder(fCycleRecorder);
             return fAudioDriver->Start();
         }
     } else {
         if (onoff) {
             fFreewheel = true;
             fAudioDriver->Stop();
+            // Capture buffers are not read during freewheel mode
+            fEngine->SetCycleRecorder(NULL);
             fGraphManager->Save(&fConnectionState);     // Save connection state
             // Disconnect all slaves
             std::list<JackDriverInterface*> slave_list = fAudioDriver->GetSlaves();
@@ -373,8 +468,12 @@ int JackServer::SwitchMaster(jack_driver_desc_t* driver_desc, JSList* driver_par
     std::list<JackDriverInterface*> slave_list;
     std::list<JackDriverInterface*>::const_iterator it;
     
-    // Remove current master
+    // Remove current master, recorded ports belong to it
     fAudioDriver->Stop();
+    if (fCycleRecorder) {
+        jack_info("Cycle recording stopped by the master switch");
+        StopRecording();
+    }
     fAudioDriver->Detach();
     fAudioDriver->Close();
 
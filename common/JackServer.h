@@ -38,6 +38,7 @@ class JackDriverClientInterface;
 struct JackEngineControl;
 class JackLockedEngine;
 class JackLoadableInternalClient;
+class JackCycleRecorder;
 
 /*!
 \brief The Jack server.
@@ -58,13 +59,14 @@ class SERVER_EXPORT JackServer
         JackServerChannel fRequestChannel;
         JackConnectionManager fConnectionState;
         JackSynchro fSynchroTable[CLIENT_NUM];
+        JackCycleRecorder* fCycleRecorder;
         bool fFreewheel;
 
         int InternalClientLoadAux(JackLoadableInternalClient* client, const char* so_name, const char* client_name, int options, int* int_ref, int uuid, int* status);
 
     public:
 
-        JackServer(bool sync, bool temporary, int timeout, bool rt, int priority, int port_max, bool verbose, jack_timer_type_t clock, char self_connect_mode, const char* server_name);
+        JackServer(bool sync, bool temporary, int timeout, bool rt, int priority, int port_max, bool verbose, jack_timer_type_t clock, char self_connect_mode, const char* server_name, int pipeline = 1);
         ~JackServer();
 
         // Server control
@@ -76,6 +78,15 @@ class SERVER_EXPORT JackServer
         
         bool IsRunning();
 
+        // Scheduling of the RT threads, set before Open()
+        int SetCPUAffinity(const char* cpus, char policy);
+        int SetDeadline(bool onoff);
+        int SetFlushDenormals(bool onoff);
+
+        // Cycle recording, started before Start()
+        int StartRecording(const char* path);
+        void StopRecording();
+
         // RT thread
         void Notify(int refnum, int notify, int value);
 
@@ -105,12 +105,20 @@ class SERVER_EXPORT JackThreadInterface
         int DropRealTime();                     // Used when called from another thread
         int DropSelfRealTime();                 // Used when called from thread itself
 
+        int SetAffinity(const int* cpus, int count);        // Used when called from another thread, no CPU for the process affinity
+        int SetSelfAffinity(const int* cpus, int count);    // Used when called from thread itself, no CPU for the process affinity
+
+        int AcquireSelfDeadline(UInt64 runtime, UInt64 period);    // Used when called from thread itself
+
         jack_native_thread_t GetThreadID();
         bool IsThread();
 
         static int AcquireRealTimeImp(jack_native_thread_t thread, int priority);
         static int AcquireRealTimeImp(jack_native_thread_t thread, int priority, UInt64 period, UInt64 computation, UInt64 constraint);
         static int DropRealTimeImp(jack_native_thread_t thread);
+        static int SetAffinityImp(jack_native_thread_t thread, const int* cpus, int count);
+        static int ExcludeSelfAffinityImp(const int* cpus, int count);
+        static int AcquireSelfDeadlineImp(UInt64 runtime, UInt64 deadline, UInt64 period);
         static int StartImp(jack_native_thread_t* thread, int priority, int realtime, void*(*start_routine)(void*), void* arg);
         static int StopImp(jack_native_thread_t thread);
         static int KillImp(jack_native_thread_t thread);
@@ -122,7 +130,7 @@ class SERVER_EXPORT JackThreadInterface
 
 bool jack_get_thread_realtime_priority_range(int * min_ptr, int * max_ptr);
 
-bool jack_tls_allocate_key(jack_tls_key *key_ptr);
+bool jack_tls_allocate_key(jack_tls_key *key_ptr, void (*destructor)(void*) = NULL);
 bool jack_tls_free_key(jack_tls_key key);
 
 bool jack_tls_set(jack_tls_key key, void *data_ptr);
@@ -24,6 +24,7 @@
 #include "JackTools.h"
 #include "JackGlobals.h"
 #include "JackEngineControl.h"
+#include "JackDenormals.h"
 
 namespace Jack
 {
@@ -262,7 +263,17 @@ void JackThreadedDriver::SetRealTime()
         GetEngineControl()->fPeriod = GetEngineControl()->fConstraint = GetEngineControl()->fPeriodUsecs * 1000;
         GetEngineControl()->fComputation = JackTools::ComputationMicroSec(GetEngineControl()->fBufferSize) * 1000;
         fThread.SetParams(GetEngineControl()->fPeriod, GetEngineControl()->fComputation, GetEngineControl()->fConstraint);
-        if (fThread.AcquireSelfRealTime(GetEngineControl()->fServerPriority) < 0) {
+        // Parameters follow the buffer size since the thread is started again when it changes
+        bool deadline = false;
+        if (GetEngineControl()->fDeadline) {
+            deadline = (fThread.AcquireSelfDeadline(GetEngineControl()->DeadlineRuntime(0), GetEngineControl()->fPeriod) == 0);
+            if (!deadline) {
+                jack_info("Deadline scheduling refused, driver thread falls back to SCHED_FIFO");
+            }
+        }
+        if (deadline) {
+            set_threaded_log_function();
+        } else if (fThread.AcquireSelfRealTime(GetEngineControl()->fServerPriority) < 0) {
             jack_error("AcquireSelfRealTime error");
         } else {
             set_threaded_log_function();
@@ -270,6 +281,18 @@ void JackThreadedDriver::SetRealTime()
     } else {
         jack_log("JackThreadedDriver::Init non-realtime");
     }
+
+    // The driver thread takes the first CPU of the RT core set
+    if (GetEngineControl()->fRTCPUCount > 0) {
+        int cpu = GetEngineControl()->fRTCPUs[0];
+        if (fThread.SetSelfAffinity(&cpu, 1) < 0) {
+            jack_error("SetSelfAffinity error");
+        }
+    }
+
+    if (!SetFlushDenormals(GetEngineControl()->fFlushDenormals)) {
+        jack_log("JackThreadedDriver::Init denormals cannot be flushed on this CPU");
+    }
 }
 
 
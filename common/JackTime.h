@@ -34,8 +34,12 @@ extern "C"
     SERVER_EXPORT jack_time_t GetMicroSeconds(void);
     SERVER_EXPORT void JackSleep(long usec);
 
+    SERVER_EXPORT jack_time_t GetThreadCPUNanoSeconds(void);
+
     void SetClockSource(jack_timer_type_t source);
     const char* ClockSourceName(jack_timer_type_t source);
+    SERVER_EXPORT void SetVirtualClock(volatile jack_time_t* clock);
+    SERVER_EXPORT int IsVirtualClock(void);
 
 #ifdef __cplusplus
 }
@@ -40,14 +40,60 @@ int JackTimedDriver::CurrentCycle(jack_time_t cur_time_usec)
     return int(((double(fCycleCount) * double(fEngineControl->fBufferSize) * 1000000.) / double(fEngineControl->fSampleRate)) - (cur_time_usec - fAnchorTimeUsec));
 }
 
+int JackTimedDriver::Attach()
+{
+    if (fVirtualTime) {
+        // Cycles are chained without waiting, the graph has to be completed in the cycle
+        if (!fEngineControl->fSyncMode) {
+            jack_error("JackTimedDriver::Attach virtual time needs the server in synchronous mode");
+            return -1;
+        }
+        // Back-to-back RT cycles would starve the server control threads, there is no deadline to meet anyway
+        if (fEngineControl->fRealTime) {
+            jack_info("JackTimedDriver: real-time scheduling is not used with virtual time");
+            fEngineControl->fRealTime = false;
+        }
+        // The server selects the clock source once the drivers are attached, clients when they open
+        fEngineControl->fVirtualTime = VIRTUAL_TIME_ORIGIN;
+        fEngineControl->fClockSource = JACK_TIMER_VIRTUAL;
+        SetVirtualClock(&fEngineControl->fVirtualTime);
+        jack_info("JackTimedDriver: running on virtual time");
+    }
+    return JackAudioDriver::Attach();
+}
+
 int JackTimedDriver::Start()
 {
     fCycleCount = 0;
+    if (fVirtualTime) {
+        SetClockSource(JACK_TIMER_VIRTUAL);
+    }
     return JackAudioDriver::Start();
 }
 
+int JackTimedDriver::Stop()
+{
+    if (fVirtualTime) {
+        // The engine control may be released before the time functions are called again
+        SetClockSource(JACK_TIMER_SYSTEM_CLOCK);
+    }
+    return JackAudioDriver::Stop();
+}
+
+void JackTimedDriver::ProcessVirtualWait()
+{
+    // Dates are computed from the frame count so that they do not depend on rounding of previous cycles
+    fVirtualFrames += fEngineControl->fBufferSize;
+    fEngineControl->fVirtualTime = VIRTUAL_TIME_ORIGIN + (fVirtualFrames * 1000000) / fEngineControl->fSampleRate;
+}
+
 void JackTimedDriver::ProcessWait()
 {
+    if (fVirtualTime) {
+        ProcessVirtualWait();
+        return;
+    }
+
     jack_time_t cur_time_usec = GetMicroSeconds();
     int wait_time_usec;
 
@@ -26,8 +26,14 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 namespace Jack
 {
 
+#define VIRTUAL_TIME_ORIGIN 1000000   // Not 0 which marks dates that did not happen
+
 /*!
 \brief The timed driver.
+
+In virtual time mode the driver does not sleep: the clock source is switched to a virtual clock which is advanced by
+exactly one period at the end of each cycle, so that cycles run back-to-back as soon as the graph is processed and
+give the same dates from one run to another.
 */
 
 class SERVER_EXPORT JackTimedDriver : public JackAudioDriver
@@ -36,16 +42,20 @@ class SERVER_EXPORT JackTimedDriver : public JackAudioDriver
 
         int fCycleCount;
         jack_time_t fAnchorTimeUsec;
+        bool fVirtualTime;
+        UInt64 fVirtualFrames;
 
         int FirstCycle(jack_time_t cur_time);
         int CurrentCycle(jack_time_t cur_time);
 
         void ProcessWait();
+        void ProcessVirtualWait();
 
     public:
 
         JackTimedDriver(const char* name, const char* alias, JackLockedEngine* engine, JackSynchro* table)
-                : JackAudioDriver(name, alias, engine, table), fCycleCount(0), fAnchorTimeUsec(0)
+                : JackAudioDriver(name, alias, engine, table), fCycleCount(0), fAnchorTimeUsec(0),
+                fVirtualTime(false), fVirtualFrames(0)
         {}
         virtual ~JackTimedDriver()
         {}
@@ -56,7 +66,14 @@ class SERVER_EXPORT JackTimedDriver : public JackAudioDriver
             return false;
         }
 
+        void SetVirtualTime(bool onoff)
+        {
+            fVirtualTime = onoff;
+        }
+
+        int Attach();
         int Start();
+        int Stop();
 
 };
 
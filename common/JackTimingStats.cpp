@@ -0,0 +1,173 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackTimingStats.h"
+#include "JackConnectionManager.h"
+#include <string.h>
+
+namespace Jack
+{
+
+static void FullBarrier()
+{
+#if defined(__GNUC__)
+    __sync_synchronize();
+#else
+    MemoryBarrier();
+#endif
+}
+
+void JackTimingHistogram::Reset()
+{
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        fCounts[i] = 0;
+    }
+    fMax = 0;
+}
+
+int JackTimingHistogram::Index(UInt32 value)
+{
+    if (value < HISTOGRAM_LINEAR) {
+        return value;
+    }
+
+    int exponent = HISTOGRAM_SUB_BITS + 1;
+    while ((value >> (exponent + 1)) != 0) {
+        exponent++;
+    }
+    int shift = exponent - HISTOGRAM_SUB_BITS;
+    return HISTOGRAM_LINEAR
+        + (exponent - HISTOGRAM_SUB_BITS - 1) * HISTOGRAM_SUB_COUNT
+        + ((value >> shift) & (HISTOGRAM_SUB_COUNT - 1));
+}
+
+UInt32 JackTimingHistogram::UpperBound(int index)
+{
+    if (index < HISTOGRAM_LINEAR) {
+        return index;
+    }
+
+    int shift = (index - HISTOGRAM_LINEAR) / HISTOGRAM_SUB_COUNT + 1;
+    UInt32 sub = (index - HISTOGRAM_LINEAR) % HISTOGRAM_SUB_COUNT;
+    return ((HISTOGRAM_SUB_COUNT + sub + 1) << shift) - 1;
+}
+
+void JackTimingHistogram::GetDistribution(jack_timing_distribution_t* distribution) const
+{
+    UInt32 counts[HISTOGRAM_BUCKETS];
+    UInt64 total = 0;
+    UInt32 max = fMax;
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        counts[i] = fCounts[i];
+        total += counts[i];
+    }
+
+    memset(distribution, 0, sizeof(jack_timing_distribution_t));
+    distribution->count = total;
+    distribution->max = max;
+    if (total == 0) {
+        return;
+    }
+
+    // Rank of each percentile, rounded up
+    UInt64 ranks[3] = { (total * 500 + 999) / 1000, (total * 990 + 999) / 1000, (total * 999 + 999) / 1000 };
+    jack_time_t* values[3] = { &distribution->p50, &distribution->p99, &distribution->p999 };
+    UInt64 cumulated = 0;
+    int rank = 0;
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS && rank < 3; i++) {
+        cumulated += counts[i];
+        while (rank < 3 && cumulated >= ranks[rank]) {
+            UInt32 bound = UpperBound(i);
+            *values[rank++] = (bound < max) ? bound : max;
+        }
+    }
+}
+
+void JackClientTimingStats::Init(const char* name)
+{
+    // Plain stores, see JackCycleProfiler about using no CAS in packed shared memory
+    fCounter++;
+    FullBarrier();
+    strncpy(fName, (name) ? name : "", JACK_CLIENT_NAME_SIZE);
+    fName[JACK_CLIENT_NAME_SIZE] = 0;
+    fProcess.Reset();
+    fWakeup.Reset();
+    fSpinHits = 0;
+    fSpinMisses = 0;
+    fWorkersUsecs = 0;
+    FullBarrier();
+    fCounter++;
+}
+
+void JackClientTimingStats::Add(const JackClientTiming* timing)
+{
+    jack_time_t signaled_at = timing->fSignaledAt;
+    jack_time_t awake_at = timing->fAwakeAt;
+    jack_time_t finished_at = timing->fFinishedAt;
+
+    fWorkersUsecs += timing->fWorkersUsecs;
+
+    // Drivers are not woken up by the graph, and a client may finish without having been woken up in this cycle
+    if (awake_at == 0 || finished_at < awake_at) {
+        return;
+    }
+
+    fProcess.Add(finished_at - awake_at);
+    if (signaled_at > 0 && awake_at >= signaled_at) {
+        fWakeup.Add(awake_at - signaled_at);
+    }
+}
+
+bool JackClientTimingStats::Match(const char* name)
+{
+    UInt32 counter;
+    bool res;
+    do {
+        counter = fCounter;
+        FullBarrier();
+        res = (fName[0] != 0 && strncmp(fName, name, JACK_CLIENT_NAME_SIZE) == 0);
+        FullBarrier();
+    } while ((counter & 1) || counter != fCounter);
+    return res;
+}
+
+void JackClientTimingStats::GetName(char* name, size_t size)
+{
+    UInt32 counter;
+    do {
+        counter = fCounter;
+        FullBarrier();
+        strncpy(name, fName, size);
+        name[size - 1] = 0;
+        FullBarrier();
+    } while ((counter & 1) || counter != fCounter);
+}
+
+void JackClientTimingStats::GetStats(jack_client_timing_stats_t* stats) const
+{
+    fProcess.GetDistribution(&stats->process);
+    fWakeup.GetDistribution(&stats->wakeup);
+    stats->spin_hits = fSpinHits;
+    stats->spin_misses = fSpinMisses;
+    stats->workers_usecs = fWorkersUsecs;
+}
+
+} // end of namespace
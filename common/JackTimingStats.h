@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackTimingStats__
+#define __JackTimingStats__
+
+#include "JackConstants.h"
+#include "JackTypes.h"
+#include "JackCompilerDeps.h"
+#include "types.h"
+#include "statistics.h"
+
+namespace Jack
+{
+
+struct JackClientTiming;
+
+#define HISTOGRAM_SUB_BITS 4                                // 16 sub-buckets per power of two
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_LINEAR (2 * HISTOGRAM_SUB_COUNT)          // Values below are counted exactly
+#define HISTOGRAM_MAX_BITS 24                               // Values are clamped to 2^24 usecs
+#define HISTOGRAM_BUCKETS (HISTOGRAM_LINEAR + (HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS - 1) * HISTOGRAM_SUB_COUNT)
+
+/*!
+\brief Log-linear histogram of durations in microseconds.
+
+Values below HISTOGRAM_LINEAR have their own bucket, above each power of two is split in HISTOGRAM_SUB_COUNT buckets,
+so that a percentile is known within 1 / HISTOGRAM_SUB_COUNT. There is a single writer, readers may see an update
+partially done which does not matter for statistics.
+*/
+
+PRE_PACKED_STRUCTURE
+struct SERVER_EXPORT JackTimingHistogram
+{
+    volatile UInt32 fCounts[HISTOGRAM_BUCKETS];
+    volatile UInt32 fMax;
+
+    void Reset();
+
+    // RT
+    void Add(jack_time_t value)
+    {
+        UInt32 usecs = (value < (1 << HISTOGRAM_MAX_BITS)) ? UInt32(value) : (1 << HISTOGRAM_MAX_BITS) - 1;
+        fCounts[Index(usecs)]++;
+        if (usecs > fMax) {
+            fMax = usecs;
+        }
+    }
+
+    static int Index(UInt32 value);
+    static UInt32 UpperBound(int index);
+
+    // Client
+    void GetDistribution(jack_timing_distribution_t* distribution) const;
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief Process callback duration, wakeup latency, spin wait and worker counters of a client, kept in the graph manager.
+*/
+
+PRE_PACKED_STRUCTURE
+struct SERVER_EXPORT JackClientTimingStats
+{
+    MEM_ALIGN(volatile UInt32 fCounter, CACHE_LINE_SIZE);  // Odd while the entry is (re)initialized, each entry on its own cache lines
+    char fName[JACK_CLIENT_NAME_SIZE + 1];
+    JackTimingHistogram fProcess;  // Finished - awake
+    JackTimingHistogram fWakeup;   // Awake - signaled
+    volatile UInt32 fSpinHits;     // Activations seen while spinning, see JackClient::SpinWait
+    volatile UInt32 fSpinMisses;   // Spins that ended blocking on the synchro
+    volatile UInt64 fWorkersUsecs; // Time spent by the worker threads, see jack_client_parallel_for
+
+    // Server
+    void Init(const char* name);
+
+    // RT
+    void Add(const JackClientTiming* timing);
+
+    // Client
+    bool Match(const char* name);
+    void GetName(char* name, size_t size);
+    void GetStats(jack_client_timing_stats_t* stats) const;
+
+} POST_PACKED_STRUCTURE;
+
+} // end of namespace
+
+#endif
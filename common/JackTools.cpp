@@ -240,6 +240,45 @@ namespace Jack {
         new_name[i] = '\0';
     }
 
+    /*!
+    \brief Parses a CPU list like "2-5,7" in cpus, returns the CPU count or -1 if the list is malformed or too long.
+    */
+    int JackTools::ParseCPUList(const char* list, int* cpus, int max)
+    {
+        int count = 0;
+        const char* cur = list;
+
+        while (*cur) {
+            char* end;
+            long first = strtol(cur, &end, 10);
+            long last = first;
+            if (end == cur || first < 0) {
+                return -1;
+            }
+            if (*end == '-') {
+                cur = end + 1;
+                last = strtol(cur, &end, 10);
+                if (end == cur || last < first) {
+                    return -1;
+                }
+            }
+            for (long cpu = first; cpu <= last; cpu++) {
+                if (count == max) {
+                    return -1;
+                }
+                cpus[count++] = int(cpu);
+            }
+            if (*end == ',') {
+                end++;
+            } else if (*end != 0) {
+                return -1;
+            }
+            cur = end;
+        }
+
+        return count;
+    }
+
 #ifdef WIN32
 
 void BuildClientPath(char* path_to_so, int path_len, const char* so_name)
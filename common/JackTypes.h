@@ -40,6 +40,7 @@ typedef uint16_t jack_int_t;  // Internal type for ports and refnum
 typedef enum {
 	JACK_TIMER_SYSTEM_CLOCK,
 	JACK_TIMER_HPET,
+	JACK_TIMER_VIRTUAL,     // Advanced by the driver, see SetVirtualClock
 } jack_timer_type_t;
 
 typedef enum {
@@ -23,6 +23,9 @@
 #include <jack/session.h>
 #include <jack/thread.h>
 #include <jack/midiport.h>
+#include <jack/graph.h>
+#include <jack/profiler.h>
+#include <jack/statistics.h>
 #include <math.h>
 #ifndef WIN32
 #include <dlfcn.h>
@@ -164,6 +167,9 @@ DECL_FUNCTION(int, jack_set_client_registration_callback, (jack_client_t *client
 DECL_FUNCTION(int, jack_set_port_registration_callback, (jack_client_t *client,
                                             JackPortRegistrationCallback registration_callback,
                                             void *arg), (client, registration_callback, arg));
+DECL_FUNCTION(int, jack_set_port_registration_batch_callback, (jack_client_t *client,
+                                            JackPortRegistrationBatchCallback registration_callback,
+                                            void *arg), (client, registration_callback, arg));
 DECL_FUNCTION(int, jack_set_port_connect_callback, (jack_client_t *client,
                                             JackPortConnectCallback connect_callback,
                                             void *arg), (client, connect_callback, arg));
@@ -226,6 +232,8 @@ DECL_FUNCTION(jack_nframes_t, jack_get_buffer_size, (jack_client_t *client), (cl
 DECL_FUNCTION_NULL(const char**, jack_get_ports, (jack_client_t *client, const char *port_name_pattern, const char * type_name_pattern,
                                              unsigned long flags), (client, port_name_pattern, type_name_pattern, flags));
 DECL_FUNCTION_NULL(jack_port_t *, jack_port_by_name, (jack_client_t * client, const char *port_name), (client, port_name));
+DECL_FUNCTION_NULL(jack_graph_snapshot_t *, jack_graph_snapshot, (jack_client_t * client), (client));
+DECL_FUNCTION(uint32_t, jack_graph_epoch, (jack_client_t * client), (client));
 DECL_FUNCTION_NULL(jack_port_t *, jack_port_by_id, (jack_client_t *client, jack_port_id_t port_id), (client, port_id));
 
 DECL_FUNCTION(int, jack_engine_takeover_timebase, (jack_client_t * client), (client));
@@ -242,6 +250,10 @@ DECL_VOID_FUNCTION(jack_set_info_function, (print_function fun), (fun));
 
 DECL_FUNCTION(float, jack_get_max_delayed_usecs, (jack_client_t *client), (client));
 DECL_FUNCTION(float, jack_get_xrun_delayed_usecs, (jack_client_t *client), (client));
+DECL_FUNCTION(uint32_t, jack_get_xrun_count, (jack_client_t *client), (client));
+DECL_FUNCTION_NULL(jack_xrun_report_t*, jack_get_xrun_report, (jack_client_t *client, uint32_t sequence), (client, sequence));
+DECL_FUNCTION(int, jack_client_get_timing_stats, (jack_client_t *client, const char *client_name, jack_client_timing_stats_t *stats), (client, client_name, stats));
+DECL_FUNCTION(int, jack_get_graph_stats, (jack_client_t *client, jack_graph_stats_t *stats), (client, stats));
 DECL_VOID_FUNCTION(jack_reset_max_delayed_usecs, (jack_client_t *client), (client));
 
 DECL_FUNCTION(int, jack_release_timebase, (jack_client_t *client), (client));
@@ -273,6 +285,11 @@ DECL_FUNCTION(int, jack_drop_real_time_scheduling, (jack_native_thread_t thread)
 
 DECL_FUNCTION(int, jack_client_stop_thread, (jack_client_t* client, jack_native_thread_t thread), (client, thread));
 DECL_FUNCTION(int, jack_client_kill_thread, (jack_client_t* client, jack_native_thread_t thread), (client, thread));
+DECL_FUNCTION(int, jack_client_set_cpu_affinity, (jack_client_t* client, const int* cpus, int count), (client, cpus, count));
+DECL_FUNCTION(int, jack_client_set_spin_wait, (jack_client_t* client, jack_time_t max_usecs), (client, max_usecs));
+DECL_FUNCTION(int, jack_client_create_workers, (jack_client_t* client, int count), (client, count));
+DECL_FUNCTION(int, jack_client_parallel_for, (jack_client_t* client, unsigned int count, JackParallelCallback callback, void* arg), (client, count, callback, arg));
+DECL_FUNCTION(int, jack_client_set_flush_denormals, (jack_client_t* client, int onoff), (client, onoff));
 #ifndef WIN32
 DECL_VOID_FUNCTION(jack_set_thread_creator, (jack_thread_creator_t jtc), (jtc));
 #endif
@@ -308,3 +325,11 @@ DECL_FUNCTION(size_t, jack_midi_max_event_size, (void* port_buffer), (port_buffe
 DECL_FUNCTION_NULL(jack_midi_data_t*, jack_midi_event_reserve, (void* port_buffer, jack_nframes_t time, size_t data_size), (port_buffer, time, data_size));
 DECL_FUNCTION(int, jack_midi_event_write, (void* port_buffer, jack_nframes_t time, const jack_midi_data_t* data, size_t data_size), (port_buffer, time, data, data_size));
 DECL_FUNCTION(jack_nframes_t, jack_midi_get_lost_event_count, (void* port_buffer), (port_buffer));
+
+// Cycle profiler
+DECL_FUNCTION_NULL(jack_profiler_t*, jack_profiler_open, (jack_client_t* client), (client));
+DECL_VOID_FUNCTION(jack_profiler_close, (jack_profiler_t* profiler), (profiler));
+DECL_FUNCTION(int, jack_profiler_enable, (jack_profiler_t* profiler, int onoff), (profiler, onoff));
+DECL_FUNCTION(int, jack_profiler_is_enabled, (jack_profiler_t* profiler), (profiler));
+DECL_FUNCTION(int, jack_profiler_read, (jack_profiler_t* profiler, jack_profiler_cycle_t* cycle), (profiler, cycle));
+DECL_FUNCTION(int, jack_profiler_client_name, (jack_profiler_t* profiler, int refnum, char* name, size_t size), (profiler, refnum, name, size));
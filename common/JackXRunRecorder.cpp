@@ -0,0 +1,367 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackXRunRecorder.h"
+#include "JackClientInterface.h"
+#include "JackClientControl.h"
+#include "JackEngineControl.h"
+#include "JackGraphManager.h"
+#include "JackTime.h"
+#include "JackError.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Jack
+{
+
+static const char* State2String(int state)
+{
+    switch (state) {
+        case NotTriggered:
+            return "NotTriggered";
+        case Triggered:
+            return "Triggered";
+        case Running:
+            return "Running";
+        case Finished:
+            return "Finished";
+        default:
+            return "";
+    }
+}
+
+static const char* Source2String(int source)
+{
+    return (source == JackXRunGraph) ? "graph not finished" : "driver";
+}
+
+JackXRunRecorder::JackXRunRecorder()
+{
+    fCycleIndex = 0;
+    fXRunCount = 0;
+    for (int i = 0; i < XRUN_CYCLES; i++) {
+        fCycles[i].fIndex = XRUN_INVALID;
+        fCycles[i].fClientCount = 0;
+    }
+    for (int i = 0; i < XRUN_REPORTS; i++) {
+        fReports[i].fSequence = XRUN_INVALID;
+    }
+}
+
+void JackXRunRecorder::CopyCycle(JackCycleTimings* dst, const JackCycleTimings* src)
+{
+    memcpy(dst, src, sizeof(JackCycleTimings) - sizeof(JackCycleTiming) * (CLIENT_NUM - src->fClientCount));
+}
+
+void JackXRunRecorder::Record(JackClientInterface** table,
+                              JackGraphManager* manager,
+                              JackEngineControl* control,
+                              jack_time_t cur_cycle_begin,
+                              jack_time_t prev_cycle_end)
+{
+    // The ring is only used by the RT thread
+    JackCycleTimings* cycle = &fCycles[fCycleIndex & XRUN_MASK];
+    JackCycleProfiler::FillCycle(cycle, table, manager, control, cur_cycle_begin, prev_cycle_end);
+    cycle->fIndex = fCycleIndex++;
+}
+
+/*
+Clients to blame are the ones that were not finished when the XRun was detected, and for a graph XRun,
+the ones that finished after the callback date.
+*/
+void JackXRunRecorder::Report(int source,
+                              JackClientInterface** table,
+                              JackGraphManager* manager,
+                              JackEngineControl* control,
+                              jack_time_t callback_usecs)
+{
+    UInt32 sequence = fXRunCount + 1;
+    JackXRunReport* report = &fReports[sequence % XRUN_REPORTS];
+    JackTimer timer;
+
+    // Readers of the previous content of the report will see it changed
+    report->fSequence = XRUN_INVALID;
+    FullBarrier();
+
+    report->fSource = source;
+    report->fDate = GetMicroSeconds();
+    report->fDelayedUsecs = control->fXrunDelayedUsecs;
+    report->fMaxDelayedUsecs = control->fMaxDelayedUsecs;
+    control->ReadFrameTime(&timer);
+    // Fields of the packed report cannot be passed by address
+    jack_nframes_t frames;
+    jack_time_t current_wakeup, next_wakeup;
+    float period_usecs;
+    if (timer.GetCycleTimes(&frames, &current_wakeup, &next_wakeup, &period_usecs) < 0) {
+        frames = 0;
+        current_wakeup = next_wakeup = 0;
+        period_usecs = 0.f;
+    }
+    report->fFrames = frames;
+    report->fCurrentWakeup = current_wakeup;
+    report->fNextWakeup = next_wakeup;
+    report->fPeriodUsecs = period_usecs;
+
+    report->fBlamedCount = 0;
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        JackClientInterface* client = table[i];
+        if (client && client->GetClientControl()->fActive) {
+            strcpy(report->fNames[i], client->GetClientControl()->fName);
+            JackClientTiming* timing = manager->GetClientTiming(i);
+            jack_client_state_t status = timing->fStatus;
+            if (i >= control->fDriverNum
+                && ((status != NotTriggered && status != Finished)
+                    || (callback_usecs > 0 && status == Finished && (long)(timing->fFinishedAt - callback_usecs) > 0))) {
+                JackCycleTiming* blamed = &report->fBlamed[report->fBlamedCount++];
+                blamed->fRefNum = i;
+                blamed->fStatus = status;
+                blamed->fSignaledAt = timing->fSignaledAt;
+                blamed->fAwakeAt = timing->fAwakeAt;
+                blamed->fFinishedAt = timing->fFinishedAt;
+            }
+        } else {
+            report->fNames[i][0] = 0;
+        }
+    }
+
+    // Recorded cycles, oldest first
+    report->fCycleCount = 0;
+    for (UInt32 i = fCycleIndex - XRUN_CYCLES; i != fCycleIndex; i++) {
+        JackCycleTimings* cycle = &fCycles[i & XRUN_MASK];
+        if (cycle->fIndex == i && i != XRUN_INVALID) {
+            CopyCycle(&report->fCycles[report->fCycleCount++], cycle);
+        }
+    }
+
+    // The report is complete before being published, see JackCycleProfiler about using no CAS
+    FullBarrier();
+    report->fSequence = sequence;
+    fXRunCount = sequence;
+}
+
+/*
+Returns 0 when the report has been copied, -1 when there is no such report,
+and -2 when it has been overwritten.
+*/
+int JackXRunRecorder::Read(UInt32 sequence, JackXRunReport* report)
+{
+    UInt32 count = fXRunCount;
+    if (sequence == 0) {
+        sequence = count;
+    }
+    if (sequence == 0 || sequence > count) {
+        return -1;
+    }
+    if (count - sequence >= XRUN_REPORTS) {
+        return -2;
+    }
+
+    JackXRunReport* src = &fReports[sequence % XRUN_REPORTS];
+    if (src->fSequence != sequence) {
+        return -2;
+    }
+    FullBarrier();
+    memcpy(report, src, sizeof(JackXRunReport));
+    FullBarrier();
+    if (src->fSequence != sequence) {
+        return -2;
+    }
+
+    if (report->fBlamedCount > CLIENT_NUM) {
+        report->fBlamedCount = CLIENT_NUM;
+    }
+    if (report->fCycleCount > XRUN_CYCLES) {
+        report->fCycleCount = XRUN_CYCLES;
+    }
+    for (UInt32 i = 0; i < report->fCycleCount; i++) {
+        if (report->fCycles[i].fClientCount > CLIENT_NUM) {
+            report->fCycles[i].fClientCount = CLIENT_NUM;
+        }
+    }
+    return 0;
+}
+
+static void CopyClient(jack_xrun_client_t* dst, const JackCycleTiming* src, char** names)
+{
+    dst->refnum = src->fRefNum;
+    dst->name = (src->fRefNum >= 0 && src->fRefNum < CLIENT_NUM) ? names[src->fRefNum] : "";
+    dst->status = src->fStatus;
+    dst->signaled_at = src->fSignaledAt;
+    dst->awake_at = src->fAwakeAt;
+    dst->finished_at = src->fFinishedAt;
+}
+
+jack_xrun_report_t* JackXRunRecorder::GetReport(UInt32 sequence)
+{
+    JackXRunReport* report = (JackXRunReport*)malloc(sizeof(JackXRunReport));
+    if (!report) {
+        return NULL;
+    }
+    if (Read(sequence, report) < 0) {
+        free(report);
+        return NULL;
+    }
+
+    // A single block: the report, the cycles, the blamed clients and the clients of each cycle, then the names
+    size_t client_count = report->fBlamedCount;
+    size_t strings_size = 1;
+    for (UInt32 i = 0; i < report->fCycleCount; i++) {
+        client_count += report->fCycles[i].fClientCount;
+    }
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        report->fNames[i][JACK_CLIENT_NAME_SIZE] = 0;
+        strings_size += strlen(report->fNames[i]) + 1;
+    }
+
+    size_t size = sizeof(jack_xrun_report_t)
+                + report->fCycleCount * sizeof(jack_xrun_cycle_t)
+                + client_count * sizeof(jack_xrun_client_t)
+                + strings_size;
+
+    jack_xrun_report_t* res = (jack_xrun_report_t*)malloc(size);
+    if (!res) {
+        free(report);
+        return NULL;
+    }
+
+    jack_xrun_cycle_t* cycles = (jack_xrun_cycle_t*)(res + 1);
+    jack_xrun_client_t* clients = (jack_xrun_client_t*)(cycles + report->fCycleCount);
+    char* strings = (char*)(clients + client_count);
+    char* names[CLIENT_NUM];
+
+    // Empty names share the same string
+    *strings = 0;
+    char* string = strings + 1;
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        if (report->fNames[i][0]) {
+            strcpy(string, report->fNames[i]);
+            names[i] = string;
+            string += strlen(string) + 1;
+        } else {
+            names[i] = strings;
+        }
+    }
+
+    res->version = JACK_XRUN_REPORT_VERSION;
+    res->size = size;
+    res->sequence = report->fSequence;
+    res->source = report->fSource;
+    res->date = report->fDate;
+    res->delayed_usecs = report->fDelayedUsecs;
+    res->max_delayed_usecs = report->fMaxDelayedUsecs;
+    res->dll_frames = report->fFrames;
+    res->dll_current_wakeup = report->fCurrentWakeup;
+    res->dll_next_wakeup = report->fNextWakeup;
+    res->dll_period_usecs = report->fPeriodUsecs;
+
+    res->blamed_count = report->fBlamedCount;
+    res->blamed = clients;
+    for (UInt32 i = 0; i < report->fBlamedCount; i++) {
+        CopyClient(clients++, &report->fBlamed[i], names);
+    }
+
+    res->cycle_count = report->fCycleCount;
+    res->cycles = cycles;
+    for (UInt32 i = 0; i < report->fCycleCount; i++) {
+        JackCycleTimings* src = &report->fCycles[i];
+        jack_xrun_cycle_t* dst = &cycles[i];
+        dst->period_usecs = src->fPeriodUsecs;
+        dst->cycle_begin = src->fCycleBegin;
+        dst->cycle_end = src->fCycleEnd;
+        dst->next_cycle_begin = src->fNextCycleBegin;
+        dst->cpu_load = src->fCPULoad;
+        dst->client_count = src->fClientCount;
+        dst->clients = clients;
+        for (UInt32 j = 0; j < src->fClientCount; j++) {
+            CopyClient(clients++, &src->fClients[j], names);
+        }
+    }
+
+    free(report);
+    return res;
+}
+
+static long Relative(jack_time_t date, jack_time_t begin)
+{
+    return (date >= begin && date > 0) ? long(date - begin) : -1;
+}
+
+int JackXRunRecorder::Dump(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        jack_error("JackXRunRecorder::Dump cannot open %s file", path);
+        return -1;
+    }
+
+    UInt32 count = fXRunCount;
+    UInt32 first = (count > XRUN_REPORTS) ? count - XRUN_REPORTS + 1 : 1;
+    fprintf(file, "%u xrun(s) since server start\n", count);
+
+    for (UInt32 sequence = first; sequence <= count && sequence > 0; sequence++) {
+        jack_xrun_report_t* report = GetReport(sequence);
+        if (!report) {
+            continue;
+        }
+        jack_time_t origin = (report->cycle_count > 0) ? report->cycles[report->cycle_count - 1].cycle_begin : report->date;
+
+        fprintf(file, "\nxrun %u (%s) at %llu usecs: delayed = %.0f usecs, max delayed = %.0f usecs\n",
+                report->sequence, Source2String(report->source), (unsigned long long)report->date,
+                report->delayed_usecs, report->max_delayed_usecs);
+        fprintf(file, "DLL: frames = %u, current wakeup = %llu, next wakeup = %llu, period = %.1f usecs\n",
+                report->dll_frames, (unsigned long long)report->dll_current_wakeup,
+                (unsigned long long)report->dll_next_wakeup, report->dll_period_usecs);
+
+        fprintf(file, "blamed clients (dates relative to the last cycle begin):\n");
+        for (uint32_t i = 0; i < report->blamed_count; i++) {
+            jack_xrun_client_t* client = &report->blamed[i];
+            fprintf(file, "    %-32s state = %-12s signaled = %6ld awake = %6ld finished = %6ld\n",
+                    client->name, State2String(client->status),
+                    Relative(client->signaled_at, origin),
+                    Relative(client->awake_at, origin),
+                    Relative(client->finished_at, origin));
+        }
+
+        fprintf(file, "last cycles (dates relative to each cycle begin):\n");
+        for (uint32_t i = 0; i < report->cycle_count; i++) {
+            jack_xrun_cycle_t* cycle = &report->cycles[i];
+            fprintf(file, "    cycle at %llu: period = %ld end = %ld next = %ld DSP load = %.2f %%\n",
+                    (unsigned long long)cycle->cycle_begin, (long)cycle->period_usecs,
+                    Relative(cycle->cycle_end, cycle->cycle_begin),
+                    Relative(cycle->next_cycle_begin, cycle->cycle_begin),
+                    cycle->cpu_load);
+            for (uint32_t j = 0; j < cycle->client_count; j++) {
+                jack_xrun_client_t* client = &cycle->clients[j];
+                fprintf(file, "        %-32s state = %-12s signaled = %6ld awake = %6ld finished = %6ld\n",
+                        client->name, State2String(client->status),
+                        Relative(client->signaled_at, cycle->cycle_begin),
+                        Relative(client->awake_at, cycle->cycle_begin),
+                        Relative(client->finished_at, cycle->cycle_begin));
+            }
+        }
+        free(report);
+    }
+
+    fclose(file);
+    jack_info("XRun reports written in %s", path);
+    return 0;
+}
+
+} // end of namespace
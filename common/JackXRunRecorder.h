@@ -0,0 +1,121 @@
+/*
+Copyright (C) 2026 agent
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackXRunRecorder__
+#define __JackXRunRecorder__
+
+#include "JackCycleProfiler.h"
+#include "statistics.h"
+
+namespace Jack
+{
+
+#define XRUN_CYCLES 16              // Must be a power of two
+#define XRUN_MASK (XRUN_CYCLES - 1)
+#define XRUN_REPORTS 8
+#define XRUN_INVALID 0xFFFFFFFF
+
+/*!
+\brief State of the server when an XRun occurred.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackXRunReport
+{
+    volatile UInt32 fSequence;      // XRun number, XRUN_INVALID while being written
+    SInt32 fSource;
+    jack_time_t fDate;
+    float fDelayedUsecs;
+    float fMaxDelayedUsecs;
+    jack_nframes_t fFrames;         // DLL state
+    jack_time_t fCurrentWakeup;
+    jack_time_t fNextWakeup;
+    float fPeriodUsecs;
+    UInt32 fBlamedCount;
+    JackCycleTiming fBlamed[CLIENT_NUM];
+    UInt32 fCycleCount;
+    JackCycleTimings fCycles[XRUN_CYCLES];  // Oldest first
+    char fNames[CLIENT_NUM][JACK_CLIENT_NAME_SIZE + 1];
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief XRun flight recorder in shared memory.
+
+The server RT thread always keeps the timings of the last XRUN_CYCLES cycles. When an XRun is detected, either by the
+driver or because the graph did not finish in time, they are copied in a report with the clients to blame, the driver
+delay and the DLL state. The last XRUN_REPORTS reports are kept; readers check the report sequence number did not change
+while copying it, as for the cycle profiler.
+*/
+
+PRE_PACKED_STRUCTURE
+class SERVER_EXPORT JackXRunRecorder : public JackShmMem
+{
+
+    private:
+
+        UInt32 fCycleIndex;
+        JackCycleTimings fCycles[XRUN_CYCLES];
+        volatile UInt32 fXRunCount;
+        JackXRunReport fReports[XRUN_REPORTS];
+
+        static void FullBarrier()
+        {
+        #if defined(__GNUC__)
+            __sync_synchronize();
+        #else
+            MemoryBarrier();
+        #endif
+        }
+
+        static void CopyCycle(JackCycleTimings* dst, const JackCycleTimings* src);
+
+    public:
+
+        JackXRunRecorder();
+
+        UInt32 GetXRunCount() const
+        {
+            return fXRunCount;
+        }
+
+        // RT
+        void Record(JackClientInterface** table,
+                    JackGraphManager* manager,
+                    JackEngineControl* control,
+                    jack_time_t cur_cycle_begin,
+                    jack_time_t prev_cycle_end);
+        void Report(int source,
+                    JackClientInterface** table,
+                    JackGraphManager* manager,
+                    JackEngineControl* control,
+                    jack_time_t callback_usecs);
+
+        // Client
+        int Read(UInt32 sequence, JackXRunReport* report);
+        jack_xrun_report_t* GetReport(UInt32 sequence);
+
+        // Server
+        int Dump(const char* path);
+
+} POST_PACKED_STRUCTURE;
+
+} // end of namespace
+
+#endif
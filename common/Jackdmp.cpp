@@ -202,6 +202,11 @@ static void usage(FILE* file, jackctl_server_t *server, bool full = true)
             "               [ --slave-backend OR -X slave-backend-name ]\n"
             "               [ --internal-client OR -I internal-client-name ]\n"
             "               [ --verbose OR -v ]\n"
+            "               [ --record OR -C cycle-record-file ]\n"
+            "               [ --rt-cpus OR -A cpu-list [ --rt-cpu-policy OR -O r(ound-robin) | l(evel) ] ]\n"
+            "               [ --deadline OR -D ]\n"
+            "               [ --flush-denormals OR -Z ]\n"
+            "               [ --pipeline OR -N stages ]\n"
 #ifdef __linux__
             "               [ --clocksource OR -c [ h(pet) | s(ystem) ]\n"
 #endif
@@ -249,7 +254,7 @@ int main(int argc, char** argv)
     jackctl_driver_t * master_driver_ctl;
     jackctl_driver_t * loopback_driver_ctl = NULL;
     int replace_registry = 0;
-    const char *options = "-d:X:I:P:uvshVrRL:STFl:t:mn:p:"
+    const char *options = "-d:X:I:P:uvshVrRL:STFl:t:mn:p:C:A:O:DZN:"
         "a:"
 #ifdef __linux__
         "c:"
@@ -281,6 +286,12 @@ int main(int argc, char** argv)
                                        { "silent", 0, 0, 's' },
                                        { "sync", 0, 0, 'S' },
                                        { "autoconnect", 1, 0, 'a' },
+                                       { "record", 1, 0, 'C' },
+                                       { "rt-cpus", 1, 0, 'A' },
+                                       { "rt-cpu-policy", 1, 0, 'O' },
+                                       { "deadline", 0, 0, 'D' },
+                                       { "flush-denormals", 0, 0, 'Z' },
+                                       { "pipeline", 1, 0, 'N' },
                                        { 0, 0, 0, 0 }
                                    };
 
@@ -429,6 +440,59 @@ int main(int argc, char** argv)
                 }
                 break;
 
+            case 'C':
+                param = jackctl_get_parameter(server_parameters, "record");
+                if (param != NULL) {
+                    strncpy(value.str, optarg, JACK_PARAM_STRING_MAX);
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
+            case 'A':
+                param = jackctl_get_parameter(server_parameters, "rt-cpus");
+                if (param != NULL) {
+                    strncpy(value.str, optarg, JACK_PARAM_STRING_MAX);
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
+            case 'O':
+                param = jackctl_get_parameter(server_parameters, "rt-cpu-policy");
+                if (param != NULL) {
+                    value.c = tolower(optarg[0]);
+                    if (value.c == JACK_CPU_POLICY_ROUND_ROBIN || value.c == JACK_CPU_POLICY_LEVEL) {
+                        jackctl_parameter_set_value(param, &value);
+                    } else {
+                        usage(stdout, server_ctl);
+                        goto destroy_server;
+                    }
+                }
+                break;
+
+            case 'D':
+                param = jackctl_get_parameter(server_parameters, "deadline");
+                if (param != NULL) {
+                    value.b = true;
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
+            case 'Z':
+                param = jackctl_get_parameter(server_parameters, "flush-denormals");
+                if (param != NULL) {
+                    value.b = true;
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
+            case 'N':
+                param = jackctl_get_parameter(server_parameters, "pipeline");
+                if (param != NULL) {
+                    value.ui = atoi(optarg);
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
             case 'P':
                 param = jackctl_get_parameter(server_parameters, "realtime-priority");
                 if (param != NULL) {
@@ -0,0 +1,128 @@
+/*
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation; either version 2.1 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __jack_graph_h__
+#define __jack_graph_h__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <jack/types.h>
+#include <jack/weakmacros.h>
+
+/**
+ * @defgroup GraphSnapshot Whole graph snapshot
+ * @{
+ */
+
+/**
+ * Version of the jack_graph_snapshot_t layout. It is increased
+ * each time fields are added to the snapshot structures.
+ */
+#define JACK_GRAPH_SNAPSHOT_VERSION 1
+
+/**
+ * An opened client, with or without ports.
+ */
+typedef struct {
+    /** Client name. */
+    const char* name;
+    /** Index of the first port of this client in the ports array. */
+    uint32_t first_port;
+    /** Number of ports of this client, stored contiguously, possibly 0. */
+    uint32_t port_count;
+} jack_graph_client_t;
+
+/**
+ * A port, with its connections.
+ */
+typedef struct {
+    /** Port ID, as used by jack_port_by_id(). */
+    jack_port_id_t id;
+    /** Index of the owning client in the clients array. */
+    uint32_t client;
+    /** Port flags (see JackPortFlags). */
+    unsigned long flags;
+    /** Full port name. */
+    const char* name;
+    /** Port type. */
+    const char* type;
+    /** Port aliases, NULL when not set. */
+    const char* aliases[2];
+    /** Capture and playback latency ranges. */
+    jack_latency_range_t capture_latency;
+    jack_latency_range_t playback_latency;
+    /** Total latency (deprecated latency API). */
+    jack_nframes_t total_latency;
+    /** Index of the first connected port in the connections array. */
+    uint32_t first_connection;
+    /** Number of ports connected to this port. */
+    uint32_t connection_count;
+} jack_graph_port_t;
+
+/**
+ * A coherent view of the whole graph. The snapshot is made of a single
+ * memory block: all pointers point inside the block, which has to be
+ * released with jack_free().
+ */
+typedef struct {
+    /** JACK_GRAPH_SNAPSHOT_VERSION of the library that built the snapshot. */
+    uint32_t version;
+    /** Total size of the memory block in bytes. */
+    uint32_t size;
+    /** Graph epoch the snapshot was taken at, see jack_graph_epoch(). */
+    uint32_t epoch;
+    uint32_t client_count;
+    uint32_t port_count;
+    uint32_t connection_count;
+    jack_graph_client_t* clients;
+    jack_graph_port_t* ports;
+    /**
+     * Indexes in the ports array of the connected ports. Each connection
+     * appears twice: once for the source port and once for the destination port.
+     */
+    uint32_t* connections;
+} jack_graph_snapshot_t;
+
+/**
+ * Take a snapshot of all clients, ports, aliases, latencies and
+ * connections. It is read directly from the server shared memory,
+ * without any server round trip.
+ *
+ * @return a snapshot to be released with jack_free(), or NULL on error.
+ */
+jack_graph_snapshot_t* jack_graph_snapshot (jack_client_t *client) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * @return the current graph epoch. The epoch changes each time a client is
+ * opened or closed, a port is registered, unregistered, renamed, aliased,
+ * connected or disconnected, or when port latencies change. Comparing it with the epoch of a previous
+ * snapshot is a cheap way for pollers to detect that nothing changed.
+ */
+uint32_t jack_graph_epoch (jack_client_t *client) JACK_OPTIONAL_WEAK_EXPORT;
+
+/*@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __jack_graph_h__ */
@@ -490,6 +490,26 @@ int jack_set_client_registration_callback (jack_client_t *client,
                                           JackPortRegistrationCallback
                                           registration_callback, void *arg) JACK_OPTIONAL_WEAK_EXPORT;
 
+/**
+ * Tell the JACK server to call @a registration_callback once for each
+ * batch of ports registered or unregistered together, passing @a arg as
+ * a parameter. Port registration notifications are queued by the server
+ * and delivered by batch, so that a client with a lot of ports does not
+ * cause one callback per port in patchbay applications.
+ *
+ * When both this callback and the one set with
+ * jack_set_port_registration_callback are set, only the batch callback
+ * is called.
+ *
+ * NOTE: this function cannot be called while the client is activated
+ * (after jack_activate has been called.)
+ *
+ * @return 0 on success, otherwise a non-zero error code
+ */
+int jack_set_port_registration_batch_callback (jack_client_t *client,
+                                               JackPortRegistrationBatchCallback
+                                               registration_callback, void *arg) JACK_OPTIONAL_WEAK_EXPORT;
+
  /**
  * Tell the JACK server to call @a connect_callback whenever a
  * port is connected or disconnected, passing @a arg as a parameter.
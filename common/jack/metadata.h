@@ -72,6 +72,9 @@ typedef struct {
  * Set a property on @p subject.
  *
  * See the above documentation for rules about @p subject and @p key.
+ * The properties of a port are removed when the port is unregistered,
+ * those of a client (subject parsed from jack_client_get_uuid()) when
+ * the client is closed.
  * @param subject The subject to set the property on.
  * @param key The key of the property.
  * @param value The value of the property.
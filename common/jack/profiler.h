@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation; either version 2.1 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __jack_profiler_h__
+#define __jack_profiler_h__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <jack/types.h>
+#include <jack/weakmacros.h>
+
+/**
+ * @defgroup CycleProfiler Live cycle profiler
+ * @{
+ */
+
+/**
+ * Scheduling state of a client at the end of a cycle.
+ */
+enum JackProfilerClientStatus {
+    JackProfilerNotTriggered = 0,
+    JackProfilerTriggered = 1,
+    JackProfilerRunning = 2,
+    JackProfilerFinished = 3
+};
+
+/**
+ * Timing of a client during a cycle. Dates are in microseconds,
+ * in the jack_get_time() time base, 0 when the step did not happen.
+ */
+typedef struct {
+    /** Reference number of the client, see jack_profiler_client_name(). */
+    int refnum;
+    /** A JackProfilerClientStatus value. */
+    int status;
+    /** Date the client was signaled by the previous client(s) in the graph. */
+    jack_time_t signaled_at;
+    /** Date the client process thread woke up. */
+    jack_time_t awake_at;
+    /** Date the client process callback returned. */
+    jack_time_t finished_at;
+    /**
+     * Thread CPU time in nanoseconds spent by the client from wake up to the
+     * signal of the next clients. Only measured when the server runs on the
+     * virtual clock (dummy driver -V), where all the dates of a cycle are equal, 0 otherwise.
+     */
+    jack_time_t cpu_nsecs;
+} jack_profiler_client_t;
+
+/**
+ * Timing of all active clients during a cycle.
+ */
+typedef struct {
+    /** Cycle number. */
+    uint32_t cycle;
+    /** Number of cycles lost by this reader since the previous read. */
+    uint32_t lost;
+    jack_time_t period_usecs;
+    jack_time_t cycle_begin;
+    /** Date the last client finished. */
+    jack_time_t cycle_end;
+    jack_time_t next_cycle_begin;
+    /** Server CPU load, see jack_cpu_load(). */
+    float cpu_load;
+    uint32_t client_count;
+    /** Timings, valid until the next jack_profiler_read() call. */
+    const jack_profiler_client_t* clients;
+} jack_profiler_cycle_t;
+
+typedef struct _jack_profiler jack_profiler_t;
+
+/**
+ * Attach to the cycle profiler of the server the client is connected to.
+ * Reading starts with the next profiled cycle.
+ *
+ * @return a profiler handle to be released with jack_profiler_close(), or NULL on error.
+ */
+jack_profiler_t* jack_profiler_open (jack_client_t *client) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Detach from the cycle profiler. If profiling was switched on with this
+ * handle, it is switched off.
+ */
+void jack_profiler_close (jack_profiler_t *profiler) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Switch profiling on or off in the server. Profiling is off when the
+ * server starts, and costs a copy of the timing of active clients at each
+ * cycle when it is on.
+ *
+ * @return 0 on success, otherwise a non-zero error code.
+ */
+int jack_profiler_enable (jack_profiler_t *profiler, int onoff) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * @return 1 if profiling is on, 0 otherwise.
+ */
+int jack_profiler_is_enabled (jack_profiler_t *profiler) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Read the next profiled cycle, without blocking. The server keeps a
+ * limited history: a reader that does not keep up loses cycles, which
+ * are counted in the lost field.
+ *
+ * @return 1 when a cycle was read, 0 when no new cycle is available,
+ * -1 on error.
+ */
+int jack_profiler_read (jack_profiler_t *profiler, jack_profiler_cycle_t *cycle) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Get the name of the client with the given reference number.
+ *
+ * @return 0 on success, otherwise a non-zero error code.
+ */
+int jack_profiler_client_name (jack_profiler_t *profiler, int refnum, char *name, size_t size) JACK_OPTIONAL_WEAK_EXPORT;
+
+/*@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __jack_profiler_h__ */
@@ -0,0 +1,252 @@
+/*
+  Copyright (C) 2000 Paul Davis
+  Copyright (C) 2003 Rohan Drape
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation; either version 2.1 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef _RINGBUFFER2_H
+#define _RINGBUFFER2_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <sys/types.h>
+#include <jack/types.h>
+#include <jack/ringbuffer.h>
+
+/** @file ringbuffer2.h
+ *
+ * A second lock-free ringbuffer, for the same single reader / single
+ * writer use case as jack_ringbuffer_t, tuned for heavy traffic between
+ * two threads running on different cores:
+ *
+ * - the read and write indexes live on separate cache lines, and each
+ *   side keeps a private copy of the other side index, refreshed only
+ *   when the cached value says there is not enough room or data. The
+ *   cache line holding an index is thus only transferred between cores
+ *   when the ringbuffer is close to full or empty.
+ *
+ * - indexes are published with release semantic and read with acquire
+ *   semantic, instead of relying on volatile accesses.
+ *
+ * - the whole buffer size is usable (jack_ringbuffer_t always keeps one
+ *   byte free).
+ *
+ * - multichannel audio can be copied in and out as interleaved frames
+ *   directly from/to per-channel (non interleaved) JACK port buffers.
+ *
+ * The type is opaque: use the functions below to access it.
+ */
+
+typedef struct jack_ringbuffer2 jack_ringbuffer2_t;
+
+/**
+ * Flags for jack_ringbuffer2_create().
+ */
+enum JackRingbuffer2Flags {
+    /** Lock the data block in memory, see jack_ringbuffer_mlock(). */
+    JackRingbuffer2Mlock = 0x01,
+    /**
+     * Try to back the data block with huge pages, to reduce TLB misses
+     * on large buffers. Silently falls back to regular pages when huge
+     * pages are not available.
+     */
+    JackRingbuffer2HugePages = 0x02
+};
+
+/**
+ * Allocates a ringbuffer data structure of a specified size. The
+ * caller must arrange for a call to jack_ringbuffer2_free() to release
+ * the memory associated with the ringbuffer.
+ *
+ * @param sz the ringbuffer size in bytes, rounded up to the next power of two.
+ * @param flags a combination of JackRingbuffer2Flags.
+ *
+ * @return a pointer to a new jack_ringbuffer2_t, if successful; NULL
+ * otherwise.
+ */
+jack_ringbuffer2_t *jack_ringbuffer2_create(size_t sz, int flags);
+
+/**
+ * Frees the ringbuffer data structure allocated by an earlier call to
+ * jack_ringbuffer2_create().
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ */
+void jack_ringbuffer2_free(jack_ringbuffer2_t *rb);
+
+/**
+ * @param rb a pointer to the ringbuffer structure.
+ *
+ * @return the ringbuffer size in bytes.
+ */
+size_t jack_ringbuffer2_size(const jack_ringbuffer2_t *rb);
+
+/**
+ * @param rb a pointer to the ringbuffer structure.
+ *
+ * @return JackRingbuffer2Flags that were actually honoured when the
+ * ringbuffer was created.
+ */
+int jack_ringbuffer2_flags(const jack_ringbuffer2_t *rb);
+
+/**
+ * Return the number of bytes available for reading. Must only be
+ * called from the reader thread.
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ *
+ * @return the number of bytes available to read.
+ */
+size_t jack_ringbuffer2_read_space(jack_ringbuffer2_t *rb);
+
+/**
+ * Return the number of bytes available for writing. Must only be
+ * called from the writer thread.
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ *
+ * @return the amount of free space (in bytes) available for writing.
+ */
+size_t jack_ringbuffer2_write_space(jack_ringbuffer2_t *rb);
+
+/**
+ * Fill a data structure with a description of the current readable
+ * data held in the ringbuffer, see jack_ringbuffer_get_read_vector().
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param vec a pointer to a 2 element array of jack_ringbuffer_data_t.
+ */
+void jack_ringbuffer2_get_read_vector(jack_ringbuffer2_t *rb, jack_ringbuffer_data_t *vec);
+
+/**
+ * Fill a data structure with a description of the current writable
+ * space in the ringbuffer, see jack_ringbuffer_get_write_vector().
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param vec a pointer to a 2 element array of jack_ringbuffer_data_t.
+ */
+void jack_ringbuffer2_get_write_vector(jack_ringbuffer2_t *rb, jack_ringbuffer_data_t *vec);
+
+/**
+ * Read data from the ringbuffer.
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param dest a pointer to a buffer where data read from the
+ * ringbuffer will go.
+ * @param cnt the number of bytes to read.
+ *
+ * @return the number of bytes read, which may range from 0 to cnt.
+ */
+size_t jack_ringbuffer2_read(jack_ringbuffer2_t *rb, char *dest, size_t cnt);
+
+/**
+ * Read data from the ringbuffer. Opposed to jack_ringbuffer2_read()
+ * this function does not move the read pointer.
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param dest a pointer to a buffer where data read from the
+ * ringbuffer will go.
+ * @param cnt the number of bytes to read.
+ *
+ * @return the number of bytes read, which may range from 0 to cnt.
+ */
+size_t jack_ringbuffer2_peek(jack_ringbuffer2_t *rb, char *dest, size_t cnt);
+
+/**
+ * Advance the read pointer, after data has been read in place using
+ * jack_ringbuffer2_get_read_vector().
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param cnt the number of bytes read.
+ */
+void jack_ringbuffer2_read_advance(jack_ringbuffer2_t *rb, size_t cnt);
+
+/**
+ * Write data into the ringbuffer.
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param src a pointer to the data to be written to the ringbuffer.
+ * @param cnt the number of bytes to write.
+ *
+ * @return the number of bytes write, which may range from 0 to cnt
+ */
+size_t jack_ringbuffer2_write(jack_ringbuffer2_t *rb, const char *src, size_t cnt);
+
+/**
+ * Advance the write pointer, after data has been written in place using
+ * jack_ringbuffer2_get_write_vector().
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param cnt the number of bytes written.
+ */
+void jack_ringbuffer2_write_advance(jack_ringbuffer2_t *rb, size_t cnt);
+
+/**
+ * Interleave and write audio frames into the ringbuffer. Only whole
+ * frames are written. Nothing is written when byte writes of a size
+ * that is not a multiple of a sample were made before: byte and frame
+ * calls must not be mixed on a ringbuffer.
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param channels an array of channel_count non interleaved buffers,
+ * typically the result of jack_port_get_buffer() on each port.
+ * @param channel_count the number of channels of a frame.
+ * @param nframes the number of frames to write.
+ *
+ * @return the number of frames written, which may range from 0 to nframes.
+ */
+jack_nframes_t jack_ringbuffer2_write_frames(jack_ringbuffer2_t *rb,
+                                             const jack_default_audio_sample_t* const* channels,
+                                             unsigned int channel_count,
+                                             jack_nframes_t nframes);
+
+/**
+ * Read and deinterleave audio frames from the ringbuffer. Only whole
+ * frames are read. Nothing is read when byte reads of a size that is
+ * not a multiple of a sample were made before: byte and frame calls
+ * must not be mixed on a ringbuffer.
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ * @param channels an array of channel_count non interleaved buffers.
+ * @param channel_count the number of channels of a frame.
+ * @param nframes the number of frames to read.
+ *
+ * @return the number of frames read, which may range from 0 to nframes.
+ */
+jack_nframes_t jack_ringbuffer2_read_frames(jack_ringbuffer2_t *rb,
+                                            jack_default_audio_sample_t* const* channels,
+                                            unsigned int channel_count,
+                                            jack_nframes_t nframes);
+
+/**
+ * Reset the read and write pointers, making an empty buffer.
+ *
+ * This is not thread safe.
+ *
+ * @param rb a pointer to the ringbuffer structure.
+ */
+void jack_ringbuffer2_reset(jack_ringbuffer2_t *rb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
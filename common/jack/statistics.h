@@ -50,6 +50,166 @@ float jack_get_xrun_delayed_usecs (jack_client_t *client);
  */
 void jack_reset_max_delayed_usecs (jack_client_t *client);
 
+/**
+ * Version of the jack_xrun_report_t layout. It is increased
+ * each time fields are added to the report structures.
+ */
+#define JACK_XRUN_REPORT_VERSION 1
+
+/**
+ * What detected the XRUN.
+ */
+enum JackXRunSource {
+    /** The backend woke up late, see jack_get_xrun_delayed_usecs(). */
+    JackXRunDriver = 0,
+    /** The graph was not finished when the next cycle began. */
+    JackXRunGraph = 1
+};
+
+/**
+ * Timing of a client during a cycle. Dates are in microseconds, in
+ * the jack_get_time() time base, 0 when the step did not happen.
+ */
+typedef struct {
+    int refnum;
+    /** Client name. */
+    const char* name;
+    /** 0: not triggered, 1: triggered, 2: running, 3: finished. */
+    int status;
+    jack_time_t signaled_at;
+    jack_time_t awake_at;
+    jack_time_t finished_at;
+} jack_xrun_client_t;
+
+/**
+ * Timing of all active clients during a cycle.
+ */
+typedef struct {
+    jack_time_t period_usecs;
+    jack_time_t cycle_begin;
+    jack_time_t cycle_end;
+    jack_time_t next_cycle_begin;
+    float cpu_load;
+    uint32_t client_count;
+    jack_xrun_client_t* clients;
+} jack_xrun_cycle_t;
+
+/**
+ * State of the server when an XRUN occurred. The report is made of a
+ * single memory block: all pointers point inside the block, which has
+ * to be released with jack_free().
+ */
+typedef struct {
+    /** JACK_XRUN_REPORT_VERSION of the library that built the report. */
+    uint32_t version;
+    /** Total size of the memory block in bytes. */
+    uint32_t size;
+    /** XRUN number since the server started, see jack_get_xrun_count(). */
+    uint32_t sequence;
+    /** A JackXRunSource value. */
+    int source;
+    /** Detection date. */
+    jack_time_t date;
+    float delayed_usecs;
+    float max_delayed_usecs;
+    /** Delay locked loop state, see jack_get_cycle_times(). */
+    jack_nframes_t dll_frames;
+    jack_time_t dll_current_wakeup;
+    jack_time_t dll_next_wakeup;
+    float dll_period_usecs;
+    /** Clients that were not finished, or finished after the next cycle began. */
+    uint32_t blamed_count;
+    jack_xrun_client_t* blamed;
+    /** Last cycles before the XRUN, oldest first. */
+    uint32_t cycle_count;
+    jack_xrun_cycle_t* cycles;
+} jack_xrun_report_t;
+
+/**
+ * @return the number of XRUNs the server recorded since it started.
+ */
+uint32_t jack_get_xrun_count (jack_client_t *client);
+
+/**
+ * Get the report of an XRUN. The server keeps the reports of the last
+ * XRUNs only. It can also write them to a file on SIGUSR1.
+ *
+ * @param sequence XRUN number as returned by jack_get_xrun_count(),
+ * or 0 for the most recent one.
+ *
+ * @return a report to be released with jack_free(), or NULL when there
+ * is no such report.
+ */
+jack_xrun_report_t* jack_get_xrun_report (jack_client_t *client, uint32_t sequence);
+
+/**
+ * Distribution of a duration in microseconds. Percentiles are computed
+ * from a log-linear histogram and are rounded up by at most 1/16th.
+ */
+typedef struct {
+    /** Number of measures. */
+    uint64_t count;
+    jack_time_t p50;
+    jack_time_t p99;
+    jack_time_t p999;
+    jack_time_t max;
+} jack_timing_distribution_t;
+
+/**
+ * Timing statistics of a client since it was opened.
+ */
+typedef struct {
+    /** Duration of the process callback, from wakeup to finish. */
+    jack_timing_distribution_t process;
+    /** Wakeup latency, from the date the client was signaled by the
+     previous client(s) in the graph to the date it woke up. */
+    jack_timing_distribution_t wakeup;
+    /** Cycles the client was activated while spinning, see
+     jack_client_set_spin_wait(). */
+    uint64_t spin_hits;
+    /** Cycles the client spun for its whole budget, then blocked. */
+    uint64_t spin_misses;
+    /** Time spent by the worker threads of the client, in addition to
+     the process callback, see jack_client_parallel_for(). */
+    uint64_t workers_usecs;
+} jack_client_timing_stats_t;
+
+/**
+ * Get the timing statistics of a client. They are maintained in
+ * shared memory by the process thread of each client at no cost for
+ * the server.
+ *
+ * @param client_name name of the client, or NULL for the calling client.
+ *
+ * @return 0 on success, otherwise a non-zero error code.
+ */
+int jack_client_get_timing_stats (jack_client_t *client, const char *client_name, jack_client_timing_stats_t *stats);
+
+/**
+ * Graph state changes seen by the server since it started. Connections
+ * and port registrations are prepared in a new graph state, which the
+ * server switches to at the beginning of a cycle, only when the
+ * previous cycle is finished.
+ */
+typedef struct {
+    /** Cycles that began with a new graph state. */
+    uint32_t switches;
+    /** Cycles that kept the current graph state because the previous
+     cycle was not finished (the server is "waiting to switch"). */
+    uint32_t waits;
+    /** Switches done after the time out although the previous cycle
+     was not finished. */
+    uint32_t forced_switches;
+} jack_graph_stats_t;
+
+/**
+ * Get the graph state change counters of the server. Compare two
+ * calls to measure the impact of graph edits on the real-time cycle.
+ *
+ * @return 0 on success, otherwise a non-zero error code.
+ */
+int jack_get_graph_stats (jack_client_t *client, jack_graph_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -86,6 +86,9 @@ int jack_acquire_real_time_scheduling (jack_native_thread_t thread, int priority
  * @param start_routine function the thread calls when it starts.
  * @param arg parameter passed to the @a start_routine.
  *
+ * A realtime thread flushes denormals to zero when the client does, see
+ * jack_client_set_flush_denormals().
+ *
  * @returns 0, if successful; otherwise some error number.
  */
 int jack_client_create_thread (jack_client_t* client,
@@ -122,6 +125,97 @@ int jack_client_stop_thread(jack_client_t* client, jack_native_thread_t thread)
  */
  int jack_client_kill_thread(jack_client_t* client, jack_native_thread_t thread) JACK_OPTIONAL_WEAK_EXPORT;
 
+/**
+ * Pin the realtime thread of a client to a set of CPUs, instead of the
+ * CPU given by the server when it was started with a RT core set
+ * (see the jackd --rt-cpus option). The setting is kept across
+ * deactivation and activation of the client.
+ *
+ * @param client the JACK client whose realtime thread is pinned.
+ * @param cpus array of CPU numbers.
+ * @param count number of CPUs in the array, 0 to go back to the CPU
+ * given by the server, or to the CPUs of the process when the server
+ * does not pin the client.
+ *
+ * @returns 0, if successful; otherwise -1.
+ */
+int jack_client_set_cpu_affinity(jack_client_t* client, const int* cpus, int count) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Let the realtime thread of a client spin before blocking when it
+ * waits for the next cycle, so that it starts without the wakeup
+ * latency of the kernel. The spin budget follows the measured waits
+ * and stays below max_usecs, the thread does not spin when the waits
+ * are longer than max_usecs. Spinning uses the CPU of
+ * the thread for nothing, it is meant for clients on dedicated cores
+ * (see jack_client_set_cpu_affinity). Spin hits and misses are counted
+ * in the client timing statistics.
+ *
+ * @param client the JACK client whose realtime thread spins.
+ * @param max_usecs bound of the spin budget in microseconds, 0 to block
+ * at once (the default).
+ *
+ * @returns 0, if successful; otherwise -1.
+ */
+int jack_client_set_spin_wait(jack_client_t* client, jack_time_t max_usecs) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Create worker threads for the client, to be used with
+ * jack_client_parallel_for(). Workers get the realtime priority of
+ * the client and are pinned to its CPUs: those set with
+ * jack_client_set_cpu_affinity(), otherwise the core set of the
+ * server when it has one. They are idle until the process callback
+ * gives them work. This function must be called before
+ * jack_activate() or after jack_deactivate().
+ *
+ * @param client the JACK client the workers belong to.
+ * @param count number of worker threads, 0 to stop the workers.
+ *
+ * @returns 0, if successful; otherwise -1.
+ */
+int jack_client_create_workers(jack_client_t* client, int count) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Call callback for each index from 0 to count - 1, spread over the
+ * calling thread and the worker threads of the client (see
+ * jack_client_create_workers()), and return once all calls have
+ * returned. Calls are made in any order, on any of the threads, and
+ * must not depend on each other. It is meant to be called from the
+ * process callback: it does not allocate nor lock, and the time spent
+ * by the workers is counted in the timing statistics of the client.
+ * Without workers, all calls are made by the calling thread. Only one
+ * call runs at a time: it fails when called from one of the callbacks
+ * of a running call, or from another thread while a call is running.
+ *
+ * @param client the JACK client whose workers are used.
+ * @param count number of calls.
+ * @param callback function called for each index.
+ * @param arg argument given to callback.
+ *
+ * @returns 0, if successful; otherwise -1.
+ */
+int jack_client_parallel_for(jack_client_t* client, unsigned int count, JackParallelCallback callback, void* arg) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Choose whether the realtime threads of a client flush denormal
+ * numbers to zero: its process thread, its worker threads (see
+ * jack_client_create_workers()) and the realtime threads created
+ * afterwards with jack_client_create_thread(). Filters and reverbs
+ * decaying to silence produce denormals, which some CPUs process
+ * many times slower than normal numbers. This sets the FTZ and DAZ
+ * modes of SSE on x86 (FTZ only on 32 bits x86) and the FZ mode on
+ * ARM, other CPUs are left unchanged. By default the client follows
+ * the server, see the flush-denormals server parameter. Running
+ * threads take the new mode at their next cycle.
+ *
+ * @param client the JACK client whose threads are set.
+ * @param onoff 1 to flush denormals to zero, 0 to keep them, -1 to
+ * follow the server.
+ *
+ * @returns 0, if successful; otherwise -1.
+ */
+int jack_client_set_flush_denormals(jack_client_t* client, int onoff) JACK_OPTIONAL_WEAK_EXPORT;
+
 #ifndef WIN32
 
  typedef int (*jack_thread_creator_t)(pthread_t*,
@@ -299,6 +299,16 @@ typedef int (*JackProcessCallback)(jack_nframes_t nframes, void *arg);
  */
 typedef void *(*JackThreadCallback)(void* arg);
 
+/**
+ * Prototype for the client supplied function called by
+ * jack_client_parallel_for() for each index of the work, from the
+ * realtime thread of the client or from one of its worker threads.
+ *
+ * @param index index of the piece of work, from 0 to count - 1
+ * @param arg pointer to a client supplied structure
+ */
+typedef void (*JackParallelCallback)(unsigned int index, void *arg);
+
 /**
  * Prototype for the client supplied function that is called
  * once after the creation of the thread in which other
@@ -373,6 +383,19 @@ typedef int (*JackSampleRateCallback)(jack_nframes_t nframes, void *arg);
  */
 typedef void (*JackPortRegistrationCallback)(jack_port_id_t port, int /* register */, void *arg);
 
+/**
+ * Prototype for the client supplied function that is called
+ * once for a batch of ports registered or unregistered together,
+ * for instance when a client with many ports is activated.
+ *
+ * @param ports array of the IDs of the ports
+ * @param count number of ports in the array
+ * @param register non-zero if the ports are being registered,
+ *                     zero if the ports are being unregistered
+ * @param arg pointer to a client supplied data
+ */
+typedef void (*JackPortRegistrationBatchCallback)(const jack_port_id_t* ports, unsigned int count, int /* register */, void *arg);
+
 /**
  * Prototype for the client supplied function that is called
  * whenever a client is registered or unregistered.
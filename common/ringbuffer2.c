@@ -0,0 +1,474 @@
+/*
+  Copyright (C) 2000 Paul Davis
+  Copyright (C) 2003 Rohan Drape
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation; either version 2.1 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+  Single reader / single writer lock-free ringbuffer with cache line
+  separated indexes, see jack/ringbuffer2.h.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#else
+#include <malloc.h>
+#endif
+#include "JackCompilerDeps.h"
+#include "types.h"
+
+typedef struct {
+    char *buf;
+    size_t len;
+}
+jack_ringbuffer_data_t ;
+
+#define RB2_CACHE_LINE      64
+#define RB2_HUGE_PAGE_SIZE  (2 * 1024 * 1024)
+
+enum {
+    RB2_MLOCK = 0x01,
+    RB2_HUGE_PAGES = 0x02
+};
+
+enum {
+    RB2_ALLOC_ALIGNED = 0,
+    RB2_ALLOC_MMAP
+};
+
+/* The writer owns the first index line, the reader the second one. Each
+   side keeps a cached copy of the other side index, so that the line of
+   the other side is only read when the cached value is exhausted. */
+
+typedef struct jack_ringbuffer2 {
+    char *buf;
+    size_t size;
+    size_t size_mask;
+    size_t alloc_size;
+    int alloc;
+    int flags;
+    char pad0[RB2_CACHE_LINE - 4 * sizeof(size_t) - 2 * sizeof(int)];
+
+    size_t write_index;     /* written by the writer, read by the reader */
+    size_t read_cache;      /* writer private */
+    char pad1[RB2_CACHE_LINE - 2 * sizeof(size_t)];
+
+    size_t read_index;      /* written by the reader, read by the writer */
+    size_t write_cache;     /* reader private */
+    char pad2[RB2_CACHE_LINE - 2 * sizeof(size_t)];
+}
+jack_ringbuffer2_t ;
+
+#if defined(__GNUC__)
+#define RB2_LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define RB2_STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#else
+/* Fallback for compilers without the __atomic builtins: volatile
+   accesses surrounded by full barriers. */
+#include <windows.h>
+static inline size_t RB2_LOAD_ACQUIRE(size_t* ptr) { size_t val = *(volatile size_t*)ptr; MemoryBarrier(); return val; }
+#define RB2_STORE_RELEASE(ptr, val) do { MemoryBarrier(); *(volatile size_t*)(ptr) = (val); } while (0)
+#endif
+
+LIB_EXPORT jack_ringbuffer2_t *jack_ringbuffer2_create(size_t sz, int flags);
+LIB_EXPORT void jack_ringbuffer2_free(jack_ringbuffer2_t *rb);
+LIB_EXPORT size_t jack_ringbuffer2_size(const jack_ringbuffer2_t *rb);
+LIB_EXPORT int jack_ringbuffer2_flags(const jack_ringbuffer2_t *rb);
+LIB_EXPORT size_t jack_ringbuffer2_read_space(jack_ringbuffer2_t *rb);
+LIB_EXPORT size_t jack_ringbuffer2_write_space(jack_ringbuffer2_t *rb);
+LIB_EXPORT void jack_ringbuffer2_get_read_vector(jack_ringbuffer2_t *rb, jack_ringbuffer_data_t *vec);
+LIB_EXPORT void jack_ringbuffer2_get_write_vector(jack_ringbuffer2_t *rb, jack_ringbuffer_data_t *vec);
+LIB_EXPORT size_t jack_ringbuffer2_read(jack_ringbuffer2_t *rb, char *dest, size_t cnt);
+LIB_EXPORT size_t jack_ringbuffer2_peek(jack_ringbuffer2_t *rb, char *dest, size_t cnt);
+LIB_EXPORT void jack_ringbuffer2_read_advance(jack_ringbuffer2_t *rb, size_t cnt);
+LIB_EXPORT size_t jack_ringbuffer2_write(jack_ringbuffer2_t *rb, const char *src, size_t cnt);
+LIB_EXPORT void jack_ringbuffer2_write_advance(jack_ringbuffer2_t *rb, size_t cnt);
+LIB_EXPORT jack_nframes_t jack_ringbuffer2_write_frames(jack_ringbuffer2_t *rb,
+                                                        const jack_default_audio_sample_t* const* channels,
+                                                        unsigned int channel_count,
+                                                        jack_nframes_t nframes);
+LIB_EXPORT jack_nframes_t jack_ringbuffer2_read_frames(jack_ringbuffer2_t *rb,
+                                                       jack_default_audio_sample_t* const* channels,
+                                                       unsigned int channel_count,
+                                                       jack_nframes_t nframes);
+LIB_EXPORT void jack_ringbuffer2_reset(jack_ringbuffer2_t *rb);
+
+static void *
+rb2_aligned_alloc (size_t align, size_t sz)
+{
+#ifdef WIN32
+	return _aligned_malloc (sz, align);
+#else
+	void *ptr;
+	return (posix_memalign (&ptr, align, sz) == 0) ? ptr : NULL;
+#endif
+}
+
+static void
+rb2_aligned_free (void *ptr)
+{
+#ifdef WIN32
+	_aligned_free (ptr);
+#else
+	free (ptr);
+#endif
+}
+
+/* Allocate the data block, using huge pages if requested and available. */
+
+static int
+rb2_alloc_buffer (jack_ringbuffer2_t *rb, int flags)
+{
+#if defined(MAP_HUGETLB)
+	if (flags & RB2_HUGE_PAGES) {
+		size_t alloc_size = (rb->size + RB2_HUGE_PAGE_SIZE - 1) & ~((size_t)RB2_HUGE_PAGE_SIZE - 1);
+		void *ptr = mmap (NULL, alloc_size, PROT_READ | PROT_WRITE,
+				  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (ptr != MAP_FAILED) {
+			rb->buf = (char *) ptr;
+			rb->alloc_size = alloc_size;
+			rb->alloc = RB2_ALLOC_MMAP;
+			rb->flags |= RB2_HUGE_PAGES;
+			return 0;
+		}
+	}
+#endif
+	rb->alloc_size = rb->size;
+	rb->alloc = RB2_ALLOC_ALIGNED;
+#if defined(MADV_HUGEPAGE)
+	/* No reserved huge pages: ask for transparent ones instead */
+	if ((flags & RB2_HUGE_PAGES) && rb->size >= RB2_HUGE_PAGE_SIZE) {
+		if ((rb->buf = (char *) rb2_aligned_alloc (RB2_HUGE_PAGE_SIZE, rb->size)) == NULL) {
+			return -1;
+		}
+		madvise (rb->buf, rb->size, MADV_HUGEPAGE);
+		return 0;
+	}
+#endif
+	rb->buf = (char *) rb2_aligned_alloc (RB2_CACHE_LINE, rb->size);
+	return (rb->buf == NULL) ? -1 : 0;
+}
+
+static void
+rb2_free_buffer (jack_ringbuffer2_t *rb)
+{
+#ifndef WIN32
+	if (rb->flags & RB2_MLOCK) {
+		munlock (rb->buf, rb->alloc_size);
+	}
+	if (rb->alloc == RB2_ALLOC_MMAP) {
+		munmap (rb->buf, rb->alloc_size);
+		return;
+	}
+#endif
+	rb2_aligned_free (rb->buf);
+}
+
+/* Create a new ringbuffer to hold at least `sz' bytes of data. The
+   actual buffer size is rounded up to the next power of two.  */
+
+LIB_EXPORT jack_ringbuffer2_t *
+jack_ringbuffer2_create (size_t sz, int flags)
+{
+	size_t size;
+	jack_ringbuffer2_t *rb;
+
+	/* The size would overflow once rounded up to a power of two */
+	if (sz > ((size_t) -1 >> 1) + 1) {
+		return NULL;
+	}
+
+	if ((rb = (jack_ringbuffer2_t *) rb2_aligned_alloc (RB2_CACHE_LINE, sizeof (jack_ringbuffer2_t))) == NULL) {
+		return NULL;
+	}
+	memset (rb, 0, sizeof (jack_ringbuffer2_t));
+
+	/* A sample never straddles the end of the buffer */
+	for (size = sizeof (jack_default_audio_sample_t); size < sz; size <<= 1);
+
+	rb->size = size;
+	rb->size_mask = size - 1;
+	if (rb2_alloc_buffer (rb, flags) < 0) {
+		rb2_aligned_free (rb);
+		return NULL;
+	}
+
+#ifndef WIN32
+	if ((flags & RB2_MLOCK) && mlock (rb->buf, rb->alloc_size) == 0) {
+		rb->flags |= RB2_MLOCK;
+	}
+#endif
+
+	/* Touch all pages now, not in the real-time thread */
+	memset (rb->buf, 0, rb->size);
+	return rb;
+}
+
+/* Free all data associated with the ringbuffer `rb'. */
+
+LIB_EXPORT void
+jack_ringbuffer2_free (jack_ringbuffer2_t * rb)
+{
+	rb2_free_buffer (rb);
+	rb2_aligned_free (rb);
+}
+
+LIB_EXPORT size_t
+jack_ringbuffer2_size (const jack_ringbuffer2_t * rb)
+{
+	return rb->size;
+}
+
+LIB_EXPORT int
+jack_ringbuffer2_flags (const jack_ringbuffer2_t * rb)
+{
+	return rb->flags;
+}
+
+/* Reset the read and write pointers to zero. This is not thread
+   safe. */
+
+LIB_EXPORT void
+jack_ringbuffer2_reset (jack_ringbuffer2_t * rb)
+{
+	rb->write_index = 0;
+	rb->read_cache = 0;
+	rb->read_index = 0;
+	rb->write_cache = 0;
+}
+
+/* Return the number of bytes available for reading, refreshing the
+   reader copy of the write index. Reader side.  */
+
+LIB_EXPORT size_t
+jack_ringbuffer2_read_space (jack_ringbuffer2_t * rb)
+{
+	rb->write_cache = RB2_LOAD_ACQUIRE (&rb->write_index);
+	return rb->write_cache - rb->read_index;
+}
+
+/* Return the number of bytes available for writing, refreshing the
+   writer copy of the read index. Writer side.  */
+
+LIB_EXPORT size_t
+jack_ringbuffer2_write_space (jack_ringbuffer2_t * rb)
+{
+	rb->read_cache = RB2_LOAD_ACQUIRE (&rb->read_index);
+	return rb->size - (rb->write_index - rb->read_cache);
+}
+
+/* Readable bytes, only looking at the shared write index when the
+   cached one does not give `cnt' bytes. */
+
+static inline size_t
+rb2_readable (jack_ringbuffer2_t * rb, size_t cnt)
+{
+	size_t avail = rb->write_cache - rb->read_index;
+	if (avail < cnt) {
+		avail = jack_ringbuffer2_read_space (rb);
+	}
+	return avail;
+}
+
+/* Writable bytes, only looking at the shared read index when the
+   cached one does not give `cnt' bytes. */
+
+static inline size_t
+rb2_writable (jack_ringbuffer2_t * rb, size_t cnt)
+{
+	size_t avail = rb->size - (rb->write_index - rb->read_cache);
+	if (avail < cnt) {
+		avail = jack_ringbuffer2_write_space (rb);
+	}
+	return avail;
+}
+
+static inline void
+rb2_vector (const jack_ringbuffer2_t * rb, size_t index, size_t cnt, jack_ringbuffer_data_t * vec)
+{
+	size_t pos = index & rb->size_mask;
+	size_t n1 = rb->size - pos;
+
+	vec[0].buf = &(rb->buf[pos]);
+	if (cnt > n1) {
+		vec[0].len = n1;
+		vec[1].buf = rb->buf;
+		vec[1].len = cnt - n1;
+	} else {
+		vec[0].len = cnt;
+		vec[1].buf = rb->buf;
+		vec[1].len = 0;
+	}
+}
+
+LIB_EXPORT void
+jack_ringbuffer2_get_read_vector (jack_ringbuffer2_t * rb, jack_ringbuffer_data_t * vec)
+{
+	rb2_vector (rb, rb->read_index, jack_ringbuffer2_read_space (rb), vec);
+}
+
+LIB_EXPORT void
+jack_ringbuffer2_get_write_vector (jack_ringbuffer2_t * rb, jack_ringbuffer_data_t * vec)
+{
+	rb2_vector (rb, rb->write_index, jack_ringbuffer2_write_space (rb), vec);
+}
+
+LIB_EXPORT void
+jack_ringbuffer2_read_advance (jack_ringbuffer2_t * rb, size_t cnt)
+{
+	RB2_STORE_RELEASE (&rb->read_index, rb->read_index + cnt);
+}
+
+LIB_EXPORT void
+jack_ringbuffer2_write_advance (jack_ringbuffer2_t * rb, size_t cnt)
+{
+	RB2_STORE_RELEASE (&rb->write_index, rb->write_index + cnt);
+}
+
+/* The copying data reader without advance. */
+
+LIB_EXPORT size_t
+jack_ringbuffer2_peek (jack_ringbuffer2_t * rb, char *dest, size_t cnt)
+{
+	jack_ringbuffer_data_t vec[2];
+	size_t avail = rb2_readable (rb, cnt);
+
+	if (cnt > avail) {
+		cnt = avail;
+	}
+	rb2_vector (rb, rb->read_index, cnt, vec);
+	memcpy (dest, vec[0].buf, vec[0].len);
+	if (vec[1].len) {
+		memcpy (dest + vec[0].len, vec[1].buf, vec[1].len);
+	}
+	return cnt;
+}
+
+/* The copying data reader.  Copy at most `cnt' bytes from `rb' to
+   `dest'.  Returns the actual number of bytes copied. */
+
+LIB_EXPORT size_t
+jack_ringbuffer2_read (jack_ringbuffer2_t * rb, char *dest, size_t cnt)
+{
+	cnt = jack_ringbuffer2_peek (rb, dest, cnt);
+	jack_ringbuffer2_read_advance (rb, cnt);
+	return cnt;
+}
+
+/* The copying data writer.  Copy at most `cnt' bytes to `rb' from
+   `src'.  Returns the actual number of bytes copied. */
+
+LIB_EXPORT size_t
+jack_ringbuffer2_write (jack_ringbuffer2_t * rb, const char *src, size_t cnt)
+{
+	jack_ringbuffer_data_t vec[2];
+	size_t avail = rb2_writable (rb, cnt);
+
+	if (cnt > avail) {
+		cnt = avail;
+	}
+	rb2_vector (rb, rb->write_index, cnt, vec);
+	memcpy (vec[0].buf, src, vec[0].len);
+	if (vec[1].len) {
+		memcpy (vec[1].buf, src + vec[0].len, vec[1].len);
+	}
+	jack_ringbuffer2_write_advance (rb, cnt);
+	return cnt;
+}
+
+/* Interleave `nframes' frames of `channel_count' channels into `rb'.
+   The buffer size is a power of two not smaller than a sample, so a
+   sample never wraps: only the sample pointer has to, as long as the
+   index is a multiple of the sample size. */
+
+LIB_EXPORT jack_nframes_t
+jack_ringbuffer2_write_frames (jack_ringbuffer2_t * rb,
+			       const jack_default_audio_sample_t* const* channels,
+			       unsigned int channel_count,
+			       jack_nframes_t nframes)
+{
+	size_t frame_size = channel_count * sizeof (jack_default_audio_sample_t);
+	size_t avail;
+	jack_default_audio_sample_t *dst, *begin, *end;
+	jack_nframes_t frame;
+	unsigned int chan;
+
+	/* Byte calls of a size that is not a multiple of a sample misalign the index */
+	if (frame_size == 0 || (rb->write_index % sizeof (jack_default_audio_sample_t)) != 0) {
+		return 0;
+	}
+	avail = rb2_writable (rb, (size_t) nframes * frame_size);
+	if ((size_t) nframes * frame_size > avail) {
+		nframes = (jack_nframes_t) (avail / frame_size);
+	}
+
+	begin = (jack_default_audio_sample_t *) rb->buf;
+	end = (jack_default_audio_sample_t *) (rb->buf + rb->size);
+	dst = (jack_default_audio_sample_t *) (rb->buf + (rb->write_index & rb->size_mask));
+
+	for (frame = 0; frame < nframes; frame++) {
+		for (chan = 0; chan < channel_count; chan++) {
+			*dst++ = channels[chan][frame];
+			if (dst == end) {
+				dst = begin;
+			}
+		}
+	}
+
+	jack_ringbuffer2_write_advance (rb, (size_t) nframes * frame_size);
+	return nframes;
+}
+
+/* Deinterleave `nframes' frames of `channel_count' channels from `rb'. */
+
+LIB_EXPORT jack_nframes_t
+jack_ringbuffer2_read_frames (jack_ringbuffer2_t * rb,
+			      jack_default_audio_sample_t* const* channels,
+			      unsigned int channel_count,
+			      jack_nframes_t nframes)
+{
+	size_t frame_size = channel_count * sizeof (jack_default_audio_sample_t);
+	size_t avail;
+	jack_default_audio_sample_t *src, *begin, *end;
+	jack_nframes_t frame;
+	unsigned int chan;
+
+	/* Byte calls of a size that is not a multiple of a sample misalign the index */
+	if (frame_size == 0 || (rb->read_index % sizeof (jack_default_audio_sample_t)) != 0) {
+		return 0;
+	}
+	avail = rb2_readable (rb, (size_t) nframes * frame_size);
+	if ((size_t) nframes * frame_size > avail) {
+		nframes = (jack_nframes_t) (avail / frame_size);
+	}
+
+	begin = (jack_default_audio_sample_t *) rb->buf;
+	end = (jack_default_audio_sample_t *) (rb->buf + rb->size);
+	src = (jack_default_audio_sample_t *) (rb->buf + (rb->read_index & rb->size_mask));
+
+	for (frame = 0; frame < nframes; frame++) {
+		for (chan = 0; chan < channel_count; chan++) {
+			channels[chan][frame] = *src++;
+			if (src == end) {
+				src = begin;
+			}
+		}
+	}
+
+	jack_ringbuffer2_read_advance (rb, (size_t) nframes * frame_size);
+	return nframes;
+}
@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <dbus/dbus.h>
+#include <jack/statistics.h>
 
 #include "jackdbus.h"
 #include "controller_internal.h"
@@ -56,6 +57,62 @@ jack_controller_control_send_signal_server_stopped()
         DBUS_TYPE_INVALID);
 }
 
+static
+void
+jack_control_get_client_timing_stats(
+    struct jack_controller * controller_ptr,
+    struct jack_dbus_method_call * call,
+    const char * client_name)
+{
+    jack_client_timing_stats_t stats;
+    dbus_uint64_t values[12];
+    int i;
+
+    if (jack_client_get_timing_stats(controller_ptr->client, client_name, &stats) != 0)
+    {
+        jack_dbus_error(
+            call,
+            JACK_DBUS_ERROR_GENERIC,
+            "No timing statistics for client '%s'",
+            client_name);
+        return;
+    }
+
+    values[0] = stats.process.count;
+    values[1] = stats.process.p50;
+    values[2] = stats.process.p99;
+    values[3] = stats.process.p999;
+    values[4] = stats.process.max;
+    values[5] = stats.wakeup.p50;
+    values[6] = stats.wakeup.p99;
+    values[7] = stats.wakeup.p999;
+    values[8] = stats.wakeup.max;
+    values[9] = stats.spin_hits;
+    values[10] = stats.spin_misses;
+    values[11] = stats.workers_usecs;
+
+    call->reply = dbus_message_new_method_return(call->message);
+    if (call->reply == NULL)
+    {
+        goto fail_no_mem;
+    }
+
+    for (i = 0; i < 12; i++)
+    {
+        if (!dbus_message_append_args(call->reply, DBUS_TYPE_UINT64, &values[i], DBUS_TYPE_INVALID))
+        {
+            dbus_message_unref(call->reply);
+            call->reply = NULL;
+            goto fail_no_mem;
+        }
+    }
+
+    return;
+
+fail_no_mem:
+    jack_error("Ran out of memory trying to construct method return");
+}
+
 #define controller_ptr ((struct jack_controller *)call->context)
 
 /*
@@ -151,6 +208,25 @@ jack_control_run_method(
         type = DBUS_TYPE_UINT32;
         arg.uint32 = controller_ptr->xruns;
     }
+    else if (strcmp (call->method_name, "GetClientTimingStats") == 0)
+    {
+        const char *client_name;
+
+        if (!controller_ptr->started)
+        {
+            goto not_started;
+        }
+
+        if (!jack_dbus_get_method_args(call, DBUS_TYPE_STRING, &client_name, DBUS_TYPE_INVALID))
+        {
+            /* jack_dbus_get_method_args() has set reply for us */
+            goto exit;
+        }
+
+        /* the reply is set by the called function */
+        jack_control_get_client_timing_stats(controller_ptr, call, client_name);
+        goto exit;
+    }
     else if (strcmp (call->method_name, "GetSampleRate") == 0)
     {
         if (!controller_ptr->started)
@@ -364,6 +440,22 @@ JACK_DBUS_METHOD_ARGUMENTS_BEGIN(GetXruns)
     JACK_DBUS_METHOD_ARGUMENT("xruns_count", "u", true)
 JACK_DBUS_METHOD_ARGUMENTS_END
 
+JACK_DBUS_METHOD_ARGUMENTS_BEGIN(GetClientTimingStats)
+    JACK_DBUS_METHOD_ARGUMENT("client_name", "s", false)
+    JACK_DBUS_METHOD_ARGUMENT("process_count", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("process_p50_usecs", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("process_p99_usecs", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("process_p999_usecs", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("process_max_usecs", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("wakeup_p50_usecs", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("wakeup_p99_usecs", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("wakeup_p999_usecs", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("wakeup_max_usecs", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("spin_hits", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("spin_misses", "t", true)
+    JACK_DBUS_METHOD_ARGUMENT("workers_usecs", "t", true)
+JACK_DBUS_METHOD_ARGUMENTS_END
+
 JACK_DBUS_METHOD_ARGUMENTS_BEGIN(GetSampleRate)
     JACK_DBUS_METHOD_ARGUMENT("sample_rate", "u", true)
 JACK_DBUS_METHOD_ARGUMENTS_END
@@ -410,6 +502,7 @@ JACK_DBUS_METHODS_BEGIN
     JACK_DBUS_METHOD_DESCRIBE(SwitchMaster, NULL)
     JACK_DBUS_METHOD_DESCRIBE(GetLoad, NULL)
     JACK_DBUS_METHOD_DESCRIBE(GetXruns, NULL)
+    JACK_DBUS_METHOD_DESCRIBE(GetClientTimingStats, NULL)
     JACK_DBUS_METHOD_DESCRIBE(GetSampleRate, NULL)
     JACK_DBUS_METHOD_DESCRIBE(GetLatency, NULL)
     JACK_DBUS_METHOD_DESCRIBE(GetBufferSize, NULL)
@@ -0,0 +1,263 @@
+/*
+    Copyright (C) 2026 agent
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file profile.c
+ *
+ * @brief Streams the server cycle profiler: for each cycle, the date each
+ * client was signaled, woke up and finished, relative to the cycle begin.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <getopt.h>
+#ifndef WIN32
+#include <unistd.h>
+#endif
+#include <jack/jack.h>
+#include <jack/profiler.h>
+
+static volatile int running = 1;
+
+typedef struct {
+    unsigned long cycles;
+    unsigned long late;
+    unsigned long lost;
+    jack_time_t max_duration;
+    jack_time_t total_duration;
+    jack_time_t max_client_duration[256];
+} summary_t;
+
+static void signal_handler(int sig)
+{
+    running = 0;
+}
+
+static void usage()
+{
+    fprintf (stderr, "\n"
+                    "usage: jack_profile \n"
+                    "              [ --count OR -c cycles ]\n"
+                    "              [ --late OR -l (only print cycles finishing after the period) ]\n"
+                    "              [ --summary OR -s (only print a summary at exit) ]\n"
+    );
+}
+
+static const char* status_name(int status)
+{
+    switch (status) {
+        case JackProfilerNotTriggered: return "not triggered";
+        case JackProfilerTriggered: return "triggered";
+        case JackProfilerRunning: return "running";
+        case JackProfilerFinished: return "finished";
+        default: return "?";
+    }
+}
+
+static long relative(jack_time_t date, jack_time_t begin)
+{
+    return (date >= begin) ? (long)(date - begin) : -1;
+}
+
+/* In asynchronous mode the driver ends the cycle before the clients have finished */
+static jack_time_t cycle_end(jack_profiler_cycle_t* cycle)
+{
+    jack_time_t end = cycle->cycle_end;
+    uint32_t i;
+
+    for (i = 0; i < cycle->client_count; i++) {
+        if (cycle->clients[i].finished_at > end) {
+            end = cycle->clients[i].finished_at;
+        }
+    }
+    return end;
+}
+
+static void print_cycle(jack_profiler_t* profiler, jack_profiler_cycle_t* cycle)
+{
+    char name[256];
+    uint32_t i;
+
+    if (cycle->lost > 0) {
+        printf("... %u cycle(s) lost\n", cycle->lost);
+    }
+    printf("cycle %u: period = %ld us, end = %ld us, next = %ld us, DSP load = %.2f %%\n",
+           cycle->cycle,
+           (long)cycle->period_usecs,
+           relative(cycle_end(cycle), cycle->cycle_begin),
+           relative(cycle->next_cycle_begin, cycle->cycle_begin),
+           cycle->cpu_load);
+    for (i = 0; i < cycle->client_count; i++) {
+        const jack_profiler_client_t* client = &cycle->clients[i];
+        jack_profiler_client_name(profiler, client->refnum, name, sizeof(name));
+        printf("    %-32s signaled = %6ld awake = %6ld finished = %6ld  %s",
+               name,
+               relative(client->signaled_at, cycle->cycle_begin),
+               relative(client->awake_at, cycle->cycle_begin),
+               relative(client->finished_at, cycle->cycle_begin),
+               status_name(client->status));
+        if (client->cpu_nsecs > 0) {
+            printf("  cpu = %ld ns", (long)client->cpu_nsecs);
+        }
+        printf("\n");
+    }
+}
+
+static void update_summary(summary_t* summary, jack_profiler_cycle_t* cycle)
+{
+    jack_time_t end = cycle_end(cycle);
+    jack_time_t duration = (end > cycle->cycle_begin) ? end - cycle->cycle_begin : 0;
+    uint32_t i;
+
+    summary->cycles++;
+    summary->lost += cycle->lost;
+    summary->total_duration += duration;
+    if (duration > summary->max_duration) {
+        summary->max_duration = duration;
+    }
+    if (duration > cycle->period_usecs) {
+        summary->late++;
+    }
+    for (i = 0; i < cycle->client_count; i++) {
+        const jack_profiler_client_t* client = &cycle->clients[i];
+        if (client->finished_at > client->awake_at && client->awake_at > 0 && client->refnum < 256) {
+            jack_time_t client_duration = client->finished_at - client->awake_at;
+            if (client_duration > summary->max_client_duration[client->refnum]) {
+                summary->max_client_duration[client->refnum] = client_duration;
+            }
+        }
+    }
+}
+
+static void print_summary(jack_profiler_t* profiler, summary_t* summary)
+{
+    char name[256];
+    int i;
+
+    printf("%lu cycles profiled, %lu lost, %lu late\n", summary->cycles, summary->lost, summary->late);
+    if (summary->cycles > 0) {
+        printf("cycle duration: mean = %ld us, max = %ld us\n",
+               (long)(summary->total_duration / summary->cycles), (long)summary->max_duration);
+    }
+    for (i = 0; i < 256; i++) {
+        if (summary->max_client_duration[i] > 0) {
+            jack_profiler_client_name(profiler, i, name, sizeof(name));
+            printf("    %-32s max process duration = %ld us\n", name, (long)summary->max_client_duration[i]);
+        }
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    jack_client_t* client;
+    jack_profiler_t* profiler;
+    jack_profiler_cycle_t cycle;
+    jack_status_t status;
+    summary_t summary;
+    unsigned long count = 0;
+    int only_late = 0;
+    int only_summary = 0;
+    int was_enabled;
+    int opt, option_index;
+    const char *options = "c:ls";
+    struct option long_options[] =
+    {
+        {"count", 1, 0, 'c'},
+        {"late", 0, 0, 'l'},
+        {"summary", 0, 0, 's'},
+        {0, 0, 0, 0}
+    };
+
+    while ((opt = getopt_long (argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'c':
+                count = strtoul(optarg, NULL, 10);
+                break;
+            case 'l':
+                only_late = 1;
+                break;
+            case 's':
+                only_summary = 1;
+                break;
+            default:
+                usage();
+                return 1;
+        }
+    }
+
+    client = jack_client_open("jack_profile", JackNoStartServer, &status);
+    if (client == NULL) {
+        fprintf(stderr, "jack_client_open() failed, status = 0x%2.0x\n", status);
+        return 1;
+    }
+
+    profiler = jack_profiler_open(client);
+    if (profiler == NULL) {
+        fprintf(stderr, "Cannot open the server cycle profiler\n");
+        jack_client_close(client);
+        return 1;
+    }
+
+    /* Profiling is left as found at exit */
+    was_enabled = jack_profiler_is_enabled(profiler);
+    if (!was_enabled) {
+        jack_profiler_enable(profiler, 1);
+    }
+
+#ifdef WIN32
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+#else
+    signal(SIGQUIT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGHUP, signal_handler);
+    signal(SIGINT, signal_handler);
+#endif
+
+    memset(&summary, 0, sizeof(summary));
+
+    while (running && (count == 0 || summary.cycles < count)) {
+        int res = jack_profiler_read(profiler, &cycle);
+        if (res < 0) {
+            break;
+        } else if (res == 0) {
+#ifdef WIN32
+            Sleep(10);
+#else
+            usleep(10000);
+#endif
+            continue;
+        }
+        update_summary(&summary, &cycle);
+        if (!only_summary
+            && (!only_late || cycle_end(&cycle) > cycle.cycle_begin + cycle.period_usecs)) {
+            print_cycle(profiler, &cycle);
+        }
+    }
+
+    print_summary(profiler, &summary);
+
+    /* Closing switches profiling off if it was enabled here */
+    jack_profiler_close(profiler);
+    jack_client_close(client);
+    return 0;
+}
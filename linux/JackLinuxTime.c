@@ -39,6 +39,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include <inttypes.h>
 
 jack_time_t (*_jack_get_microseconds)(void) = 0;
+static volatile jack_time_t* _jack_virtual_clock = NULL;
 
 #if defined(__gnu_linux__) && (defined(__i386__) || defined(__x86_64__))
 #define HPET_SUPPORT
@@ -152,6 +153,10 @@ static jack_time_t jack_get_microseconds_from_system (void)
 
 #endif /* HAVE_CLOCK_GETTIME */
 
+static jack_time_t jack_get_microseconds_from_virtual (void)
+{
+	return *_jack_virtual_clock;
+}
 
 SERVER_EXPORT void JackSleep(long usec)
 {
@@ -180,6 +185,14 @@ void SetClockSource(jack_timer_type_t source)
             }
             break;
 
+        case JACK_TIMER_VIRTUAL:
+            if (_jack_virtual_clock) {
+                _jack_get_microseconds = jack_get_microseconds_from_virtual;
+            } else {
+                _jack_get_microseconds = jack_get_microseconds_from_system;
+            }
+            break;
+
         case JACK_TIMER_SYSTEM_CLOCK:
             default:
             _jack_get_microseconds = jack_get_microseconds_from_system;
@@ -187,11 +200,23 @@ void SetClockSource(jack_timer_type_t source)
 	}
 }
 
+SERVER_EXPORT void SetVirtualClock(volatile jack_time_t* clock)
+{
+	_jack_virtual_clock = clock;
+}
+
+SERVER_EXPORT int IsVirtualClock()
+{
+	return _jack_get_microseconds == jack_get_microseconds_from_virtual;
+}
+
 const char* ClockSourceName(jack_timer_type_t source)
 {
 	switch (source) {
         case JACK_TIMER_HPET:
             return "hpet";
+        case JACK_TIMER_VIRTUAL:
+            return "virtual";
         case JACK_TIMER_SYSTEM_CLOCK:
         #ifdef HAVE_CLOCK_GETTIME
             return "system clock via clock_gettime";
@@ -209,6 +234,17 @@ SERVER_EXPORT jack_time_t GetMicroSeconds()
 	return _jack_get_microseconds();
 }
 
+SERVER_EXPORT jack_time_t GetThreadCPUNanoSeconds()
+{
+#ifdef HAVE_CLOCK_GETTIME
+	struct timespec time;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0) {
+		return (jack_time_t) time.tv_sec * 1000000000 + (jack_time_t) time.tv_nsec;
+	}
+#endif
+	return 0;
+}
+
 SERVER_EXPORT jack_time_t jack_get_microseconds()
 {
 	return _jack_get_microseconds();
@@ -22,9 +22,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackError.h"
 #include "JackTypes.h"
 #include <mach/mach_time.h>
+#include <mach/mach.h>
 #include <unistd.h>
 
 static double __jack_time_ratio;
+static volatile jack_time_t* __jack_virtual_clock = NULL;
+static int __jack_virtual = 0;
 
 SERVER_EXPORT void JackSleep(long usec)
 {
@@ -44,13 +47,42 @@ SERVER_EXPORT void EndTime()
 
 SERVER_EXPORT jack_time_t GetMicroSeconds(void)
 {
+    if (__jack_virtual) {
+        return *__jack_virtual_clock;
+    }
     return (jack_time_t) (mach_absolute_time() * __jack_time_ratio);
 }
 
+SERVER_EXPORT jack_time_t GetThreadCPUNanoSeconds(void)
+{
+    thread_basic_info_data_t info;
+    mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+    mach_port_t thread = mach_thread_self();
+    kern_return_t res = thread_info(thread, THREAD_BASIC_INFO, (thread_info_t)&info, &count);
+    mach_port_deallocate(mach_task_self(), thread);
+    if (res != KERN_SUCCESS) {
+        return 0;
+    }
+    return ((jack_time_t)(info.user_time.seconds + info.system_time.seconds) * 1000000
+        + info.user_time.microseconds + info.system_time.microseconds) * 1000;
+}
+
 void SetClockSource(jack_timer_type_t source)
-{}
+{
+    __jack_virtual = (source == JACK_TIMER_VIRTUAL && __jack_virtual_clock);
+}
+
+SERVER_EXPORT void SetVirtualClock(volatile jack_time_t* clock)
+{
+    __jack_virtual_clock = clock;
+}
+
+SERVER_EXPORT int IsVirtualClock(void)
+{
+    return __jack_virtual;
+}
 
 const char* ClockSourceName(jack_timer_type_t source)
 {
-    return "";
+    return (source == JACK_TIMER_VIRTUAL) ? "virtual" : "";
 }
@@ -53,6 +53,7 @@ namespace Jack
 /* __JackPlatformMutex__ */
 #include "JackPosixMutex.h"
 namespace Jack { typedef JackPosixMutex JackMutex; }
+namespace Jack { typedef JackPosixRWLock JackRWLock; }
 
 /* __JackPlatformThread__ */
 #include "JackMachThread.h"
@@ -21,15 +21,133 @@
 
 #include "JackPosixMutex.h"
 #include "JackError.h"
+#include <unistd.h>
+
+#ifdef JACK_LOCK_AUDIT
+#include <execinfo.h>
+#include <sched.h>
+#include <string.h>
+#endif
 
 namespace Jack
 {
 
+#ifdef JACK_LOCK_AUDIT
+
+#define LOCK_AUDIT_SITES 256
+#define LOCK_AUDIT_DEPTH 8
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+    struct JackLockAuditSite
+    {
+        void* fStack[LOCK_AUDIT_DEPTH];
+        int fDepth;
+        const char* fName;
+        volatile int fCount;
+        volatile bool fReady;
+    };
+
+    static JackLockAuditSite gLockAuditSites[LOCK_AUDIT_SITES];
+    static volatile int gLockAuditSiteCount = 0;
+    static volatile int gLockAuditLost = 0;
+
+    static bool IsRealTimeThread()
+    {
+        int policy;
+        struct sched_param param;
+        if (pthread_getschedparam(pthread_self(), &policy, &param) != 0) {
+            return false;
+        }
+        return policy == SCHED_FIFO || policy == SCHED_RR || policy == SCHED_DEADLINE;
+    }
+
+    void JackLockAudit::Check(const char* name)
+    {
+        if (!IsRealTimeThread()) {
+            return;
+        }
+
+        // The audit is not RT safe itself: backtrace may allocate the first time, then only the report is written outside RT
+        void* stack[LOCK_AUDIT_DEPTH + 1];
+        int depth = backtrace(stack, LOCK_AUDIT_DEPTH + 1) - 1;
+        int count = gLockAuditSiteCount;
+
+        for (int i = 0; i < count && i < LOCK_AUDIT_SITES; i++) {
+            JackLockAuditSite* site = &gLockAuditSites[i];
+            if (site->fReady && site->fDepth == depth && memcmp(site->fStack, stack + 1, depth * sizeof(void*)) == 0) {
+                __sync_fetch_and_add(&site->fCount, 1);
+                return;
+            }
+        }
+
+        int index = __sync_fetch_and_add(&gLockAuditSiteCount, 1);
+        if (index >= LOCK_AUDIT_SITES) {
+            __sync_fetch_and_add(&gLockAuditLost, 1);
+            return;
+        }
+
+        JackLockAuditSite* site = &gLockAuditSites[index];
+        memcpy(site->fStack, stack + 1, depth * sizeof(void*));
+        site->fDepth = depth;
+        site->fName = name;
+        site->fCount = 1;
+        __sync_synchronize();
+        site->fReady = true;
+    }
+
+    void JackLockAudit::Report()
+    {
+        int count = gLockAuditSiteCount;
+        if (count > LOCK_AUDIT_SITES) {
+            count = LOCK_AUDIT_SITES;
+        }
+
+        fprintf(stderr, "Lock audit: %d call stack(s) took a blocking lock on a real-time thread\n", count);
+        for (int i = 0; i < count; i++) {
+            JackLockAuditSite* site = &gLockAuditSites[i];
+            if (site->fReady) {
+                fprintf(stderr, "%s taken %d time(s) from:\n", site->fName, site->fCount);
+                backtrace_symbols_fd(site->fStack, site->fDepth, fileno(stderr));
+            }
+        }
+        if (gLockAuditLost > 0) {
+            fprintf(stderr, "Lock audit: %d lock(s) not recorded, too many call stacks\n", gLockAuditLost);
+        }
+    }
+
+    // Writes the report when the library is unloaded, after the server or client is closed
+    static struct JackLockAuditReporter
+    {
+        ~JackLockAuditReporter()
+        {
+            JackLockAudit::Report();
+        }
+    } gLockAuditReporter;
+
+#endif
+
+    static void SetPriorityInheritance(pthread_mutexattr_t* mutex_attr)
+    {
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && (_POSIX_THREAD_PRIO_INHERIT > 0)
+        // Not fatal: the mutex still works, only without protection against priority inversion
+        pthread_mutexattr_setprotocol(mutex_attr, PTHREAD_PRIO_INHERIT);
+#endif
+    }
+
     JackBasePosixMutex::JackBasePosixMutex(const char* name)
         :fOwner(0)
     {
-        int res = pthread_mutex_init(&fMutex, NULL);
+        pthread_mutexattr_t mutex_attr;
+        int res;
+        res = pthread_mutexattr_init(&mutex_attr);
+        ThrowIf(res != 0, JackException("JackBasePosixMutex: could not init the mutex attribute"));
+        SetPriorityInheritance(&mutex_attr);
+        res = pthread_mutex_init(&fMutex, &mutex_attr);
         ThrowIf(res != 0, JackException("JackBasePosixMutex: could not init the mutex"));
+        pthread_mutexattr_destroy(&mutex_attr);
     }
 
     JackBasePosixMutex::~JackBasePosixMutex()
@@ -42,6 +160,7 @@ namespace Jack
         pthread_t current_thread = pthread_self();
 
         if (!pthread_equal(current_thread, fOwner)) {
+            JACK_LOCK_AUDIT_CHECK("JackBasePosixMutex::Lock");
             int res = pthread_mutex_lock(&fMutex);
             if (res == 0) {
                 fOwner = current_thread;
@@ -90,13 +209,14 @@ namespace Jack
 
     JackPosixMutex::JackPosixMutex(const char* name)
     {
-        // Use recursive mutex
+        // Use recursive mutex, with priority inheritance
         pthread_mutexattr_t mutex_attr;
         int res;
         res = pthread_mutexattr_init(&mutex_attr);
         ThrowIf(res != 0, JackException("JackBasePosixMutex: could not init the mutex attribute"));
         res = pthread_mutexattr_settype(&mutex_attr, PTHREAD_MUTEX_RECURSIVE);
         ThrowIf(res != 0, JackException("JackBasePosixMutex: could not settype the mutex"));
+        SetPriorityInheritance(&mutex_attr);
         res = pthread_mutex_init(&fMutex, &mutex_attr);
         ThrowIf(res != 0, JackException("JackBasePosixMutex: could not init the mutex"));
         pthread_mutexattr_destroy(&mutex_attr);
@@ -109,6 +229,7 @@ namespace Jack
 
     bool JackPosixMutex::Lock()
     {
+        JACK_LOCK_AUDIT_CHECK("JackPosixMutex::Lock");
         int res = pthread_mutex_lock(&fMutex);
         if (res != 0) {
             jack_log("JackPosixMutex::Lock res = %d", res);
@@ -131,4 +252,62 @@ namespace Jack
     }
 
 
+    JackPosixRWLock::JackPosixRWLock(const char* name)
+    {
+        pthread_rwlockattr_t lock_attr;
+        int res;
+        res = pthread_rwlockattr_init(&lock_attr);
+        ThrowIf(res != 0, JackException("JackPosixRWLock: could not init the lock attribute"));
+#ifdef __GLIBC__
+        // Otherwise a steady flow of readers keeps a writer waiting
+        pthread_rwlockattr_setkind_np(&lock_attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+        res = pthread_rwlock_init(&fLock, &lock_attr);
+        ThrowIf(res != 0, JackException("JackPosixRWLock: could not init the lock"));
+        pthread_rwlockattr_destroy(&lock_attr);
+    }
+
+    JackPosixRWLock::~JackPosixRWLock()
+    {
+        pthread_rwlock_destroy(&fLock);
+    }
+
+    bool JackPosixRWLock::ReadLock()
+    {
+        JACK_LOCK_AUDIT_CHECK("JackPosixRWLock::ReadLock");
+        int res = pthread_rwlock_rdlock(&fLock);
+        if (res != 0) {
+            jack_log("JackPosixRWLock::ReadLock res = %d", res);
+        }
+        return (res == 0);
+    }
+
+    bool JackPosixRWLock::ReadUnlock()
+    {
+        int res = pthread_rwlock_unlock(&fLock);
+        if (res != 0) {
+            jack_log("JackPosixRWLock::ReadUnlock res = %d", res);
+        }
+        return (res == 0);
+    }
+
+    bool JackPosixRWLock::WriteLock()
+    {
+        JACK_LOCK_AUDIT_CHECK("JackPosixRWLock::WriteLock");
+        int res = pthread_rwlock_wrlock(&fLock);
+        if (res != 0) {
+            jack_log("JackPosixRWLock::WriteLock res = %d", res);
+        }
+        return (res == 0);
+    }
+
+    bool JackPosixRWLock::WriteUnlock()
+    {
+        int res = pthread_rwlock_unlock(&fLock);
+        if (res != 0) {
+            jack_log("JackPosixRWLock::WriteUnlock res = %d", res);
+        }
+        return (res == 0);
+    }
+
 } // namespace
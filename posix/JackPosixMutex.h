@@ -24,6 +24,7 @@
 
 #include "JackException.h"
 #include "JackCompilerDeps.h"
+#include "config.h"
 
 #include <pthread.h>
 #include <stdio.h>
@@ -31,8 +32,39 @@
 
 namespace Jack
 {
+
+#ifdef JACK_LOCK_AUDIT
+
+/*!
+\brief Records the blocking locks taken on real-time threads, with their call stack.
+
+Built with --lock-audit only. Each distinct call stack is counted once recorded, and the list is written on stderr when
+the library is unloaded, so that a run without report shows that the RT path took no blocking lock.
+*/
+
+class SERVER_EXPORT JackLockAudit
+{
+
+    public:
+
+        static void Check(const char* name);
+        static void Report();
+
+};
+
+#define JACK_LOCK_AUDIT_CHECK(name) JackLockAudit::Check(name)
+
+#else
+
+#define JACK_LOCK_AUDIT_CHECK(name)
+
+#endif
+
 /*!
 \brief Mutex abstraction.
+
+Mutexes use priority inheritance when the system has it: they are shared between RT and non RT threads, and a non RT
+owner is then raised to the priority of the RT thread waiting for it.
 */
 
 class SERVER_EXPORT JackBasePosixMutex
@@ -70,6 +102,27 @@ class SERVER_EXPORT JackPosixMutex
         bool Unlock();
 };
 
+/*!
+\brief Reader/writer lock abstraction, writers are preferred when the system allows it.
+*/
+
+class SERVER_EXPORT JackPosixRWLock
+{
+    protected:
+
+        pthread_rwlock_t fLock;
+
+    public:
+
+        JackPosixRWLock(const char* name = NULL);
+        virtual ~JackPosixRWLock();
+
+        bool ReadLock();
+        bool ReadUnlock();
+        bool WriteLock();
+        bool WriteUnlock();
+};
+
 } // namespace
 
 #endif
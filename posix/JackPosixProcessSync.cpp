@@ -19,6 +19,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "JackPosixProcessSync.h"
 #include "JackError.h"
+#include <errno.h>
 
 namespace Jack
 {
@@ -34,6 +35,7 @@ void JackPosixProcessSync::Signal()
 // TO DO : check thread consistency?
 void JackPosixProcessSync::LockedSignal()
 {
+    JACK_LOCK_AUDIT_CHECK("JackPosixProcessSync::LockedSignal");
     int res = pthread_mutex_lock(&fMutex);
     if (res != 0) {
         jack_error("JackPosixProcessSync::LockedSignal error err = %s", strerror(res));
@@ -59,6 +61,7 @@ void JackPosixProcessSync::SignalAll()
 // TO DO : check thread consistency?
 void JackPosixProcessSync::LockedSignalAll()
 {
+    JACK_LOCK_AUDIT_CHECK("JackPosixProcessSync::LockedSignalAll");
     int res = pthread_mutex_lock(&fMutex);
     if (res != 0) {
         jack_error("JackPosixProcessSync::LockedSignalAll error err = %s", strerror(res));
@@ -78,6 +81,7 @@ void JackPosixProcessSync::Wait()
     ThrowIf(!pthread_equal(pthread_self(), fOwner), JackException("JackPosixProcessSync::Wait: a thread has to have locked a mutex before it can wait"));
     fOwner = 0;
 
+    JACK_LOCK_AUDIT_CHECK("JackPosixProcessSync::Wait");
     int res = pthread_cond_wait(&fCond, &fMutex);
     if (res != 0) {
         jack_error("JackPosixProcessSync::Wait error err = %s", strerror(res));
@@ -90,6 +94,7 @@ void JackPosixProcessSync::Wait()
 void JackPosixProcessSync::LockedWait()
 {
     int res;
+    JACK_LOCK_AUDIT_CHECK("JackPosixProcessSync::LockedWait");
     res = pthread_mutex_lock(&fMutex);
     if (res != 0) {
         jack_error("JackPosixProcessSync::LockedWait error err = %s", strerror(res));
@@ -108,30 +113,24 @@ bool JackPosixProcessSync::TimedWait(long usec)
     ThrowIf(!pthread_equal(pthread_self(), fOwner), JackException("JackPosixProcessSync::TimedWait: a thread has to have locked a mutex before it can wait"));
     fOwner = 0;
 
-    struct timeval T0, T1;
     timespec time;
     struct timeval now;
     int res;
 
-    jack_log("JackPosixProcessSync::TimedWait time out = %ld", usec);
-    gettimeofday(&T0, 0);
-
     gettimeofday(&now, 0);
     unsigned int next_date_usec = now.tv_usec + usec;
     time.tv_sec = now.tv_sec + (next_date_usec / 1000000);
     time.tv_nsec = (next_date_usec % 1000000) * 1000;
 
+    JACK_LOCK_AUDIT_CHECK("JackPosixProcessSync::TimedWait");
     res = pthread_cond_timedwait(&fCond, &fMutex, &time);
-    if (res != 0) {
-        jack_error("JackPosixProcessSync::TimedWait error usec = %ld err = %s", usec, strerror(res));
-    } else {
+    // The mutex is owned again when the wait times out, which is not an error for a periodic wait
+    if (res == 0 || res == ETIMEDOUT) {
         fOwner = pthread_self();
+    } else {
+        jack_error("JackPosixProcessSync::TimedWait error usec = %ld err = %s", usec, strerror(res));
     }
 
-    gettimeofday(&T1, 0);
-    jack_log("JackPosixProcessSync::TimedWait finished delta = %5.1lf",
-             (1e6 * T1.tv_sec - 1e6 * T0.tv_sec + T1.tv_usec - T0.tv_usec));
-
     return (res == 0);
 }
 
@@ -143,6 +142,7 @@ bool JackPosixProcessSync::LockedTimedWait(long usec)
     struct timeval now;
     int res1, res2;
 
+    JACK_LOCK_AUDIT_CHECK("JackPosixProcessSync::LockedTimedWait");
     res1 = pthread_mutex_lock(&fMutex);
     if (res1 != 0) {
         jack_error("JackPosixProcessSync::LockedTimedWait error err = %s", usec, strerror(res1));
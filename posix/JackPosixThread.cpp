@@ -24,10 +24,35 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackGlobals.h"
 #include <string.h> // for memset
 #include <unistd.h> // for _POSIX_PRIORITY_SCHEDULING check
+#include <errno.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 //#define JACK_SCHED_POLICY SCHED_RR
 #define JACK_SCHED_POLICY SCHED_FIFO
 
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+#define JACK_SCHED_FLAG_RESET_ON_FORK 0x01
+
+#if defined(__linux__) && defined(SYS_sched_setattr)
+// Not declared by every libc
+struct jack_sched_attr
+{
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;     // In nanoseconds
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+#endif
+
 namespace Jack
 {
 
@@ -243,6 +268,42 @@ int JackPosixThread::AcquireRealTimeImp(jack_native_thread_t thread, int priorit
     return 0;
 }
 
+int JackPosixThread::AcquireSelfDeadline(UInt64 runtime, UInt64 period)
+{
+    return AcquireSelfDeadlineImp(runtime, period, period);
+}
+
+/*
+SCHED_DEADLINE can only be set by the thread itself here, since sched_setattr takes a kernel thread id. The kernel refuses it
+without CAP_SYS_NICE, when the admission control finds that the CPUs do not have the requested bandwidth left, or when the
+thread affinity is restricted: the caller is expected to go back to SCHED_FIFO then.
+*/
+int JackPosixThread::AcquireSelfDeadlineImp(UInt64 runtime, UInt64 deadline, UInt64 period)
+{
+#if defined(__linux__) && defined(SYS_sched_setattr)
+    struct jack_sched_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.sched_policy = SCHED_DEADLINE;
+    attr.sched_flags = JACK_SCHED_FLAG_RESET_ON_FORK;
+    attr.sched_runtime = runtime;
+    attr.sched_deadline = deadline;
+    attr.sched_period = period;
+
+    jack_log("JackPosixThread::AcquireSelfDeadlineImp runtime = %lld deadline = %lld period = %lld",
+             (long long)runtime, (long long)deadline, (long long)period);
+
+    if (syscall(SYS_sched_setattr, 0, &attr, 0) != 0) {
+        jack_log("Cannot use deadline scheduling (%d: %s)", errno, strerror(errno));
+        return -1;
+    }
+    return 0;
+#else
+    jack_log("JackPosixThread::AcquireSelfDeadlineImp not supported on this platform");
+    return -1;
+#endif
+}
+
 int JackPosixThread::DropRealTime()
 {
     return (fThread != (jack_native_thread_t)NULL) ? DropRealTimeImp(fThread) : -1;
@@ -267,6 +328,84 @@ int JackPosixThread::DropRealTimeImp(jack_native_thread_t thread)
     return 0;
 }
 
+int JackPosixThread::SetAffinity(const int* cpus, int count)
+{
+    return (fThread != (jack_native_thread_t)NULL) ? SetAffinityImp(fThread, cpus, count) : -1;
+}
+
+int JackPosixThread::SetSelfAffinity(const int* cpus, int count)
+{
+    return SetAffinityImp(pthread_self(), cpus, count);
+}
+
+/*
+An empty CPU list gives the thread the affinity of the process (its main thread) again.
+*/
+int JackPosixThread::SetAffinityImp(jack_native_thread_t thread, const int* cpus, int count)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    int res;
+    CPU_ZERO(&set);
+    if (count == 0 && sched_getaffinity(getpid(), sizeof(set), &set) != 0) {
+        jack_error("Cannot get process affinity (%d: %s)", errno, strerror(errno));
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] < 0 || cpus[i] >= CPU_SETSIZE) {
+            jack_error("Cannot set thread affinity to CPU %d", cpus[i]);
+            return -1;
+        }
+        CPU_SET(cpus[i], &set);
+    }
+
+    jack_log("JackPosixThread::SetAffinityImp count = %d first = %d", count, (count > 0) ? cpus[0] : -1);
+
+    if ((res = pthread_setaffinity_np(thread, sizeof(set), &set)) != 0) {
+        jack_error("Cannot set thread affinity (%d: %s)", res, strerror(res));
+        return -1;
+    }
+    return 0;
+#else
+    jack_log("JackPosixThread::SetAffinityImp not supported on this platform");
+    return -1;
+#endif
+}
+
+/*
+Removes the CPUs from the affinity of the calling thread, the threads it creates afterwards inherit it.
+*/
+int JackPosixThread::ExcludeSelfAffinityImp(const int* cpus, int count)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    int res;
+
+    if ((res = pthread_getaffinity_np(pthread_self(), sizeof(set), &set)) != 0) {
+        jack_error("Cannot get thread affinity (%d: %s)", res, strerror(res));
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE) {
+            CPU_CLR(cpus[i], &set);
+        }
+    }
+    if (CPU_COUNT(&set) == 0) {
+        jack_log("JackPosixThread::ExcludeSelfAffinityImp no CPU left, affinity unchanged");
+        return 0;
+    }
+
+    if ((res = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) != 0) {
+        jack_error("Cannot set thread affinity (%d: %s)", res, strerror(res));
+        return -1;
+    }
+    return 0;
+#else
+    jack_log("JackPosixThread::ExcludeSelfAffinityImp not supported on this platform");
+    return -1;
+#endif
+}
+
 jack_native_thread_t JackPosixThread::GetThreadID()
 {
     return fThread;
@@ -319,11 +458,11 @@ bool jack_get_thread_realtime_priority_range(int * min_ptr, int * max_ptr)
 #endif
 }
 
-bool jack_tls_allocate_key(jack_tls_key *key_ptr)
+bool jack_tls_allocate_key(jack_tls_key *key_ptr, void (*destructor)(void*))
 {
     int ret;
 
-    ret = pthread_key_create(key_ptr, NULL);
+    ret = pthread_key_create(key_ptr, destructor);
     if (ret != 0)
     {
         jack_error("pthread_key_create() failed with error %d", ret);
@@ -221,8 +221,12 @@ bool JackSocketServerChannel::Execute()
 {
     try {
 
+        // Queued notifications are delivered by batch: wake up when the pending one is due
+        int usecs = fServer->GetEngine()->FlushPendingNotifications();
+        int timeout = (usecs > 0) ? (usecs + 999) / 1000 : 10000;
+
         // Global poll
-        if ((poll(fPollTable, fSocketTable.size() + 1, 10000) < 0) && (errno != EINTR)) {
+        if ((poll(fPollTable, fSocketTable.size() + 1, timeout) < 0) && (errno != EINTR)) {
             jack_error("JackSocketServerChannel::Execute : engine poll failed err = %s request thread quits...", strerror(errno));
             return false;
         } else {
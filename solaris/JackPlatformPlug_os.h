@@ -44,6 +44,7 @@ namespace Jack
 /* __JackPlatformMutex__ */
 #include "JackPosixMutex.h"
 namespace Jack {typedef JackPosixMutex JackMutex; }
+namespace Jack {typedef JackPosixRWLock JackRWLock; }
 
 /* __JackPlatformThread__ */
 #include "JackPosixThread.h"
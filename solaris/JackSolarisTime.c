@@ -23,6 +23,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include <unistd.h>
 #include <time.h>
 
+static volatile jack_time_t* _jack_virtual_clock = NULL;
+static int _jack_virtual = 0;
+
 SERVER_EXPORT void JackSleep(long usec)
 {
     usleep(usec);
@@ -36,13 +39,33 @@ SERVER_EXPORT void EndTime()
 
 SERVER_EXPORT jack_time_t GetMicroSeconds(void)
 {
+    if (_jack_virtual) {
+        return *_jack_virtual_clock;
+    }
     return (jack_time_t)(gethrtime() / 1000);
 }
 
+SERVER_EXPORT jack_time_t GetThreadCPUNanoSeconds(void)
+{
+    return (jack_time_t)gethrvtime();
+}
+
 void SetClockSource(jack_timer_type_t source)
-{}
+{
+    _jack_virtual = (source == JACK_TIMER_VIRTUAL && _jack_virtual_clock);
+}
+
+SERVER_EXPORT void SetVirtualClock(volatile jack_time_t* clock)
+{
+    _jack_virtual_clock = clock;
+}
+
+SERVER_EXPORT int IsVirtualClock(void)
+{
+    return _jack_virtual;
+}
 
 const char* ClockSourceName(jack_timer_type_t source)
 {
-    return "";
+    return (source == JACK_TIMER_VIRTUAL) ? "virtual" : "";
 }
@@ -0,0 +1,245 @@
+/*
+    Copyright (C) 2026 agent
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file cacheline_bench.cpp
+ *
+ * @brief False sharing benchmark of the per client activation counters
+ * and timings kept in the graph shared memory.
+ *
+ * One thread per client, each pinned on its own CPU, does what the
+ * activation of a client does on every cycle: reset and decrement its
+ * activation counter, then write its timing dates and state. The same
+ * work is done with the former packed layout, where the entries of
+ * several clients share a cache line, and with the current layout, where
+ * each entry has its own lines. The difference in cycles per second
+ * measures the cache line transfers between cores caused by the packed
+ * layout. With a misaligned base, packed counters may also straddle two
+ * lines, which turns their atomic decrement into a split lock.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include "JackConnectionManager.h"
+#include "JackAtomic.h"
+
+using namespace Jack;
+
+// Former layout: two SInt32 per counter, and the timing fields without padding
+#define PACKED_COUNTER_SIZE (2 * sizeof(SInt32))
+#define PACKED_TIMING_SIZE (5 * sizeof(jack_time_t) + sizeof(jack_client_state_t) + sizeof(UInt32))
+
+static int thread_count = 0;
+static double duration = 2.0;
+static size_t packed_offset = 0;
+static int first_cpu = 0;
+
+typedef struct {
+    char* counters;
+    char* timings;
+    size_t counter_size;
+    size_t timing_size;
+    volatile int running;
+} layout_t;
+
+typedef struct {
+    layout_t* layout;
+    int index;
+    unsigned long long cycles;
+} worker_t;
+
+static void usage()
+{
+    fprintf (stderr, "\n"
+                    "usage: jack_cacheline_bench \n"
+                    "              [ --threads OR -t thread_count (default: one per CPU) ]\n"
+                    "              [ --cpu OR -c first_cpu ]\n"
+                    "              [ --duration OR -d seconds ]\n"
+                    "              [ --offset OR -o byte offset of the packed arrays in a cache line ]\n"
+    );
+}
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void pin(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        fprintf(stderr, "Cannot pin thread on CPU %d\n", cpu);
+    }
+#endif
+}
+
+static void* worker(void* arg)
+{
+    worker_t* worker = (worker_t*)arg;
+    layout_t* layout = worker->layout;
+    // The activation counter value is the first field of an entry in both layouts
+    volatile SInt32* value = (volatile SInt32*)(layout->counters + worker->index * layout->counter_size);
+    JackClientTiming* timing = (JackClientTiming*)(layout->timings + worker->index * layout->timing_size);
+    unsigned long long cycles = 0;
+
+    pin(first_cpu + worker->index);
+
+    while (layout->running) {
+        // Reset by the driver, signaled by the previous client, then the client runs and finishes
+        *value = 1;
+        DEC_ATOMIC(value);
+        timing->fStatus = Triggered;
+        timing->fSignaledAt = cycles;
+        timing->fStatus = Running;
+        timing->fAwakeAt = cycles;
+        timing->fActivation++;
+        timing->fStatus = Finished;
+        timing->fFinishedAt = cycles;
+        cycles++;
+    }
+
+    worker->cycles = cycles;
+    return NULL;
+}
+
+static int straddling(layout_t* layout)
+{
+    int count = 0;
+    for (int i = 0; i < thread_count; i++) {
+        size_t start = (size_t)(layout->counters + i * layout->counter_size);
+        if (start / CACHE_LINE_SIZE != (start + sizeof(SInt32) - 1) / CACHE_LINE_SIZE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static double run(const char* name, layout_t* layout)
+{
+    pthread_t threads[CLIENT_NUM];
+    worker_t workers[CLIENT_NUM];
+    unsigned long long total = 0;
+    double start, elapsed;
+
+    layout->running = 1;
+    start = now();
+    for (int i = 0; i < thread_count; i++) {
+        workers[i].layout = layout;
+        workers[i].index = i;
+        workers[i].cycles = 0;
+        pthread_create(&threads[i], NULL, worker, &workers[i]);
+    }
+    usleep((useconds_t)(duration * 1e6));
+    layout->running = 0;
+    for (int i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+        total += workers[i].cycles;
+    }
+    elapsed = now() - start;
+
+    printf("%-10s counter %3zu bytes  timing %3zu bytes  %8.2f Mcycles/s  %8.2f ns/cycle per thread  split counters = %d\n", name,
+           layout->counter_size, layout->timing_size,
+           total / elapsed / 1e6, elapsed * 1e9 * thread_count / (total ? total : 1),
+           straddling(layout));
+    return total / elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+    layout_t packed, aligned;
+    char* memory;
+    int opt, option_index;
+    const char *options = "t:c:d:o:";
+    struct option long_options[] =
+    {
+        {"threads", 1, 0, 't'},
+        {"cpu", 1, 0, 'c'},
+        {"duration", 1, 0, 'd'},
+        {"offset", 1, 0, 'o'},
+        {0, 0, 0, 0}
+    };
+
+    while ((opt = getopt_long (argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 't':
+                thread_count = atoi(optarg);
+                break;
+            case 'c':
+                first_cpu = atoi(optarg);
+                break;
+            case 'd':
+                duration = atof(optarg);
+                break;
+            case 'o':
+                packed_offset = atoi(optarg) % CACHE_LINE_SIZE;
+                break;
+            default:
+                usage();
+                return 1;
+        }
+    }
+
+    if (thread_count <= 0) {
+        thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN) - first_cpu;
+    }
+    if (thread_count < 2 || thread_count > CLIENT_NUM) {
+        fprintf(stderr, "Thread count must be in 2-%d\n", CLIENT_NUM);
+        return 1;
+    }
+
+    size_t size = CLIENT_NUM * (sizeof(JackActivationCount) + sizeof(JackClientTiming)) + 2 * CACHE_LINE_SIZE;
+    if (posix_memalign((void**)&memory, CACHE_LINE_SIZE, 2 * size) != 0) {
+        fprintf(stderr, "Cannot allocate memory\n");
+        return 1;
+    }
+    memset(memory, 0, 2 * size);
+
+    packed.counters = memory + packed_offset;
+    packed.counter_size = PACKED_COUNTER_SIZE;
+    packed.timings = packed.counters + CLIENT_NUM * PACKED_COUNTER_SIZE;
+    packed.timing_size = PACKED_TIMING_SIZE;
+
+    aligned.counters = memory + size;
+    aligned.counter_size = sizeof(JackActivationCount);
+    aligned.timings = aligned.counters + CLIENT_NUM * sizeof(JackActivationCount);
+    aligned.timing_size = sizeof(JackClientTiming);
+
+    printf("threads = %d, first CPU = %d, duration = %.1f s, packed offset = %zu\n",
+           thread_count, first_cpu, duration, packed_offset);
+
+    double packed_rate = run("packed", &packed);
+    double aligned_rate = run("aligned", &aligned);
+    printf("aligned / packed = %.2f\n", aligned_rate / packed_rate);
+
+    free(memory);
+    return 0;
+}
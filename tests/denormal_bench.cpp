@@ -0,0 +1,186 @@
+/*
+    Copyright (C) 2026 agent
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file denormal_bench.cpp
+ *
+ * @brief Cost of denormals in a filter decaying to silence, with and
+ * without the flush-to-zero mode set on the RT threads.
+ *
+ * A bank of resonant two pole filters is fed with an impulse, then with
+ * silence: their state decays into the denormal range and stays there
+ * for a long time. The bank is processed in periods, as a process
+ * callback would, first with the IEEE behaviour, then with denormals
+ * flushed to zero as done with the flush-denormals server parameter or
+ * jack_client_set_flush_denormals(). The worst period is the one that
+ * matters for xruns.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <time.h>
+#include "JackDenormals.h"
+
+using namespace Jack;
+
+static int filter_count = 64;
+static int period_size = 256;
+static int period_count = 4000;
+
+typedef struct {
+    float b0, a1, a2;
+    float y1, y2;
+} filter_t;
+
+static void usage()
+{
+    fprintf (stderr, "\n"
+                    "usage: jack_denormal_bench \n"
+                    "              [ --filters OR -f filter_count ]\n"
+                    "              [ --period OR -p frames ]\n"
+                    "              [ --cycles OR -c period_count ]\n"
+    );
+}
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void init(filter_t* filters)
+{
+    for (int i = 0; i < filter_count; i++) {
+        // Poles close to the unit circle: long decay, in the denormal range after a few thousand frames
+        float r = 0.999f - 0.0001f * (i % 8);
+        float w = 0.05f + 0.01f * i;
+        filters[i].b0 = 1.0f;
+        filters[i].a1 = 2.0f * r * (1.0f - w * w / 2.0f);
+        filters[i].a2 = -r * r;
+        filters[i].y1 = 0.0f;
+        filters[i].y2 = 0.0f;
+    }
+}
+
+static void process(filter_t* filters, const float* in, float* out)
+{
+    for (int i = 0; i < filter_count; i++) {
+        filter_t* f = &filters[i];
+        for (int j = 0; j < period_size; j++) {
+            float y = f->b0 * in[j] + f->a1 * f->y1 + f->a2 * f->y2;
+            f->y2 = f->y1;
+            f->y1 = y;
+            out[j] += y;
+        }
+    }
+}
+
+static void run(const char* name, bool flush)
+{
+    if (!SetFlushDenormals(flush)) {
+        printf("%-8s not supported on this CPU\n", name);
+        return;
+    }
+
+    filter_t* filters = (filter_t*)calloc(filter_count, sizeof(filter_t));
+    float* in = (float*)calloc(period_size, sizeof(float));
+    float* out = (float*)calloc(period_size, sizeof(float));
+    double total = 0, worst = 0;
+    int denormals = 0;
+
+    if (filters == NULL || in == NULL || out == NULL) {
+        fprintf(stderr, "Cannot allocate memory\n");
+        free(filters);
+        free(in);
+        free(out);
+        return;
+    }
+
+    init(filters);
+    for (int i = 0; i < period_count; i++) {
+        in[0] = (i == 0) ? 1.0f : 0.0f;
+        for (int j = 0; j < period_size; j++) {
+            out[j] = 0.0f;
+        }
+        double start = now();
+        process(filters, in, out);
+        double elapsed = now() - start;
+        total += elapsed;
+        if (elapsed > worst) {
+            worst = elapsed;
+        }
+    }
+
+    for (int i = 0; i < filter_count; i++) {
+        float y = (filters[i].y1 < 0) ? -filters[i].y1 : filters[i].y1;
+        if (y != 0.0f && y < 1.17549435e-38f) {
+            denormals++;
+        }
+    }
+
+    printf("%-8s %8.2f ns/frame  mean period %8.2f us  worst period %8.2f us  denormal states = %d / %d\n", name,
+           total * 1e9 / (double(period_count) * period_size * filter_count),
+           total * 1e6 / period_count, worst * 1e6, denormals, filter_count);
+
+    free(filters);
+    free(in);
+    free(out);
+}
+
+int main(int argc, char *argv[])
+{
+    int opt, option_index;
+    const char *options = "f:p:c:";
+    struct option long_options[] =
+    {
+        {"filters", 1, 0, 'f'},
+        {"period", 1, 0, 'p'},
+        {"cycles", 1, 0, 'c'},
+        {0, 0, 0, 0}
+    };
+
+    while ((opt = getopt_long (argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'f':
+                filter_count = atoi(optarg);
+                break;
+            case 'p':
+                period_size = atoi(optarg);
+                break;
+            case 'c':
+                period_count = atoi(optarg);
+                break;
+            default:
+                usage();
+                return 1;
+        }
+    }
+
+    if (filter_count <= 0 || period_size <= 0 || period_count <= 0) {
+        usage();
+        return 1;
+    }
+
+    printf("filters = %d, period = %d frames, cycles = %d\n", filter_count, period_size, period_count);
+    run("ieee", false);
+    run("flush", true);
+    SetFlushDenormals(false);
+    return 0;
+}
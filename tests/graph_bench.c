@@ -0,0 +1,806 @@
+/*
+    Copyright (C) 2026 agent
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file graph_bench.c
+ *
+ * @brief Engine overhead against graph shape.
+ *
+ * For each period, a jackd server is started with the dummy driver and
+ * graphs of pass-through clients are built between the capture and
+ * playback ports:
+ *
+ *  - chain: capture -> 1 -> 2 -> ... -> N -> playback
+ *  - fan: capture -> N parallel clients -> playback
+ *  - diamond: layers of W clients, each client connected to all the
+ *    clients of the next layer
+ *
+ * Clients are external (threads of this process) or internal (the
+ * graph_bench_client module, which is not installed: JACK_INTERNAL_DIR has
+ * to point to the tests build directory). Timings are read with the cycle
+ * profiler:
+ *
+ *  - graph: from cycle begin to the end of the last client
+ *  - overhead: graph time not spent in process callbacks, a lower bound
+ *    when clients run in parallel
+ *  - wakeup: from the signal of a client to the wake up of its thread
+ *
+ * The maximum number of clients is then searched by adding clients
+ * until an xrun occurs or the graph does not end within the period.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <jack/jack.h>
+#include <jack/intclient.h>
+#include <jack/profiler.h>
+
+#define SERVER_NAME "jack_graph_bench"
+#define MAX_CLIENTS 256
+#define MAX_PORTS 64
+#define MAX_PERIODS 8
+
+enum { TOPOLOGY_CHAIN, TOPOLOGY_FAN, TOPOLOGY_DIAMOND, TOPOLOGY_COUNT };
+static const char* topology_names[TOPOLOGY_COUNT] = { "chain", "fan", "diamond" };
+
+enum { FORMAT_TEXT, FORMAT_CSV, FORMAT_JSON };
+
+typedef struct {
+    char name[32];
+    jack_client_t* client;          /* External client */
+    jack_intclient_t intclient;     /* Internal client */
+    jack_port_t* inputs[MAX_PORTS];
+    jack_port_t* outputs[MAX_PORTS];
+} bench_client_t;
+
+typedef struct {
+    const char* type;
+    const char* topology;
+    const char* kind;
+    jack_nframes_t period;
+    int clients;
+    unsigned long cycles;
+    unsigned long lost;
+    int xruns;
+    unsigned long late;
+    double graph_mean;
+    jack_time_t graph_p99;
+    jack_time_t graph_max;
+    double overhead_mean;
+    double overhead_per_client;
+    jack_time_t wakeup_p50;
+    jack_time_t wakeup_p99;
+    jack_time_t wakeup_p999;
+    jack_time_t wakeup_max;
+} result_t;
+
+typedef struct {
+    jack_time_t* values;
+    size_t count;
+    size_t size;
+} samples_t;
+
+static const char* jackd_path = "jackd";
+static jack_nframes_t sample_rate = 48000;
+static jack_nframes_t periods[MAX_PERIODS] = { 64, 128, 256 };
+static int period_count = 3;
+static int client_count = 8;
+static int port_count = 1;
+static int diamond_width = 4;
+static int topologies = (1 << TOPOLOGY_CHAIN) | (1 << TOPOLOGY_FAN) | (1 << TOPOLOGY_DIAMOND);
+static int internal = 0;
+static int external = 1;
+static int max_clients = 64;
+static int step = 4;
+static double duration = 2.;
+static unsigned long load_usecs = 0;
+static int sync_mode = 0;
+static int verbose = 0;
+static int format = FORMAT_TEXT;
+static int result_count = 0;
+
+static pid_t server_pid = 0;
+static jack_client_t* controller = NULL;
+static jack_profiler_t* profiler = NULL;
+static volatile int xruns = 0;
+static bench_client_t clients[MAX_CLIENTS];
+static int bench_clients = 0;
+
+static void usage()
+{
+    fprintf (stderr, "\n"
+                    "usage: jack_graph_bench \n"
+                    "              [ --jackd OR -j path_to_jackd ]\n"
+                    "              [ --rate OR -r sample_rate ]\n"
+                    "              [ --periods OR -p period[,period...] (in frames) ]\n"
+                    "              [ --topology OR -t chain|fan|diamond|all ]\n"
+                    "              [ --clients OR -c clients ]\n"
+                    "              [ --ports OR -m ports_per_client ]\n"
+                    "              [ --width OR -w diamond_layer_width ]\n"
+                    "              [ --kind OR -k external|internal|both ]\n"
+                    "              [ --max-clients OR -n limit (0 to skip the search) ]\n"
+                    "              [ --step OR -s clients_added_per_step ]\n"
+                    "              [ --duration OR -d seconds_per_measure ]\n"
+                    "              [ --load OR -l usecs_per_client ]\n"
+                    "              [ --sync OR -S ]\n"
+                    "              [ --format OR -f text|csv|json ]\n"
+                    "              [ --verbose OR -v ]\n"
+    );
+}
+
+static void silent_error(const char* msg)
+{}
+
+static void print_error(const char* msg)
+{
+    fprintf(stderr, "%s\n", msg);
+}
+
+static int xrun_callback(void* arg)
+{
+    xruns++;
+    return 0;
+}
+
+static int process(jack_nframes_t nframes, void* arg)
+{
+    bench_client_t* bench = (bench_client_t*)arg;
+    jack_time_t start = (load_usecs > 0) ? jack_get_time() : 0;
+    int i;
+
+    for (i = 0; i < port_count; i++) {
+        jack_default_audio_sample_t* in = jack_port_get_buffer(bench->inputs[i], nframes);
+        jack_default_audio_sample_t* out = jack_port_get_buffer(bench->outputs[i], nframes);
+        memcpy(out, in, sizeof(jack_default_audio_sample_t) * nframes);
+    }
+
+    while (load_usecs > 0 && jack_get_time() - start < load_usecs) {}
+    return 0;
+}
+
+/* Server */
+
+static void stop_server()
+{
+    if (profiler) {
+        jack_profiler_close(profiler);
+        profiler = NULL;
+    }
+    if (controller) {
+        jack_client_close(controller);
+        controller = NULL;
+    }
+    if (server_pid > 0) {
+        kill(server_pid, SIGTERM);
+        waitpid(server_pid, NULL, 0);
+        server_pid = 0;
+    }
+}
+
+static int start_server(jack_nframes_t period)
+{
+    char rate_arg[16], period_arg[16];
+    jack_status_t status;
+    const char* argv[16];
+    int argc = 0;
+    int i;
+
+    snprintf(rate_arg, sizeof(rate_arg), "%u", sample_rate);
+    snprintf(period_arg, sizeof(period_arg), "%u", period);
+    argv[argc++] = jackd_path;
+    argv[argc++] = "-n";
+    argv[argc++] = SERVER_NAME;
+    if (sync_mode) {
+        argv[argc++] = "-S";
+    }
+    argv[argc++] = "-d";
+    argv[argc++] = "dummy";
+    argv[argc++] = "-r";
+    argv[argc++] = rate_arg;
+    argv[argc++] = "-p";
+    argv[argc++] = period_arg;
+    argv[argc] = NULL;
+
+    server_pid = fork();
+    if (server_pid < 0) {
+        perror("fork");
+        return -1;
+    } else if (server_pid == 0) {
+        if (!verbose) {
+            int fd = open("/dev/null", O_WRONLY);
+            dup2(fd, 1);
+            dup2(fd, 2);
+        }
+        execvp(jackd_path, (char* const*)argv);
+        perror(jackd_path);
+        _exit(1);
+    }
+
+    /* Wait for the server to accept clients, failed attempts are expected */
+    jack_set_error_function(silent_error);
+    for (i = 0; i < 100 && controller == NULL; i++) {
+        usleep(100000);
+        if (waitpid(server_pid, NULL, WNOHANG) == server_pid) {
+            server_pid = 0;
+            break;
+        }
+        controller = jack_client_open("graph_bench", JackNoStartServer | JackServerName, &status, SERVER_NAME);
+    }
+    jack_set_error_function(print_error);
+    if (controller == NULL) {
+        fprintf(stderr, "Cannot start %s\n", jackd_path);
+        stop_server();
+        return -1;
+    }
+
+    /* Activated to receive xrun notifications, it is not part of the measured graph */
+    jack_set_xrun_callback(controller, xrun_callback, NULL);
+    if (jack_activate(controller) != 0) {
+        fprintf(stderr, "Cannot activate controller client\n");
+        stop_server();
+        return -1;
+    }
+
+    profiler = jack_profiler_open(controller);
+    if (profiler == NULL || jack_profiler_enable(profiler, 1) != 0) {
+        fprintf(stderr, "Cannot open the server cycle profiler\n");
+        stop_server();
+        return -1;
+    }
+    return 0;
+}
+
+/* Graph */
+
+static void close_clients()
+{
+    int i;
+
+    for (i = 0; i < bench_clients; i++) {
+        if (clients[i].client) {
+            jack_client_close(clients[i].client);
+        } else if (clients[i].intclient) {
+            jack_internal_client_unload(controller, clients[i].intclient);
+        }
+    }
+    memset(clients, 0, sizeof(clients));
+    bench_clients = 0;
+}
+
+static int open_client(bench_client_t* bench, int index, int is_internal)
+{
+    jack_status_t status;
+    char name[32];
+    int i;
+
+    snprintf(bench->name, sizeof(bench->name), "bench_%d", index);
+
+    if (is_internal) {
+        char init[32];
+        snprintf(init, sizeof(init), "%d %lu", port_count, load_usecs);
+        bench->intclient = jack_internal_client_load(controller, bench->name, JackLoadName | JackLoadInit, &status,
+                                                     "graph_bench_client", init);
+        if (bench->intclient == 0 || (status & JackFailure)) {
+            fprintf(stderr, "Cannot load internal client %s, status = 0x%2.0x\n", bench->name, status);
+            bench->intclient = 0;
+            return -1;
+        }
+        return 0;
+    }
+
+    bench->client = jack_client_open(bench->name, JackNoStartServer | JackServerName, &status, SERVER_NAME);
+    if (bench->client == NULL) {
+        fprintf(stderr, "Cannot open client %s, status = 0x%2.0x\n", bench->name, status);
+        return -1;
+    }
+    for (i = 0; i < port_count; i++) {
+        snprintf(name, sizeof(name), "in_%d", i + 1);
+        bench->inputs[i] = jack_port_register(bench->client, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+        snprintf(name, sizeof(name), "out_%d", i + 1);
+        bench->outputs[i] = jack_port_register(bench->client, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+        if (bench->inputs[i] == NULL || bench->outputs[i] == NULL) {
+            fprintf(stderr, "Cannot register ports of %s\n", bench->name);
+            return -1;
+        }
+    }
+    jack_set_process_callback(bench->client, process, bench);
+    if (jack_activate(bench->client) != 0) {
+        fprintf(stderr, "Cannot activate client %s\n", bench->name);
+        return -1;
+    }
+    return 0;
+}
+
+static int connect_ports(const char* src, int src_port, const char* dst, int dst_port)
+{
+    char src_name[64], dst_name[64];
+    snprintf(src_name, sizeof(src_name), "%s:out_%d", src, src_port + 1);
+    snprintf(dst_name, sizeof(dst_name), "%s:in_%d", dst, dst_port + 1);
+    if (jack_connect(controller, src_name, dst_name) != 0) {
+        fprintf(stderr, "Cannot connect %s to %s\n", src_name, dst_name);
+        return -1;
+    }
+    return 0;
+}
+
+/* Connects the capture ports to the inputs of a client, or its outputs to the playback ports */
+static int connect_system(const char** system_ports, const char* name, int input)
+{
+    char port_name[64];
+    int count = 0, i, res;
+
+    while (system_ports && system_ports[count]) {
+        count++;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    for (i = 0; i < port_count; i++) {
+        snprintf(port_name, sizeof(port_name), "%s:%s_%d", name, (input) ? "in" : "out", i + 1);
+        res = (input) ? jack_connect(controller, system_ports[i % count], port_name)
+                      : jack_connect(controller, port_name, system_ports[i % count]);
+        if (res != 0) {
+            fprintf(stderr, "Cannot connect %s\n", port_name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int build_graph(int topology, int count, int is_internal)
+{
+    const char** capture = jack_get_ports(controller, "system:", NULL, JackPortIsPhysical | JackPortIsOutput);
+    const char** playback = jack_get_ports(controller, "system:", NULL, JackPortIsPhysical | JackPortIsInput);
+    int width = (topology == TOPOLOGY_CHAIN) ? 1 : (topology == TOPOLOGY_FAN) ? count : diamond_width;
+    int res = -1;
+    int i, j, p;
+
+    for (i = 0; i < count; i++) {
+        if (open_client(&clients[i], i, is_internal) < 0) {
+            goto end;
+        }
+        bench_clients++;
+    }
+
+    /* Clients are laid out in layers of the given width, each connected to all the clients of the next layer */
+    for (i = 0; i < count; i++) {
+        int layer = i / width;
+        if (layer == 0 && connect_system(capture, clients[i].name, 1) < 0) {
+            goto end;
+        }
+        if ((layer + 1) * width >= count && connect_system(playback, clients[i].name, 0) < 0) {
+            goto end;
+        }
+        for (j = (layer + 1) * width; j < (layer + 2) * width && j < count; j++) {
+            for (p = 0; p < port_count; p++) {
+                if (connect_ports(clients[i].name, p, clients[j].name, p) < 0) {
+                    goto end;
+                }
+            }
+        }
+    }
+    res = 0;
+
+end:
+    jack_free(capture);
+    jack_free(playback);
+    return res;
+}
+
+/* Measure */
+
+static void samples_add(samples_t* samples, jack_time_t value)
+{
+    if (samples->count == samples->size) {
+        samples->size = (samples->size == 0) ? 4096 : samples->size * 2;
+        samples->values = (jack_time_t*)realloc(samples->values, samples->size * sizeof(jack_time_t));
+    }
+    samples->values[samples->count++] = value;
+}
+
+static int compare_samples(const void* a, const void* b)
+{
+    jack_time_t v1 = *(const jack_time_t*)a;
+    jack_time_t v2 = *(const jack_time_t*)b;
+    return (v1 > v2) - (v1 < v2);
+}
+
+static jack_time_t samples_percentile(samples_t* samples, int per_thousand)
+{
+    size_t rank;
+    if (samples->count == 0) {
+        return 0;
+    }
+    rank = (samples->count * per_thousand + 999) / 1000;
+    return samples->values[(rank > 0) ? rank - 1 : 0];
+}
+
+static void measure(result_t* result)
+{
+    jack_profiler_cycle_t cycle;
+    samples_t graph = { NULL, 0, 0 };
+    samples_t wakeup = { NULL, 0, 0 };
+    signed char is_bench[MAX_CLIENTS];
+    double overhead_total = 0.;
+    jack_time_t graph_total = 0;
+    jack_time_t end_date;
+    char name[64];
+    int i;
+
+    /* Let the graph settle, then skip the cycles already profiled */
+    usleep(200000);
+    while (jack_profiler_read(profiler, &cycle) > 0) {}
+    memset(is_bench, -1, sizeof(is_bench));
+    xruns = 0;
+
+    end_date = jack_get_time() + (jack_time_t)(duration * 1000000.);
+    while (jack_get_time() < end_date) {
+        jack_time_t cycle_end = 0, process_sum = 0, graph_time;
+        int found = 0, finished = 0;
+        int res = jack_profiler_read(profiler, &cycle);
+
+        if (res < 0) {
+            break;
+        } else if (res == 0) {
+            usleep(10000);
+            continue;
+        }
+
+        result->lost += cycle.lost;
+        for (i = 0; i < (int)cycle.client_count; i++) {
+            const jack_profiler_client_t* client = &cycle.clients[i];
+            if (client->refnum < 0 || client->refnum >= MAX_CLIENTS) {
+                continue;
+            }
+            if (is_bench[client->refnum] < 0) {
+                is_bench[client->refnum] = (jack_profiler_client_name(profiler, client->refnum, name, sizeof(name)) == 0
+                                            && strncmp(name, "bench_", 6) == 0);
+            }
+            if (!is_bench[client->refnum]) {
+                continue;
+            }
+            found++;
+            if (client->status == JackProfilerFinished && client->finished_at >= client->awake_at) {
+                finished++;
+                process_sum += client->finished_at - client->awake_at;
+                if (client->finished_at > cycle_end) {
+                    cycle_end = client->finished_at;
+                }
+                if (client->signaled_at > 0 && client->awake_at >= client->signaled_at) {
+                    samples_add(&wakeup, client->awake_at - client->signaled_at);
+                }
+            }
+        }
+
+        /* Cycles during which clients were added or removed are skipped */
+        if (found != result->clients) {
+            continue;
+        }
+        result->cycles++;
+        if (finished < found) {
+            result->late++;
+            continue;
+        }
+        graph_time = (cycle_end > cycle.cycle_begin) ? cycle_end - cycle.cycle_begin : 0;
+        if (graph_time > cycle.period_usecs) {
+            result->late++;
+        }
+        samples_add(&graph, graph_time);
+        graph_total += graph_time;
+        overhead_total += (graph_time > process_sum) ? graph_time - process_sum : 0;
+    }
+
+    result->xruns = xruns;
+    if (graph.count > 0) {
+        qsort(graph.values, graph.count, sizeof(jack_time_t), compare_samples);
+        result->graph_mean = (double)graph_total / graph.count;
+        result->graph_p99 = samples_percentile(&graph, 990);
+        result->graph_max = graph.values[graph.count - 1];
+        result->overhead_mean = overhead_total / graph.count;
+        result->overhead_per_client = result->overhead_mean / result->clients;
+    }
+    if (wakeup.count > 0) {
+        qsort(wakeup.values, wakeup.count, sizeof(jack_time_t), compare_samples);
+        result->wakeup_p50 = samples_percentile(&wakeup, 500);
+        result->wakeup_p99 = samples_percentile(&wakeup, 990);
+        result->wakeup_p999 = samples_percentile(&wakeup, 999);
+        result->wakeup_max = wakeup.values[wakeup.count - 1];
+    }
+    free(graph.values);
+    free(wakeup.values);
+}
+
+static int run(result_t* result, int topology, int count, int is_internal, jack_nframes_t period)
+{
+    memset(result, 0, sizeof(result_t));
+    result->type = "measure";
+    result->topology = topology_names[topology];
+    result->kind = (is_internal) ? "internal" : "external";
+    result->period = period;
+    result->clients = count;
+
+    if (build_graph(topology, count, is_internal) < 0) {
+        close_clients();
+        return -1;
+    }
+    measure(result);
+    close_clients();
+    return 0;
+}
+
+/* Output */
+
+static void print_header()
+{
+    switch (format) {
+        case FORMAT_CSV:
+            printf("type,topology,kind,rate,period,clients,ports,cycles,lost,xruns,late,"
+                   "graph_mean_us,graph_p99_us,graph_max_us,overhead_mean_us,overhead_per_client_us,"
+                   "wakeup_p50_us,wakeup_p99_us,wakeup_p999_us,wakeup_max_us\n");
+            break;
+        case FORMAT_JSON:
+            printf("{\n  \"rate\": %u,\n  \"ports\": %d,\n  \"load_usecs\": %lu,\n  \"results\": [", sample_rate, port_count, load_usecs);
+            break;
+        default:
+            printf("rate = %u, ports per client = %d, load = %lu us, %.1f s per measure\n",
+                   sample_rate, port_count, load_usecs, duration);
+            printf("%-8s %-8s %-8s %6s %7s %7s %5s %5s %9s %8s %9s %9s %7s %7s %7s %7s\n",
+                   "type", "topology", "kind", "period", "clients", "cycles", "xruns", "late",
+                   "graph", "p99", "overhead", "/client", "wk p50", "wk p99", "wk p999", "wk max");
+            break;
+    }
+}
+
+static void print_result(const result_t* r)
+{
+    switch (format) {
+        case FORMAT_CSV:
+            printf("%s,%s,%s,%u,%u,%d,%d,%lu,%lu,%d,%lu,%.1f,%lu,%lu,%.1f,%.2f,%lu,%lu,%lu,%lu\n",
+                   r->type, r->topology, r->kind, sample_rate, r->period, r->clients, port_count,
+                   r->cycles, r->lost, r->xruns, r->late,
+                   r->graph_mean, (unsigned long)r->graph_p99, (unsigned long)r->graph_max,
+                   r->overhead_mean, r->overhead_per_client,
+                   (unsigned long)r->wakeup_p50, (unsigned long)r->wakeup_p99,
+                   (unsigned long)r->wakeup_p999, (unsigned long)r->wakeup_max);
+            break;
+        case FORMAT_JSON:
+            printf("%s\n    {\"type\": \"%s\", \"topology\": \"%s\", \"kind\": \"%s\", \"period\": %u, \"clients\": %d, "
+                   "\"cycles\": %lu, \"lost\": %lu, \"xruns\": %d, \"late\": %lu, "
+                   "\"graph_mean_us\": %.1f, \"graph_p99_us\": %lu, \"graph_max_us\": %lu, "
+                   "\"overhead_mean_us\": %.1f, \"overhead_per_client_us\": %.2f, "
+                   "\"wakeup_p50_us\": %lu, \"wakeup_p99_us\": %lu, \"wakeup_p999_us\": %lu, \"wakeup_max_us\": %lu}",
+                   (result_count > 0) ? "," : "",
+                   r->type, r->topology, r->kind, r->period, r->clients,
+                   r->cycles, r->lost, r->xruns, r->late,
+                   r->graph_mean, (unsigned long)r->graph_p99, (unsigned long)r->graph_max,
+                   r->overhead_mean, r->overhead_per_client,
+                   (unsigned long)r->wakeup_p50, (unsigned long)r->wakeup_p99,
+                   (unsigned long)r->wakeup_p999, (unsigned long)r->wakeup_max);
+            break;
+        default:
+            printf("%-8s %-8s %-8s %6u %7d %7lu %5d %5lu %9.1f %8lu %9.1f %9.2f %7lu %7lu %7lu %7lu\n",
+                   r->type, r->topology, r->kind, r->period, r->clients, r->cycles, r->xruns, r->late,
+                   r->graph_mean, (unsigned long)r->graph_p99, r->overhead_mean, r->overhead_per_client,
+                   (unsigned long)r->wakeup_p50, (unsigned long)r->wakeup_p99,
+                   (unsigned long)r->wakeup_p999, (unsigned long)r->wakeup_max);
+            break;
+    }
+    result_count++;
+    fflush(stdout);
+}
+
+static void print_footer()
+{
+    if (format == FORMAT_JSON) {
+        printf("\n  ]\n}\n");
+    }
+}
+
+static void bench(int topology, int is_internal, jack_nframes_t period)
+{
+    result_t result, best;
+    int count;
+
+    if (run(&result, topology, client_count, is_internal, period) == 0) {
+        print_result(&result);
+    }
+
+    if (max_clients <= 0) {
+        return;
+    }
+
+    /* Largest client count without xrun and with all cycles ending within the period */
+    memset(&best, 0, sizeof(result_t));
+    for (count = step; count <= max_clients; count += step) {
+        if (run(&result, topology, count, is_internal, period) < 0
+            || result.xruns > 0 || result.late > 0 || result.cycles == 0) {
+            break;
+        }
+        best = result;
+    }
+    best.type = "max";
+    best.topology = topology_names[topology];
+    best.kind = (is_internal) ? "internal" : "external";
+    best.period = period;
+    print_result(&best);
+}
+
+static int parse_periods(const char* arg)
+{
+    char* end;
+    period_count = 0;
+    while (*arg && period_count < MAX_PERIODS) {
+        unsigned long period = strtoul(arg, &end, 10);
+        if (end == arg || period == 0) {
+            return -1;
+        }
+        periods[period_count++] = period;
+        arg = (*end == ',') ? end + 1 : end;
+    }
+    return (period_count > 0) ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    int opt, option_index;
+    int topology, p;
+    const char *options = "j:r:p:t:c:m:w:k:n:s:d:l:Sf:v";
+    struct option long_options[] =
+    {
+        {"jackd", 1, 0, 'j'},
+        {"rate", 1, 0, 'r'},
+        {"periods", 1, 0, 'p'},
+        {"topology", 1, 0, 't'},
+        {"clients", 1, 0, 'c'},
+        {"ports", 1, 0, 'm'},
+        {"width", 1, 0, 'w'},
+        {"kind", 1, 0, 'k'},
+        {"max-clients", 1, 0, 'n'},
+        {"step", 1, 0, 's'},
+        {"duration", 1, 0, 'd'},
+        {"load", 1, 0, 'l'},
+        {"sync", 0, 0, 'S'},
+        {"format", 1, 0, 'f'},
+        {"verbose", 0, 0, 'v'},
+        {0, 0, 0, 0}
+    };
+
+    while ((opt = getopt_long (argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'j':
+                jackd_path = optarg;
+                break;
+            case 'r':
+                sample_rate = atoi(optarg);
+                break;
+            case 'p':
+                if (parse_periods(optarg) < 0) {
+                    fprintf(stderr, "Invalid period list %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 't':
+                if (strcmp(optarg, "all") == 0) {
+                    topologies = (1 << TOPOLOGY_COUNT) - 1;
+                } else {
+                    topologies = 0;
+                    for (topology = 0; topology < TOPOLOGY_COUNT; topology++) {
+                        if (strcmp(optarg, topology_names[topology]) == 0) {
+                            topologies = 1 << topology;
+                        }
+                    }
+                    if (topologies == 0) {
+                        fprintf(stderr, "Unknown topology %s\n", optarg);
+                        return 1;
+                    }
+                }
+                break;
+            case 'c':
+                client_count = atoi(optarg);
+                break;
+            case 'm':
+                port_count = atoi(optarg);
+                break;
+            case 'w':
+                diamond_width = atoi(optarg);
+                break;
+            case 'k':
+                external = (strcmp(optarg, "external") == 0 || strcmp(optarg, "both") == 0);
+                internal = (strcmp(optarg, "internal") == 0 || strcmp(optarg, "both") == 0);
+                if (!external && !internal) {
+                    fprintf(stderr, "Unknown client kind %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'n':
+                max_clients = atoi(optarg);
+                break;
+            case 's':
+                step = atoi(optarg);
+                break;
+            case 'd':
+                duration = atof(optarg);
+                break;
+            case 'l':
+                load_usecs = strtoul(optarg, NULL, 10);
+                break;
+            case 'S':
+                sync_mode = 1;
+                break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) {
+                    format = FORMAT_CSV;
+                } else if (strcmp(optarg, "json") == 0) {
+                    format = FORMAT_JSON;
+                } else {
+                    format = FORMAT_TEXT;
+                }
+                break;
+            case 'v':
+                verbose = 1;
+                break;
+            default:
+                usage();
+                return 1;
+        }
+    }
+
+    if (client_count < 1 || client_count > MAX_CLIENTS || max_clients > MAX_CLIENTS) {
+        fprintf(stderr, "Client count must be in 1-%d\n", MAX_CLIENTS);
+        return 1;
+    }
+    if (port_count < 1 || port_count > MAX_PORTS) {
+        fprintf(stderr, "Port count must be in 1-%d\n", MAX_PORTS);
+        return 1;
+    }
+    if (diamond_width < 1 || step < 1) {
+        fprintf(stderr, "Width and step must be positive\n");
+        return 1;
+    }
+
+    /* The server is not left running on a broken pipe */
+    signal(SIGPIPE, SIG_IGN);
+
+    print_header();
+    for (p = 0; p < period_count; p++) {
+        if (start_server(periods[p]) < 0) {
+            return 1;
+        }
+        for (topology = 0; topology < TOPOLOGY_COUNT; topology++) {
+            if (!(topologies & (1 << topology))) {
+                continue;
+            }
+            if (external) {
+                bench(topology, 0, periods[p]);
+            }
+            if (internal) {
+                bench(topology, 1, periods[p]);
+            }
+        }
+        stop_server();
+    }
+    print_footer();
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+    Copyright (C) 2026 agent
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file graph_bench_client.c
+ *
+ * @brief Internal client used by jack_graph_bench.
+ *
+ * Registers in_1..in_M and out_1..out_M, copies each input to the
+ * matching output and optionally busy-waits to simulate a load. The
+ * load init string is "<ports> <load in usecs>". Connections are made
+ * by the benchmark.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <jack/jack.h>
+
+#define MAX_PORTS 64
+
+typedef struct {
+    jack_client_t* client;
+    int ports;
+    jack_time_t load;
+    jack_port_t* inputs[MAX_PORTS];
+    jack_port_t* outputs[MAX_PORTS];
+} bench_client_t;
+
+static int process(jack_nframes_t nframes, void* arg)
+{
+    bench_client_t* bench = (bench_client_t*)arg;
+    jack_time_t start = (bench->load > 0) ? jack_get_time() : 0;
+    int i;
+
+    for (i = 0; i < bench->ports; i++) {
+        jack_default_audio_sample_t* in = jack_port_get_buffer(bench->inputs[i], nframes);
+        jack_default_audio_sample_t* out = jack_port_get_buffer(bench->outputs[i], nframes);
+        memcpy(out, in, sizeof(jack_default_audio_sample_t) * nframes);
+    }
+
+    while (bench->load > 0 && jack_get_time() - start < bench->load) {}
+    return 0;
+}
+
+int jack_initialize(jack_client_t* client, const char* load_init)
+{
+    bench_client_t* bench = calloc(1, sizeof(bench_client_t));
+    unsigned long load = 0;
+    char name[32];
+    int i;
+
+    if (bench == NULL) {
+        return 1;
+    }
+
+    bench->client = client;
+    bench->ports = 1;
+    if (load_init) {
+        sscanf(load_init, "%d %lu", &bench->ports, &load);
+    }
+    if (bench->ports < 1 || bench->ports > MAX_PORTS) {
+        fprintf(stderr, "graph_bench_client: ports must be in 1-%d\n", MAX_PORTS);
+        free(bench);
+        return 1;
+    }
+    bench->load = load;
+
+    for (i = 0; i < bench->ports; i++) {
+        snprintf(name, sizeof(name), "in_%d", i + 1);
+        bench->inputs[i] = jack_port_register(client, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+        snprintf(name, sizeof(name), "out_%d", i + 1);
+        bench->outputs[i] = jack_port_register(client, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+        if (bench->inputs[i] == NULL || bench->outputs[i] == NULL) {
+            fprintf(stderr, "graph_bench_client: cannot register ports\n");
+            free(bench);
+            return 1;
+        }
+    }
+
+    jack_set_process_callback(client, process, bench);
+    return jack_activate(client);
+}
+
+void jack_finish(void* arg)
+{
+    free(arg);
+}
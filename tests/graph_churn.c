@@ -0,0 +1,522 @@
+/*
+    Copyright (C) 2026 agent
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file graph_churn.c
+ *
+ * @brief Real-time impact of graph edits.
+ *
+ * A reference client measures each cycle, first on a quiet graph, then
+ * while a churn client connects and disconnects its ports to the
+ * reference client and registers and unregisters ports at the given
+ * rates. For each phase it reports:
+ *
+ *  - period jitter: distance between two process callbacks minus the
+ *    period
+ *  - offset: from the cycle begin to the process callback of the
+ *    reference client
+ *  - xruns, and the graph state counters of the server: switches,
+ *    cycles "waiting to switch" because the previous cycle was not
+ *    finished, and switches forced after the time out
+ *
+ * The tool connects to a running server. Connections and registrations
+ * are done by two clients, each used by a single thread. The exit status
+ * is 2 when the churn phase had xruns or forced switches.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <jack/jack.h>
+#include <jack/statistics.h>
+
+#define MAX_PORTS 256
+
+enum { FORMAT_TEXT, FORMAT_JSON };
+
+typedef struct {
+    jack_time_t* values;
+    size_t count;
+    size_t size;
+} samples_t;
+
+typedef struct {
+    unsigned long count;
+    unsigned long failures;
+    double total;
+    jack_time_t max;
+} operations_t;
+
+typedef struct {
+    const char* name;
+    samples_t jitter;
+    samples_t offset;
+    int xruns;
+    jack_graph_stats_t graph;
+    operations_t connects;
+    operations_t registers;
+} phase_t;
+
+typedef struct {
+    jack_time_t p50;
+    jack_time_t p99;
+    jack_time_t max;
+} distribution_t;
+
+static const char* server_name = NULL;
+static double connect_rate = 100.;
+static double register_rate = 10.;
+static int port_count = 16;
+static double duration = 10.;
+static double baseline = 5.;
+static int format = FORMAT_TEXT;
+
+static jack_client_t* reference = NULL;
+static jack_port_t* reference_in = NULL;
+static jack_port_t* reference_out = NULL;
+static jack_client_t* churn = NULL;
+static jack_client_t* churn_ports = NULL;
+static jack_port_t* churn_in[MAX_PORTS];
+static jack_port_t* churn_out[MAX_PORTS];
+static int churn_in_connected[MAX_PORTS];
+static int churn_out_connected[MAX_PORTS];
+
+static phase_t phases[2];
+static phase_t* volatile current = NULL;
+static jack_time_t last_callback = 0;
+static jack_time_t phase_end = 0;
+static volatile int running = 1;
+
+static void usage()
+{
+    fprintf (stderr, "\n"
+                    "usage: jack_graph_churn \n"
+                    "              [ --server OR -s server_name ]\n"
+                    "              [ --connect-rate OR -c connections_per_second ]\n"
+                    "              [ --register-rate OR -r registrations_per_second ]\n"
+                    "              [ --ports OR -p churn_ports ]\n"
+                    "              [ --duration OR -d churn_seconds ]\n"
+                    "              [ --baseline OR -b quiet_seconds ]\n"
+                    "              [ --format OR -f text|json ]\n"
+    );
+}
+
+static void signal_handler(int sig)
+{
+    running = 0;
+}
+
+static int samples_init(samples_t* samples, size_t size)
+{
+    samples->values = (jack_time_t*)malloc(size * sizeof(jack_time_t));
+    samples->count = 0;
+    samples->size = size;
+    return (samples->values) ? 0 : -1;
+}
+
+// RT, the arrays are allocated for the whole phase
+static void samples_add(samples_t* samples, jack_time_t value)
+{
+    if (samples->count < samples->size) {
+        samples->values[samples->count++] = value;
+    }
+}
+
+static int compare_time(const void* a, const void* b)
+{
+    jack_time_t x = *(const jack_time_t*)a;
+    jack_time_t y = *(const jack_time_t*)b;
+    return (x > y) - (x < y);
+}
+
+static distribution_t samples_distribution(samples_t* samples)
+{
+    distribution_t res = { 0, 0, 0 };
+    if (samples->count > 0) {
+        qsort(samples->values, samples->count, sizeof(jack_time_t), compare_time);
+        res.p50 = samples->values[samples->count / 2];
+        res.p99 = samples->values[(samples->count * 99) / 100];
+        res.max = samples->values[samples->count - 1];
+    }
+    return res;
+}
+
+static int process(jack_nframes_t nframes, void* arg)
+{
+    jack_time_t now = jack_get_time();
+    phase_t* phase = current;
+    jack_nframes_t frames;
+    jack_time_t cycle_usecs, next_usecs;
+    float period_usecs;
+
+    memcpy(jack_port_get_buffer(reference_out, nframes),
+           jack_port_get_buffer(reference_in, nframes),
+           sizeof(jack_default_audio_sample_t) * nframes);
+
+    if (jack_get_cycle_times(reference, &frames, &cycle_usecs, &next_usecs, &period_usecs) != 0) {
+        return 0;
+    }
+
+    if (phase && last_callback > 0) {
+        jack_time_t delta = now - last_callback;
+        jack_time_t period = (jack_time_t)(period_usecs);
+        samples_add(&phase->jitter, (delta > period) ? delta - period : period - delta);
+        samples_add(&phase->offset, (now > cycle_usecs) ? now - cycle_usecs : 0);
+    }
+
+    last_callback = now;
+    return 0;
+}
+
+static int churn_process(jack_nframes_t nframes, void* arg)
+{
+    return 0;
+}
+
+static int xrun_callback(void* arg)
+{
+    phase_t* phase = current;
+    if (phase) {
+        phase->xruns++;
+    }
+    return 0;
+}
+
+static void shutdown_callback(void* arg)
+{
+    fprintf(stderr, "server has been shut down\n");
+    running = 0;
+}
+
+static void add_operation(operations_t* operations, jack_time_t start, int res)
+{
+    jack_time_t duration = jack_get_time() - start;
+    operations->count++;
+    if (res != 0) {
+        operations->failures++;
+    }
+    operations->total += duration;
+    if (duration > operations->max) {
+        operations->max = duration;
+    }
+}
+
+// Sleep until the date of the next operation, returns 0 when the phase is over
+static int wait_next(jack_time_t* next, double rate, jack_time_t end)
+{
+    jack_time_t now;
+    *next += (jack_time_t)(1000000. / rate);
+    now = jack_get_time();
+    if (!running || *next >= end) {
+        return 0;
+    }
+    if (*next > now) {
+        usleep(*next - now);
+    }
+    return 1;
+}
+
+static void* connect_thread(void* arg)
+{
+    phase_t* phase = (phase_t*)arg;
+    const char* ref_in = jack_port_name(reference_in);
+    const char* ref_out = jack_port_name(reference_out);
+    jack_time_t next = jack_get_time();
+
+    // The state is kept here since the graph seen by jack_port_connected_to only changes at the next cycle
+    do {
+        int i = rand() % port_count;
+        int upstream = rand() & 1;
+        int* connected = (upstream) ? &churn_out_connected[i] : &churn_in_connected[i];
+        const char* src = (upstream) ? jack_port_name(churn_out[i]) : ref_out;
+        const char* dst = (upstream) ? ref_in : jack_port_name(churn_in[i]);
+        jack_time_t start = jack_get_time();
+        int res = (*connected) ? jack_disconnect(churn, src, dst) : jack_connect(churn, src, dst);
+        if (res == 0) {
+            *connected = !*connected;
+        }
+        add_operation(&phase->connects, start, res);
+    } while (wait_next(&next, connect_rate, phase_end));
+
+    return NULL;
+}
+
+static void* register_thread(void* arg)
+{
+    phase_t* phase = (phase_t*)arg;
+    jack_port_t* ports[MAX_PORTS];
+    jack_time_t next = jack_get_time();
+    unsigned long serial = 0;
+    int count = 0;
+    int i;
+
+    do {
+        jack_time_t start = jack_get_time();
+        int res = 0;
+        if (count == port_count) {
+            res = jack_port_unregister(churn_ports, ports[0]);
+            memmove(&ports[0], &ports[1], sizeof(jack_port_t*) * --count);
+        } else {
+            char name[32];
+            snprintf(name, sizeof(name), "tmp_%lu", serial++);
+            ports[count] = jack_port_register(churn_ports, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+            if (ports[count]) {
+                count++;
+            } else {
+                res = -1;
+            }
+        }
+        add_operation(&phase->registers, start, res);
+    } while (wait_next(&next, register_rate, phase_end));
+
+    for (i = 0; i < count; i++) {
+        jack_port_unregister(churn_ports, ports[i]);
+    }
+    return NULL;
+}
+
+static int run_phase(phase_t* phase, double seconds, int edit)
+{
+    jack_nframes_t rate = jack_get_sample_rate(reference);
+    jack_nframes_t period = jack_get_buffer_size(reference);
+    size_t cycles = (size_t)(seconds * rate / period) + 16;
+    jack_graph_stats_t before, after;
+    pthread_t threads[2];
+    int thread_count = 0;
+
+    if (samples_init(&phase->jitter, cycles) < 0 || samples_init(&phase->offset, cycles) < 0) {
+        fprintf(stderr, "cannot allocate samples\n");
+        return -1;
+    }
+
+    jack_get_graph_stats(reference, &before);
+    phase_end = jack_get_time() + (jack_time_t)(seconds * 1000000.);
+    last_callback = 0;
+    current = phase;
+
+    if (edit) {
+        if (connect_rate > 0 && pthread_create(&threads[thread_count], NULL, connect_thread, phase) == 0) {
+            thread_count++;
+        }
+        if (register_rate > 0 && pthread_create(&threads[thread_count], NULL, register_thread, phase) == 0) {
+            thread_count++;
+        }
+    }
+
+    while (running && jack_get_time() < phase_end) {
+        usleep(10000);
+    }
+    while (thread_count > 0) {
+        pthread_join(threads[--thread_count], NULL);
+    }
+
+    current = NULL;
+    jack_get_graph_stats(reference, &after);
+    phase->graph.switches = after.switches - before.switches;
+    phase->graph.waits = after.waits - before.waits;
+    phase->graph.forced_switches = after.forced_switches - before.forced_switches;
+    return 0;
+}
+
+static void print_operations(const char* name, operations_t* operations, double seconds, int last)
+{
+    double mean = (operations->count > 0) ? operations->total / operations->count : 0.;
+
+    if (format == FORMAT_JSON) {
+        printf("\"%s\": %lu, \"%s_failed\": %lu, \"%s_mean_us\": %.1f, \"%s_max_us\": %llu%s",
+               name, operations->count, name, operations->failures, name, mean,
+               name, (unsigned long long)operations->max, (last) ? "" : ", ");
+    } else if (operations->count > 0) {
+        printf("  %lu %s (%.1f/s), %lu failed, mean %.1f us, max %llu us\n",
+               operations->count, name, operations->count / seconds, operations->failures,
+               mean, (unsigned long long)operations->max);
+    }
+}
+
+static void print_phase(phase_t* phase, double seconds, int last)
+{
+    distribution_t jitter = samples_distribution(&phase->jitter);
+    distribution_t offset = samples_distribution(&phase->offset);
+
+    if (format == FORMAT_JSON) {
+        printf("    { \"phase\": \"%s\", \"seconds\": %.1f, \"cycles\": %lu, \"xruns\": %d, "
+               "\"graph_switches\": %u, \"graph_waits\": %u, \"graph_forced_switches\": %u, "
+               "\"jitter_p50_us\": %llu, \"jitter_p99_us\": %llu, \"jitter_max_us\": %llu, "
+               "\"offset_p50_us\": %llu, \"offset_p99_us\": %llu, \"offset_max_us\": %llu, ",
+               phase->name, seconds, (unsigned long)phase->jitter.count, phase->xruns,
+               phase->graph.switches, phase->graph.waits, phase->graph.forced_switches,
+               (unsigned long long)jitter.p50, (unsigned long long)jitter.p99, (unsigned long long)jitter.max,
+               (unsigned long long)offset.p50, (unsigned long long)offset.p99, (unsigned long long)offset.max);
+        print_operations("connections", &phase->connects, seconds, 0);
+        print_operations("registrations", &phase->registers, seconds, 1);
+        printf(" }%s\n", (last) ? "" : ",");
+    } else {
+        printf("%s (%.1f s, %lu cycles)\n", phase->name, seconds, (unsigned long)phase->jitter.count);
+        printf("  xruns %d, graph switches %u, waiting to switch %u, forced switches %u\n",
+               phase->xruns, phase->graph.switches, phase->graph.waits, phase->graph.forced_switches);
+        printf("  period jitter p50 %llu us, p99 %llu us, max %llu us\n",
+               (unsigned long long)jitter.p50, (unsigned long long)jitter.p99, (unsigned long long)jitter.max);
+        printf("  cycle offset p50 %llu us, p99 %llu us, max %llu us\n",
+               (unsigned long long)offset.p50, (unsigned long long)offset.p99, (unsigned long long)offset.max);
+        print_operations("connections", &phase->connects, seconds, 0);
+        print_operations("registrations", &phase->registers, seconds, 1);
+    }
+}
+
+static int open_clients()
+{
+    jack_options_t options = (server_name) ? JackServerName : JackNullOption;
+    char name[32];
+    int i;
+
+    if ((reference = jack_client_open("churn_ref", options, NULL, server_name)) == NULL) {
+        fprintf(stderr, "jack server not running?\n");
+        return -1;
+    }
+    if ((churn = jack_client_open("churn", options, NULL, server_name)) == NULL
+        || (churn_ports = jack_client_open("churn_ports", options, NULL, server_name)) == NULL) {
+        fprintf(stderr, "cannot open the churn clients\n");
+        return -1;
+    }
+
+    reference_in = jack_port_register(reference, "in", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+    reference_out = jack_port_register(reference, "out", JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+    for (i = 0; i < port_count; i++) {
+        snprintf(name, sizeof(name), "in_%d", i + 1);
+        churn_in[i] = jack_port_register(churn, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+        snprintf(name, sizeof(name), "out_%d", i + 1);
+        churn_out[i] = jack_port_register(churn, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+        if (churn_in[i] == NULL || churn_out[i] == NULL) {
+            fprintf(stderr, "cannot register ports\n");
+            return -1;
+        }
+    }
+    if (reference_in == NULL || reference_out == NULL) {
+        fprintf(stderr, "cannot register ports\n");
+        return -1;
+    }
+
+    jack_set_process_callback(reference, process, NULL);
+    jack_set_xrun_callback(reference, xrun_callback, NULL);
+    jack_on_shutdown(reference, shutdown_callback, NULL);
+    jack_set_process_callback(churn, churn_process, NULL);
+    jack_set_process_callback(churn_ports, churn_process, NULL);
+
+    if (jack_activate(reference) != 0 || jack_activate(churn) != 0 || jack_activate(churn_ports) != 0) {
+        fprintf(stderr, "cannot activate clients\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* options = "s:c:r:p:d:b:f:h";
+    struct option long_options[] =
+    {
+        {"server", 1, 0, 's'},
+        {"connect-rate", 1, 0, 'c'},
+        {"register-rate", 1, 0, 'r'},
+        {"ports", 1, 0, 'p'},
+        {"duration", 1, 0, 'd'},
+        {"baseline", 1, 0, 'b'},
+        {"format", 1, 0, 'f'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int option_index = 0;
+    int opt;
+
+    while ((opt = getopt_long (argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 's':
+                server_name = optarg;
+                break;
+            case 'c':
+                connect_rate = atof(optarg);
+                break;
+            case 'r':
+                register_rate = atof(optarg);
+                break;
+            case 'p':
+                port_count = atoi(optarg);
+                break;
+            case 'd':
+                duration = atof(optarg);
+                break;
+            case 'b':
+                baseline = atof(optarg);
+                break;
+            case 'f':
+                if (strcmp(optarg, "text") == 0) {
+                    format = FORMAT_TEXT;
+                } else if (strcmp(optarg, "json") == 0) {
+                    format = FORMAT_JSON;
+                } else {
+                    usage();
+                    return 1;
+                }
+                break;
+            default:
+                usage();
+                return 1;
+        }
+    }
+
+    if (port_count < 1 || port_count > MAX_PORTS || duration <= 0 || baseline < 0) {
+        usage();
+        return 1;
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    if (open_clients() < 0) {
+        return 1;
+    }
+
+    phases[0].name = "quiet";
+    phases[1].name = "churn";
+    if ((baseline > 0 && run_phase(&phases[0], baseline, 0) < 0) || run_phase(&phases[1], duration, 1) < 0) {
+        return 1;
+    }
+
+    if (format == FORMAT_JSON) {
+        printf("{ \"sample_rate\": %u, \"period\": %u, \"connect_rate\": %.1f, \"register_rate\": %.1f, \"ports\": %d, \"phases\": [\n",
+               jack_get_sample_rate(reference), jack_get_buffer_size(reference), connect_rate, register_rate, port_count);
+    } else {
+        printf("sample rate %u, period %u frames, %.1f connections/s, %.1f registrations/s, %d ports\n",
+               jack_get_sample_rate(reference), jack_get_buffer_size(reference), connect_rate, register_rate, port_count);
+    }
+    if (baseline > 0) {
+        print_phase(&phases[0], baseline, 0);
+    }
+    print_phase(&phases[1], duration, 1);
+    if (format == FORMAT_JSON) {
+        printf("] }\n");
+    }
+
+    jack_client_close(churn_ports);
+    jack_client_close(churn);
+    jack_client_close(reference);
+    return (phases[1].xruns > 0 || phases[1].graph.forced_switches > 0) ? 2 : 0;
+}
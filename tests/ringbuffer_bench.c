@@ -0,0 +1,324 @@
+/*
+    Copyright (C) 2026 agent
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file ringbuffer_bench.c
+ *
+ * @brief Contention benchmark of jack_ringbuffer_t against jack_ringbuffer2_t.
+ *
+ * A writer thread and a reader thread, pinned on two different CPUs when
+ * possible, exchange the same amount of data through each ringbuffer:
+ * first as raw bytes with small chunks (worst case for index sharing),
+ * then as interleaved stereo audio frames, using the frame API of
+ * jack_ringbuffer2_t and a manual interleave for jack_ringbuffer_t.
+ * The received data is checked.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <jack/ringbuffer.h>
+#include <jack/ringbuffer2.h>
+
+#define FRAMES 256
+#define CHANNELS 2
+
+static size_t rb_size = 16384;
+static size_t chunk_size = 64;
+static size_t total_size = 256 * 1024 * 1024;
+static int cpus[2] = { 0, 1 };
+static int bench_flags = 0;
+
+typedef struct {
+    jack_ringbuffer_t* rb1;
+    jack_ringbuffer2_t* rb2;
+    int frames;
+    int errors;
+} bench_t;
+
+static void usage()
+{
+    fprintf (stderr, "\n"
+                    "usage: jack_ringbuffer_bench \n"
+                    "              [ --size OR -s ringbuffer_size (in bytes) ]\n"
+                    "              [ --chunk OR -c chunk_size (in bytes) ]\n"
+                    "              [ --total OR -t total_size (in MB) ]\n"
+                    "              [ --writer-cpu OR -w cpu ]\n"
+                    "              [ --reader-cpu OR -r cpu ]\n"
+                    "              [ --mlock OR -m ]\n"
+                    "              [ --huge-pages OR -H ]\n"
+    );
+}
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Yield when the other side has to make progress, so that the benchmark
+   also completes when both threads share a CPU */
+static size_t progress(size_t count)
+{
+    if (count == 0) {
+        sched_yield();
+    }
+    return count;
+}
+
+static void pin(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        fprintf(stderr, "Cannot pin thread on CPU %d\n", cpu);
+    }
+#endif
+}
+
+static void* writer(void* arg)
+{
+    bench_t* bench = (bench_t*)arg;
+    unsigned char chunk[4096];
+    jack_default_audio_sample_t in[CHANNELS][FRAMES];
+    jack_default_audio_sample_t interleaved[FRAMES * CHANNELS];
+    const jack_default_audio_sample_t* channels[CHANNELS] = { in[0], in[1] };
+    size_t done = 0;
+    unsigned int counter = 0;
+    int i, c;
+
+    pin(cpus[0]);
+
+    while (done < total_size) {
+        if (bench->frames) {
+            size_t frame_bytes = FRAMES * CHANNELS * sizeof(jack_default_audio_sample_t);
+            for (i = 0; i < FRAMES; i++) {
+                for (c = 0; c < CHANNELS; c++) {
+                    in[c][i] = (jack_default_audio_sample_t)(counter++ & 0xffff);
+                }
+            }
+            if (bench->rb2) {
+                jack_nframes_t written = 0;
+                while (written < FRAMES) {
+                    const jack_default_audio_sample_t* offset[CHANNELS] = { channels[0] + written, channels[1] + written };
+                    written += progress(jack_ringbuffer2_write_frames(bench->rb2, offset, CHANNELS, FRAMES - written));
+                }
+            } else {
+                size_t written = 0;
+                for (i = 0; i < FRAMES; i++) {
+                    for (c = 0; c < CHANNELS; c++) {
+                        interleaved[i * CHANNELS + c] = in[c][i];
+                    }
+                }
+                while (written < frame_bytes) {
+                    written += progress(jack_ringbuffer_write(bench->rb1, (char*)interleaved + written, frame_bytes - written));
+                }
+            }
+            done += frame_bytes;
+        } else {
+            size_t written = 0;
+            for (i = 0; i < (int)chunk_size; i++) {
+                chunk[i] = (unsigned char)(counter++);
+            }
+            while (written < chunk_size) {
+                if (bench->rb2) {
+                    written += progress(jack_ringbuffer2_write(bench->rb2, (char*)chunk + written, chunk_size - written));
+                } else {
+                    written += progress(jack_ringbuffer_write(bench->rb1, (char*)chunk + written, chunk_size - written));
+                }
+            }
+            done += chunk_size;
+        }
+    }
+    return NULL;
+}
+
+static void* reader(void* arg)
+{
+    bench_t* bench = (bench_t*)arg;
+    unsigned char chunk[4096];
+    jack_default_audio_sample_t out[CHANNELS][FRAMES];
+    jack_default_audio_sample_t interleaved[FRAMES * CHANNELS];
+    jack_default_audio_sample_t* channels[CHANNELS] = { out[0], out[1] };
+    size_t done = 0;
+    unsigned int counter = 0;
+    int i, c;
+
+    pin(cpus[1]);
+
+    while (done < total_size) {
+        if (bench->frames) {
+            size_t frame_bytes = FRAMES * CHANNELS * sizeof(jack_default_audio_sample_t);
+            if (bench->rb2) {
+                jack_nframes_t read = 0;
+                while (read < FRAMES) {
+                    jack_default_audio_sample_t* offset[CHANNELS] = { channels[0] + read, channels[1] + read };
+                    read += progress(jack_ringbuffer2_read_frames(bench->rb2, offset, CHANNELS, FRAMES - read));
+                }
+            } else {
+                size_t read = 0;
+                while (read < frame_bytes) {
+                    read += progress(jack_ringbuffer_read(bench->rb1, (char*)interleaved + read, frame_bytes - read));
+                }
+                for (i = 0; i < FRAMES; i++) {
+                    for (c = 0; c < CHANNELS; c++) {
+                        out[c][i] = interleaved[i * CHANNELS + c];
+                    }
+                }
+            }
+            for (i = 0; i < FRAMES; i++) {
+                for (c = 0; c < CHANNELS; c++) {
+                    if (out[c][i] != (jack_default_audio_sample_t)(counter++ & 0xffff)) {
+                        bench->errors++;
+                    }
+                }
+            }
+            done += frame_bytes;
+        } else {
+            size_t read = 0;
+            while (read < chunk_size) {
+                if (bench->rb2) {
+                    read += progress(jack_ringbuffer2_read(bench->rb2, (char*)chunk + read, chunk_size - read));
+                } else {
+                    read += progress(jack_ringbuffer_read(bench->rb1, (char*)chunk + read, chunk_size - read));
+                }
+            }
+            for (i = 0; i < (int)chunk_size; i++) {
+                if (chunk[i] != (unsigned char)(counter++)) {
+                    bench->errors++;
+                }
+            }
+            done += chunk_size;
+        }
+    }
+    return NULL;
+}
+
+static void run(const char* name, bench_t* bench)
+{
+    pthread_t writer_thread, reader_thread;
+    double start, duration;
+
+    start = now();
+    pthread_create(&reader_thread, NULL, reader, bench);
+    pthread_create(&writer_thread, NULL, writer, bench);
+    pthread_join(writer_thread, NULL);
+    pthread_join(reader_thread, NULL);
+    duration = now() - start;
+
+    printf("%-30s %8.1f MB/s  %8.2f ns/%s  errors = %d\n", name,
+           total_size / duration / (1024 * 1024),
+           duration * 1e9 / (total_size / (bench->frames ? FRAMES * CHANNELS * sizeof(jack_default_audio_sample_t) : chunk_size)),
+           bench->frames ? "period" : "chunk",
+           bench->errors);
+}
+
+int main(int argc, char *argv[])
+{
+    bench_t bench;
+    int opt, option_index;
+    const char *options = "s:c:t:w:r:mH";
+    struct option long_options[] =
+    {
+        {"size", 1, 0, 's'},
+        {"chunk", 1, 0, 'c'},
+        {"total", 1, 0, 't'},
+        {"writer-cpu", 1, 0, 'w'},
+        {"reader-cpu", 1, 0, 'r'},
+        {"mlock", 0, 0, 'm'},
+        {"huge-pages", 0, 0, 'H'},
+        {0, 0, 0, 0}
+    };
+
+    while ((opt = getopt_long (argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 's':
+                rb_size = atoi(optarg);
+                break;
+            case 'c':
+                chunk_size = atoi(optarg);
+                if (chunk_size == 0 || chunk_size > 4096) {
+                    fprintf(stderr, "Chunk size must be in 1-4096\n");
+                    return 1;
+                }
+                break;
+            case 't':
+                total_size = (size_t)atoi(optarg) * 1024 * 1024;
+                break;
+            case 'w':
+                cpus[0] = atoi(optarg);
+                break;
+            case 'r':
+                cpus[1] = atoi(optarg);
+                break;
+            case 'm':
+                bench_flags |= JackRingbuffer2Mlock;
+                break;
+            case 'H':
+                bench_flags |= JackRingbuffer2HugePages;
+                break;
+            default:
+                usage();
+                return 1;
+        }
+    }
+
+    printf("ringbuffer size = %zu, chunk size = %zu, total = %zu MB, writer CPU = %d, reader CPU = %d\n",
+           rb_size, chunk_size, total_size / (1024 * 1024), cpus[0], cpus[1]);
+
+    memset(&bench, 0, sizeof(bench));
+    bench.rb1 = jack_ringbuffer_create(rb_size);
+    run("jack_ringbuffer bytes", &bench);
+    jack_ringbuffer_free(bench.rb1);
+
+    memset(&bench, 0, sizeof(bench));
+    bench.rb2 = jack_ringbuffer2_create(rb_size, bench_flags);
+    if (bench.rb2 == NULL) {
+        fprintf(stderr, "Cannot create ringbuffer\n");
+        return 1;
+    }
+    if (jack_ringbuffer2_flags(bench.rb2) != bench_flags) {
+        fprintf(stderr, "Requested flags %x, got %x\n", bench_flags, jack_ringbuffer2_flags(bench.rb2));
+    }
+    run("jack_ringbuffer2 bytes", &bench);
+    jack_ringbuffer2_free(bench.rb2);
+
+    memset(&bench, 0, sizeof(bench));
+    bench.frames = 1;
+    bench.rb1 = jack_ringbuffer_create(rb_size);
+    run("jack_ringbuffer frames", &bench);
+    jack_ringbuffer_free(bench.rb1);
+
+    memset(&bench, 0, sizeof(bench));
+    bench.frames = 1;
+    bench.rb2 = jack_ringbuffer2_create(rb_size, bench_flags);
+    run("jack_ringbuffer2 frames", &bench);
+    jack_ringbuffer2_free(bench.rb2);
+
+    return 0;
+}
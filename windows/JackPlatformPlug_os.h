@@ -50,6 +50,7 @@ namespace Jack
 /* __JackPlatformMutex__ */
 #include "JackWinMutex.h"
 namespace Jack {typedef JackWinMutex JackMutex; }
+namespace Jack {typedef JackWinRWLock JackRWLock; }
 
 /* __JackPlatformThread__ */
 #include "JackWinThread.h"
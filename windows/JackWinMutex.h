@@ -119,6 +119,25 @@ class SERVER_EXPORT JackWinCriticalSection
 
 };
 
+/*!
+\brief Reader/writer lock abstraction, readers are serialized as well.
+*/
+
+class SERVER_EXPORT JackWinRWLock : public JackWinCriticalSection
+{
+
+    public:
+
+        JackWinRWLock(const char* name = NULL):JackWinCriticalSection(name)
+        {}
+
+        bool ReadLock() { return Lock(); }
+        bool ReadUnlock() { return Unlock(); }
+        bool WriteLock() { return Lock(); }
+        bool WriteUnlock() { return Unlock(); }
+
+};
+
 
 } // namespace
 
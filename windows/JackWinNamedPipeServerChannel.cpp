@@ -102,6 +102,9 @@ bool JackClientPipeThread::Execute()
             ret = false;
         }
 
+        // Each client thread blocks on its own pipe, there is no common wake up to deliver a batch later
+        fServer->GetEngine()->FlushNotifications();
+
         // Unlock the global mutex
         if (!ReleaseMutex(fMutex)) {
             jack_error("JackClientPipeThread::Execute : mutex release error");
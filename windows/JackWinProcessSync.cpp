@@ -125,7 +125,10 @@ bool JackWinProcessSync::TimedWait(long usec)
   	if (ReleaseMutex(fMutex)) {
         HANDLE handles[] = { fMutex, fEvent };
         res = WaitForMultipleObjects(2, handles, true, usec / 1000);
-        if ((res != WAIT_OBJECT_0) && (res != WAIT_TIMEOUT)) {
+        if (res == WAIT_TIMEOUT) {
+            // Own the mutex again, as after a timed out pthread_cond_timedwait
+            WaitForSingleObject(fMutex, INFINITE);
+        } else if (res != WAIT_OBJECT_0) {
             jack_error("JackWinProcessSync::TimedWait WaitForMultipleObjects err = %d", GetLastError());
         }
     // In case TimedWait is called in a "non-locked" context
@@ -239,6 +239,76 @@ int JackWinThread::DropRealTimeImp(jack_native_thread_t thread)
     }
 }
 
+int JackWinThread::SetAffinity(const int* cpus, int count)
+{
+    return (fThread != (HANDLE)NULL) ? SetAffinityImp(fThread, cpus, count) : -1;
+}
+
+int JackWinThread::SetSelfAffinity(const int* cpus, int count)
+{
+    return SetAffinityImp(GetCurrentThread(), cpus, count);
+}
+
+/*
+An empty CPU list gives the thread the affinity of the process again.
+*/
+int JackWinThread::SetAffinityImp(jack_native_thread_t thread, const int* cpus, int count)
+{
+    DWORD_PTR mask = 0, system_mask;
+    if (count == 0 && !GetProcessAffinityMask(GetCurrentProcess(), &mask, &system_mask)) {
+        jack_error("Cannot get process affinity = %d", GetLastError());
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] < 0 || cpus[i] >= int(sizeof(DWORD_PTR) * 8)) {
+            jack_error("Cannot set thread affinity to CPU %d", cpus[i]);
+            return -1;
+        }
+        mask |= DWORD_PTR(1) << cpus[i];
+    }
+
+    if (SetThreadAffinityMask(thread, mask) == 0) {
+        jack_error("Cannot set thread affinity = %d", GetLastError());
+        return -1;
+    }
+    return 0;
+}
+
+int JackWinThread::ExcludeSelfAffinityImp(const int* cpus, int count)
+{
+    DWORD_PTR process_mask, system_mask;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        jack_error("Cannot get process affinity = %d", GetLastError());
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] >= 0 && cpus[i] < int(sizeof(DWORD_PTR) * 8)) {
+            process_mask &= ~(DWORD_PTR(1) << cpus[i]);
+        }
+    }
+    if (process_mask == 0) {
+        jack_log("JackWinThread::ExcludeSelfAffinityImp no CPU left, affinity unchanged");
+        return 0;
+    }
+
+    if (SetThreadAffinityMask(GetCurrentThread(), process_mask) == 0) {
+        jack_error("Cannot set thread affinity = %d", GetLastError());
+        return -1;
+    }
+    return 0;
+}
+
+int JackWinThread::AcquireSelfDeadline(UInt64 runtime, UInt64 period)
+{
+    return AcquireSelfDeadlineImp(runtime, period, period);
+}
+
+int JackWinThread::AcquireSelfDeadlineImp(UInt64 runtime, UInt64 deadline, UInt64 period)
+{
+    jack_log("JackWinThread::AcquireSelfDeadlineImp not supported on this platform");
+    return -1;
+}
+
 jack_native_thread_t JackWinThread::GetThreadID()
 {
     return fThread;
@@ -268,7 +338,8 @@ bool jack_get_thread_realtime_priority_range(int * min_ptr, int * max_ptr)
     return false;
 }
 
-bool jack_tls_allocate_key(jack_tls_key *key_ptr)
+// TLS slots have no destructor: the value of an exiting thread is simply dropped
+bool jack_tls_allocate_key(jack_tls_key *key_ptr, void (*destructor)(void*))
 {
     DWORD key;
 
@@ -65,6 +65,11 @@ class SERVER_EXPORT JackWinThread : public JackMMCSS, public detail::JackThreadI
         int DropRealTime();                     // Used when called from another thread
         int DropSelfRealTime();                 // Used when called from thread itself
 
+        int SetAffinity(const int* cpus, int count);        // Used when called from another thread, no CPU for the process affinity
+        int SetSelfAffinity(const int* cpus, int count);    // Used when called from thread itself, no CPU for the process affinity
+
+        int AcquireSelfDeadline(UInt64 runtime, UInt64 period);    // Used when called from thread itself
+
         jack_native_thread_t GetThreadID();
         bool IsThread();
 
@@ -74,6 +79,9 @@ class SERVER_EXPORT JackWinThread : public JackMMCSS, public detail::JackThreadI
             return JackWinThread::AcquireRealTimeImp(thread, priority);
         }
         static int DropRealTimeImp(jack_native_thread_t thread);
+        static int SetAffinityImp(jack_native_thread_t thread, const int* cpus, int count);
+        static int ExcludeSelfAffinityImp(const int* cpus, int count);
+        static int AcquireSelfDeadlineImp(UInt64 runtime, UInt64 deadline, UInt64 period);
         static int StartImp(jack_native_thread_t* thread, int priority, int realtime, void*(*start_routine)(void*), void* arg)
         {
             return JackWinThread::StartImp(thread, priority, realtime, (ThreadCallback) start_routine, arg);
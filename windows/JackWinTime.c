@@ -22,6 +22,8 @@
 
 static LARGE_INTEGER _jack_freq;
 static UINT gPeriod = 0;
+static volatile jack_time_t* _jack_virtual_clock = NULL;
+static int _jack_virtual = 0;
 
 SERVER_EXPORT void JackSleep(long usec)
 {
@@ -56,14 +58,44 @@ SERVER_EXPORT void EndTime()
 SERVER_EXPORT jack_time_t GetMicroSeconds(void)
 {
 	LARGE_INTEGER t1;
+	if (_jack_virtual) {
+		return *_jack_virtual_clock;
+	}
 	QueryPerformanceCounter(&t1);
 	return (jack_time_t)(((double)t1.QuadPart) / ((double)_jack_freq.QuadPart) * 1000000.0);
 }
 
+SERVER_EXPORT jack_time_t GetThreadCPUNanoSeconds(void)
+{
+    FILETIME creation, exit, kernel, user;
+    ULARGE_INTEGER kernel_time, user_time;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    kernel_time.LowPart = kernel.dwLowDateTime;
+    kernel_time.HighPart = kernel.dwHighDateTime;
+    user_time.LowPart = user.dwLowDateTime;
+    user_time.HighPart = user.dwHighDateTime;
+    // FILETIME unit is 100 nanoseconds
+    return (jack_time_t)(kernel_time.QuadPart + user_time.QuadPart) * 100;
+}
+
 void SetClockSource(jack_timer_type_t source)
-{}
+{
+    _jack_virtual = (source == JACK_TIMER_VIRTUAL && _jack_virtual_clock);
+}
+
+SERVER_EXPORT void SetVirtualClock(volatile jack_time_t* clock)
+{
+    _jack_virtual_clock = clock;
+}
+
+SERVER_EXPORT int IsVirtualClock(void)
+{
+    return _jack_virtual;
+}
 
 const char* ClockSourceName(jack_timer_type_t source)
 {
-    return "";
+    return (source == JACK_TIMER_VIRTUAL) ? "virtual" : "";
 }